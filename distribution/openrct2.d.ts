@@ -1687,6 +1687,7 @@ declare global {
         "preferLessIntenseRides" |
         "preferMoreIntenseRides" |
         "scenarioCompleteNameInput" |
+        "sharedGuestRoutes" |
         "unlockAllPrices";
 
     interface Park {
@@ -34,6 +34,7 @@
 #include "core/FileStream.h"
 #include "core/Guard.hpp"
 #include "core/Http.h"
+#include "core/JobPool.h"
 #include "core/MemoryStream.h"
 #include "core/Path.hpp"
 #include "core/String.hpp"
@@ -367,6 +368,8 @@ namespace OpenRCT2
 
             crash_init();
 
+            JobPool::SetWorkerCountOverride(std::max(gConfigGeneral.multithreading_workers, 0));
+
             if (gConfigGeneral.last_run_version != nullptr && String::Equals(gConfigGeneral.last_run_version, OPENRCT2_VERSION))
             {
                 gOpenRCT2ShowChangelog = false;
@@ -673,6 +673,9 @@ void game_autosave()
         timeName, sizeof(timeName), "autosave_%04u-%02u-%02u_%02u-%02u-%02u%s", currentDate.year, currentDate.month,
         currentDate.day, currentTime.hour, currentTime.minute, currentTime.second, fileExtension);
 
+    // The previous autosave may still be written in the background.
+    scenario_save_async_wait();
+
     int32_t autosavesToKeep = gConfigGeneral.autosave_amount;
     limit_autosave_count(autosavesToKeep - 1, (gScreenFlags & SCREEN_FLAGS_EDITOR));
 
@@ -692,7 +695,12 @@ void game_autosave()
         platform_file_copy(path, backupPath, true);
     }
 
-    if (!scenario_save(path, saveFlags))
+    // Only the serialisation happens on the game thread, compressing and writing the file is done in the background.
+    auto onWritten = [](bool result) {
+        if (!result)
+            Console::Error::WriteLine("Could not autosave the scenario. Is the save folder writeable?");
+    };
+    if (!scenario_save_async(path, saveFlags, onWritten))
         Console::Error::WriteLine("Could not autosave the scenario. Is the save folder writeable?");
 }
 
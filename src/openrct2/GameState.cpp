@@ -15,10 +15,12 @@
 #include "GameState.h"
 #include "GameStateSnapshots.h"
 #include "Input.h"
+#include "LogicPhaseGraph.h"
 #include "OpenRCT2.h"
 #include "ReplayManager.h"
 #include "actions/GameAction.h"
 #include "config/Config.h"
+#include "core/JobPool.h"
 #include "entity/EntityRegistry.h"
 #include "entity/Staff.h"
 #include "interface/Screenshot.h"
@@ -48,6 +50,72 @@ using namespace OpenRCT2::Scripting;
 GameState::GameState()
 {
     _park = std::make_unique<Park>();
+    CreateLogicPhases();
+}
+
+GameState::~GameState() = default;
+
+/**
+ * Declares the phases of a logic tick in their serial order along with the state they touch.
+ * Phases that have not been audited for their dependencies claim the whole game state, which
+ * keeps them ordered against everything else.
+ */
+void GameState::CreateLogicPhases()
+{
+    using R = LogicResource;
+
+    _logicPhases = std::make_unique<LogicPhaseGraph>();
+    auto addSerial = [this](LogicTimePart part, std::function<void()> fn) {
+        _logicPhases->Add({ part, LogicResourcesAll, LogicResourcesAll, 0, false, std::move(fn) });
+    };
+
+    addSerial(LogicTimePart::Date, [this]() {
+        date_update();
+        _date = Date(static_cast<uint32_t>(gDateMonthsElapsed), gDateMonthTicks);
+    });
+    addSerial(LogicTimePart::Scenario, scenario_update);
+    addSerial(LogicTimePart::Climate, climate_update);
+    addSerial(LogicTimePart::MapTiles, map_update_tiles);
+    // Temporarily remove provisional paths to prevent peep from interacting with them
+    addSerial(LogicTimePart::MapStashProvisionalElements, map_remove_provisional_elements);
+    addSerial(LogicTimePart::MapPathWideFlags, map_update_path_wide_flags);
+    addSerial(LogicTimePart::Peep, peep_update_all);
+    addSerial(LogicTimePart::MapRestoreProvisionalElements, map_restore_provisional_elements);
+    addSerial(LogicTimePart::Vehicle, vehicle_update_all);
+    addSerial(LogicTimePart::Misc, UpdateAllMiscEntities);
+    addSerial(LogicTimePart::Ride, Ride::UpdateAll);
+    addSerial(LogicTimePart::Park, [this]() {
+        if (!(gScreenFlags & SCREEN_FLAGS_EDITOR))
+        {
+            _park->Update(_date);
+        }
+    });
+    // Research defers its news, windows and the game action that stops funding once everything is invented.
+    _logicPhases->Add({ LogicTimePart::Research, EnumsToFlags(R::Date, R::Park, R::Objects, R::Research),
+                        EnumToFlag(R::Research), EnumsToFlags(R::Research, R::News, R::Windows, R::GameActions, R::Network),
+                        true, research_update });
+    // The ratings, value and upkeep of each ride belong to the ratings. Plugins hooking the calculation and the
+    // ride window are deferred, a hook is only expected to change the ratings it is given.
+    _logicPhases->Add({ LogicTimePart::RideRatings, EnumsToFlags(R::Date, R::TileElements, R::Rides, R::Objects),
+                        EnumToFlag(R::RideRatings), EnumsToFlags(R::RideRatings, R::Windows), true,
+                        ride_ratings_update_all });
+    _logicPhases->Add({ LogicTimePart::RideMeasurments, EnumsToFlags(R::Date, R::Rides, R::Entities, R::TileElements),
+                        EnumToFlag(R::RideMeasurements), 0, true, ride_measurements_update });
+    _logicPhases->Add({ LogicTimePart::News, EnumsToFlags(R::Date, R::News), EnumsToFlags(R::News, R::Windows, R::Audio), 0,
+                        false, News::UpdateCurrentItem });
+    // Door and on-ride photo frames kept in tile elements belong to the animations. Clock animations make guests
+    // check the time, which is deferred. Invalidating tiles only reads the viewports, which only the UI moves.
+    _logicPhases->Add({ LogicTimePart::MapAnimation,
+                        EnumsToFlags(R::Date, R::TileElements, R::Entities, R::Rides, R::Objects),
+                        EnumToFlag(R::MapAnimations), EnumToFlag(R::Entities), true, map_animation_invalidate_all });
+    _logicPhases->Add({ LogicTimePart::Sounds, EnumsToFlags(R::Entities, R::Climate, R::Rides, R::Windows),
+                        EnumToFlag(R::Audio), 0, false, []() {
+                            vehicle_sounds_update();
+                            peep_update_crowd_noise();
+                            climate_update_sound();
+                        } });
+
+    _logicPhases->Build();
 }
 
 /**
@@ -270,6 +338,7 @@ void GameState::UpdateLogic(LogicTimings* timings)
         if (network_gamestate_snapshots_enabled())
         {
             CreateStateSnapshot();
+            RecordStateHistory();
         }
 
         // Send current tick out.
@@ -283,6 +352,12 @@ void GameState::UpdateLogic(LogicTimings* timings)
             return;
         }
 
+        // Keep the same tick history as the server so a desync can be bisected.
+        if (network_gamestate_snapshots_enabled())
+        {
+            RecordStateHistory();
+        }
+
         // Check desync.
         bool desynced = network_check_desynchronisation();
         if (desynced)
@@ -305,53 +380,19 @@ void GameState::UpdateLogic(LogicTimings* timings)
     auto day = _date.GetDay();
 #endif
 
-    date_update();
-    _date = Date(static_cast<uint32_t>(gDateMonthsElapsed), gDateMonthTicks);
-    report_time(LogicTimePart::Date);
-
-    scenario_update();
-    report_time(LogicTimePart::Scenario);
-    climate_update();
-    report_time(LogicTimePart::Climate);
-    map_update_tiles();
-    report_time(LogicTimePart::MapTiles);
-    // Temporarily remove provisional paths to prevent peep from interacting with them
-    map_remove_provisional_elements();
-    report_time(LogicTimePart::MapStashProvisionalElements);
-    map_update_path_wide_flags();
-    report_time(LogicTimePart::MapPathWideFlags);
-    peep_update_all();
-    report_time(LogicTimePart::Peep);
-    map_restore_provisional_elements();
-    report_time(LogicTimePart::MapRestoreProvisionalElements);
-    vehicle_update_all();
-    report_time(LogicTimePart::Vehicle);
-    UpdateAllMiscEntities();
-    report_time(LogicTimePart::Misc);
-    Ride::UpdateAll();
-    report_time(LogicTimePart::Ride);
-
-    if (!(gScreenFlags & SCREEN_FLAGS_EDITOR))
+    if (gConfigGeneral.multithreading)
     {
-        _park->Update(_date);
+        if (_logicJobs == nullptr)
+        {
+            _logicJobs = std::make_unique<JobPool>();
+        }
+        _logicPhases->RunParallel(*_logicJobs, report_time);
+    }
+    else
+    {
+        _logicJobs.reset();
+        _logicPhases->RunSerial(report_time);
     }
-    report_time(LogicTimePart::Park);
-
-    research_update();
-    report_time(LogicTimePart::Research);
-    ride_ratings_update_all();
-    report_time(LogicTimePart::RideRatings);
-    ride_measurements_update();
-    report_time(LogicTimePart::RideMeasurments);
-    News::UpdateCurrentItem();
-    report_time(LogicTimePart::News);
-
-    map_animation_invalidate_all();
-    report_time(LogicTimePart::MapAnimation);
-    vehicle_sounds_update();
-    peep_update_crowd_noise();
-    climate_update_sound();
-    report_time(LogicTimePart::Sounds);
     editor_open_windows_for_current_step();
 
     // Update windows
@@ -398,3 +439,9 @@ void GameState::CreateStateSnapshot()
     snapshots->Capture(snapshot);
     snapshots->LinkSnapshot(snapshot, gCurrentTicks, scenario_rand_state().s0);
 }
+
+void GameState::RecordStateHistory()
+{
+    IGameStateSnapshots* snapshots = GetContext()->GetGameStateSnapshots();
+    snapshots->RecordHistory(gCurrentTicks, scenario_rand_state().s0);
+}
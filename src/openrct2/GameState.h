@@ -16,8 +16,11 @@
 #include <memory>
 #include <unordered_map>
 
+class JobPool;
+
 namespace OpenRCT2
 {
+    class LogicPhaseGraph;
     class Park;
 
     // Information regarding various pieces of logic update
@@ -68,10 +71,13 @@ namespace OpenRCT2
     private:
         std::unique_ptr<Park> _park;
         Date _date;
+        std::unique_ptr<LogicPhaseGraph> _logicPhases;
+        std::unique_ptr<JobPool> _logicJobs;
 
     public:
         GameState();
         GameState(const GameState&) = delete;
+        ~GameState();
 
         Date& GetDate()
         {
@@ -88,5 +94,7 @@ namespace OpenRCT2
 
     private:
         void CreateStateSnapshot();
+        void RecordStateHistory();
+        void CreateLogicPhases();
     };
 } // namespace OpenRCT2
@@ -0,0 +1,198 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "GameStateHistory.h"
+
+#include "core/DataSerialiser.h"
+#include "core/MemoryStream.h"
+
+#include <exception>
+
+// Entity index that terminates a delta, every real index is below MAX_ENTITIES.
+static constexpr uint16_t HistoryDeltaEnd = MAX_ENTITIES;
+static constexpr uint16_t HistoryPatchEnd = 0xFFFF;
+
+// Differing bytes closer together than this are sent as a single run.
+static constexpr size_t HistoryPatchGap = 4;
+
+enum class HistoryDeltaKind : uint8_t
+{
+    Removed,
+    Replaced,
+    Patched,
+};
+
+uint64_t GameStateEntities_t::Hash(size_t index) const
+{
+    const auto size = GetSize(index);
+    if (size == 0)
+        return 0;
+
+    // FNV-1a, seeded with the index so that two entities swapping slots still changes the digest.
+    uint64_t hash = 0xCBF29CE484222325ULL ^ index;
+    const auto* data = Get(index);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ data[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+static void WritePatch(DataSerialiser& ds, const uint8_t* from, const uint8_t* to, size_t size)
+{
+    size_t pos = 0;
+    while (pos < size)
+    {
+        if (from[pos] == to[pos])
+        {
+            pos++;
+            continue;
+        }
+
+        size_t end = pos + 1;
+        size_t lastDiff = pos;
+        while (end < size && end - lastDiff <= HistoryPatchGap)
+        {
+            if (from[end] != to[end])
+                lastDiff = end;
+            end++;
+        }
+
+        uint16_t offset = static_cast<uint16_t>(pos);
+        uint16_t length = static_cast<uint16_t>(lastDiff + 1 - pos);
+        ds << offset;
+        ds << length;
+        ds.GetStream().Write(to + pos, length);
+        pos = lastDiff + 1;
+    }
+    uint16_t patchEnd = HistoryPatchEnd;
+    ds << patchEnd;
+}
+
+std::vector<uint8_t> CreateEntitiesDelta(const GameStateEntities_t& from, const GameStateEntities_t& to)
+{
+    OpenRCT2::MemoryStream ms;
+    DataSerialiser ds(true, ms);
+    for (size_t i = 0; i < MAX_ENTITIES; i++)
+    {
+        if (from.IsEqual(to, i))
+            continue;
+
+        uint16_t index = static_cast<uint16_t>(i);
+        ds << index;
+
+        const auto fromSize = from.GetSize(i);
+        const auto toSize = to.GetSize(i);
+        auto kind = HistoryDeltaKind::Patched;
+        if (toSize == 0)
+            kind = HistoryDeltaKind::Removed;
+        else if (fromSize != toSize || toSize > HistoryPatchEnd)
+            kind = HistoryDeltaKind::Replaced;
+        ds << kind;
+
+        if (kind == HistoryDeltaKind::Replaced)
+        {
+            uint32_t size = static_cast<uint32_t>(toSize);
+            ds << size;
+            ds.GetStream().Write(to.Get(i), toSize);
+        }
+        else if (kind == HistoryDeltaKind::Patched)
+        {
+            WritePatch(ds, from.Get(i), to.Get(i), toSize);
+        }
+    }
+    uint16_t deltaEnd = HistoryDeltaEnd;
+    ds << deltaEnd;
+
+    const auto* data = static_cast<const uint8_t*>(ms.GetData());
+    return std::vector<uint8_t>(data, data + ms.GetLength());
+}
+
+static bool ReadEntityChange(DataSerialiser& ds, const GameStateEntities_t& from, size_t index, GameStateEntities_t& to)
+{
+    auto& stream = ds.GetStream();
+    const size_t start = to.Data.size();
+
+    HistoryDeltaKind kind{};
+    ds << kind;
+    switch (kind)
+    {
+        case HistoryDeltaKind::Removed:
+            return true;
+        case HistoryDeltaKind::Replaced:
+        {
+            uint32_t size = 0;
+            ds << size;
+            if (size > stream.GetLength() - stream.GetPosition())
+                return false;
+            to.Data.resize(start + size);
+            stream.Read(to.Data.data() + start, size);
+            return true;
+        }
+        case HistoryDeltaKind::Patched:
+        {
+            const size_t size = from.GetSize(index);
+            to.Data.insert(to.Data.end(), from.Get(index), from.Get(index) + size);
+            uint16_t offset = HistoryPatchEnd;
+            ds << offset;
+            while (offset != HistoryPatchEnd)
+            {
+                uint16_t length = 0;
+                ds << length;
+                if (static_cast<size_t>(offset) + length > size)
+                    return false;
+                stream.Read(to.Data.data() + start + offset, length);
+                ds << offset;
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool ApplyEntitiesDelta(const GameStateEntities_t& from, const std::vector<uint8_t>& delta, GameStateEntities_t& to)
+{
+    OpenRCT2::MemoryStream ms(delta.data(), delta.size());
+    DataSerialiser ds(false, ms);
+
+    to.Data.clear();
+    to.Data.reserve(from.Data.size());
+
+    try
+    {
+        uint16_t nextIndex = HistoryDeltaEnd;
+        ds << nextIndex;
+        for (size_t i = 0; i < MAX_ENTITIES; i++)
+        {
+            to.Offsets[i] = static_cast<uint32_t>(to.Data.size());
+            if (i != nextIndex)
+            {
+                to.Data.insert(to.Data.end(), from.Get(i), from.Get(i) + from.GetSize(i));
+                continue;
+            }
+
+            if (!ReadEntityChange(ds, from, i, to))
+                return false;
+
+            // Indices have to be ascending, anything else would never be reached.
+            ds << nextIndex;
+            if (nextIndex <= i)
+                return false;
+        }
+        to.Offsets[MAX_ENTITIES] = static_cast<uint32_t>(to.Data.size());
+
+        return nextIndex == HistoryDeltaEnd && ms.GetPosition() == ms.GetLength();
+    }
+    catch (const std::exception&)
+    {
+        // Read past the end of the delta.
+        return false;
+    }
+}
@@ -0,0 +1,57 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "entity/EntityRegistry.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*
+ * The serialised form of every entity for one tick, entity i occupies the bytes [Offsets[i], Offsets[i + 1]) of Data.
+ * Free slots are empty.
+ */
+struct GameStateEntities_t
+{
+    std::vector<uint8_t> Data;
+    std::vector<uint32_t> Offsets = std::vector<uint32_t>(MAX_ENTITIES + 1, 0);
+
+    size_t GetSize(size_t index) const
+    {
+        return Offsets[index + 1] - Offsets[index];
+    }
+
+    const uint8_t* Get(size_t index) const
+    {
+        return Data.data() + Offsets[index];
+    }
+
+    bool IsEqual(const GameStateEntities_t& other, size_t index) const
+    {
+        const auto size = GetSize(index);
+        return size == other.GetSize(index) && std::memcmp(Get(index), other.Get(index), size) == 0;
+    }
+
+    // Hash of a single entity, 0 for free slots. The digest of a tick is the sum over all entities.
+    uint64_t Hash(size_t index) const;
+};
+
+/*
+ * Encodes the entities that differ between two ticks, unchanged entities are skipped and entities that kept their size
+ * only store the byte runs that changed.
+ */
+std::vector<uint8_t> CreateEntitiesDelta(const GameStateEntities_t& from, const GameStateEntities_t& to);
+
+/*
+ * Applies a delta created by CreateEntitiesDelta. Deltas may come from the network, returns false for any delta that
+ * is malformed or does not fit the entities it is applied to.
+ */
+bool ApplyEntitiesDelta(const GameStateEntities_t& from, const std::vector<uint8_t>& delta, GameStateEntities_t& to);
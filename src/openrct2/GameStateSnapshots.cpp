@@ -9,6 +9,7 @@
 
 #include "GameStateSnapshots.h"
 
+#include "GameStateHistory.h"
 #include "core/CircularBuffer.h"
 #include "entity/Balloon.h"
 #include "entity/Duck.h"
@@ -22,9 +23,15 @@
 #include "entity/Staff.h"
 #include "ride/Vehicle.h"
 
+#include <algorithm>
+#include <deque>
+
 static constexpr size_t MaximumGameStateSnapshots = 32;
 static constexpr uint32_t InvalidTick = 0xFFFFFFFF;
 
+// Enough ticks to cover the delay between a desync happening and the client noticing it.
+static constexpr size_t GameStateHistoryTicks = 256;
+
 #pragma pack(push, 1)
 union EntitySnapshot
 {
@@ -53,7 +60,7 @@ struct GameStateSnapshot_t
     OpenRCT2::MemoryStream storedSprites;
     OpenRCT2::MemoryStream parkParameters;
 
-    template<typename T> bool EntitySizeCheck(DataSerialiser& ds)
+    template<typename T> static bool EntitySizeCheck(DataSerialiser& ds)
     {
         uint32_t size = sizeof(T);
         ds << size;
@@ -63,11 +70,58 @@ struct GameStateSnapshot_t
         }
         return true;
     }
-    template<typename... T> bool EntitiesSizeCheck(DataSerialiser& ds)
+    template<typename... T> static bool EntitiesSizeCheck(DataSerialiser& ds)
     {
         return (EntitySizeCheck<T>(ds) && ...);
     }
 
+    // Encodes and checks the size of each of the entity so that we
+    // can fail gracefully when fields added/removed
+    static bool SerialiseEntitySizes(DataSerialiser& ds)
+    {
+        return EntitiesSizeCheck<Vehicle, Guest, Staff, Litter, MoneyEffect, Balloon, Duck, JumpingFountain, SteamParticle>(ds);
+    }
+
+    static void SerialiseEntity(EntitySnapshot& sprite, DataSerialiser& ds)
+    {
+        ds << sprite.base.Type;
+
+        switch (sprite.base.Type)
+        {
+            case EntityType::Vehicle:
+                reinterpret_cast<Vehicle&>(sprite).Serialise(ds);
+                break;
+            case EntityType::Guest:
+                reinterpret_cast<Guest&>(sprite).Serialise(ds);
+                break;
+            case EntityType::Staff:
+                reinterpret_cast<Staff&>(sprite).Serialise(ds);
+                break;
+            case EntityType::Litter:
+                reinterpret_cast<Litter&>(sprite).Serialise(ds);
+                break;
+            case EntityType::MoneyEffect:
+                reinterpret_cast<MoneyEffect&>(sprite).Serialise(ds);
+                break;
+            case EntityType::Balloon:
+                reinterpret_cast<Balloon&>(sprite).Serialise(ds);
+                break;
+            case EntityType::Duck:
+                reinterpret_cast<Duck&>(sprite).Serialise(ds);
+                break;
+            case EntityType::JumpingFountain:
+                reinterpret_cast<JumpingFountain&>(sprite).Serialise(ds);
+                break;
+            case EntityType::SteamParticle:
+                reinterpret_cast<SteamParticle&>(sprite).Serialise(ds);
+                break;
+            case EntityType::Null:
+                break;
+            default:
+                break;
+        }
+    }
+
     // Must pass a function that can access the sprite.
     void SerialiseSprites(std::function<EntitySnapshot*(const size_t)> getEntity, const size_t numSprites, bool saving)
     {
@@ -93,9 +147,7 @@ struct GameStateSnapshot_t
             numSavedSprites = static_cast<uint32_t>(indexTable.size());
         }
 
-        // Encodes and checks the size of each of the entity so that we
-        // can fail gracefully when fields added/removed
-        if (!EntitiesSizeCheck<Vehicle, Guest, Staff, Litter, MoneyEffect, Balloon, Duck, JumpingFountain, SteamParticle>(ds))
+        if (!SerialiseEntitySizes(ds))
         {
             log_error("Entity index corrupted!");
             return;
@@ -118,53 +170,51 @@ struct GameStateSnapshot_t
                 log_error("Entity index corrupted!");
                 return;
             }
-            auto& sprite = *entity;
-
-            ds << sprite.base.Type;
-
-            switch (sprite.base.Type)
-            {
-                case EntityType::Vehicle:
-                    reinterpret_cast<Vehicle&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Guest:
-                    reinterpret_cast<Guest&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Staff:
-                    reinterpret_cast<Staff&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Litter:
-                    reinterpret_cast<Litter&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::MoneyEffect:
-                    reinterpret_cast<MoneyEffect&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Balloon:
-                    reinterpret_cast<Balloon&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Duck:
-                    reinterpret_cast<Duck&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::JumpingFountain:
-                    reinterpret_cast<JumpingFountain&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::SteamParticle:
-                    reinterpret_cast<SteamParticle&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Null:
-                    break;
-                default:
-                    break;
-            }
+            SerialiseEntity(*entity, ds);
         }
     }
 };
 
+struct GameStateHistoryTick_t
+{
+    uint32_t tick = InvalidTick;
+    uint32_t srand0 = 0;
+    // Sum of the hashes of all entities, equal digests mean equal entities.
+    uint64_t digest = 0;
+    // Changes to the entities since the previous tick, unused for the oldest tick.
+    std::vector<uint8_t> delta;
+};
+
+struct GameStateHistory_t
+{
+    GameStateEntities_t base;
+    std::deque<GameStateHistoryTick_t> ticks;
+};
+
+static void CaptureEntities(GameStateEntities_t& entities)
+{
+    OpenRCT2::MemoryStream ms;
+    DataSerialiser ds(true, ms);
+    for (size_t i = 0; i < MAX_ENTITIES; i++)
+    {
+        entities.Offsets[i] = static_cast<uint32_t>(ms.GetPosition());
+        auto* entity = reinterpret_cast<EntitySnapshot*>(GetEntity(i));
+        if (entity == nullptr || entity->base.Type == EntityType::Null)
+            continue;
+        GameStateSnapshot_t::SerialiseEntity(*entity, ds);
+    }
+    entities.Offsets[MAX_ENTITIES] = static_cast<uint32_t>(ms.GetPosition());
+
+    const auto* data = static_cast<const uint8_t*>(ms.GetData());
+    entities.Data.assign(data, data + ms.GetLength());
+}
+
 struct GameStateSnapshots final : public IGameStateSnapshots
 {
     virtual void Reset() override final
     {
         _snapshots.clear();
+        _history.ticks.clear();
     }
 
     virtual GameStateSnapshot_t& CreateSnapshot() override final
@@ -721,7 +771,7 @@ struct GameStateSnapshots final : public IGameStateSnapshots
 
     virtual std::string GetCompareDataText(const GameStateCompareData_t& cmpData) const override
     {
-        std::string outputBuffer;
+        std::string outputBuffer = cmpData.firstDivergence;
         char tempBuffer[1024] = {};
 
         if (cmpData.tickLeft != cmpData.tickRight)
@@ -738,6 +788,11 @@ struct GameStateSnapshots final : public IGameStateSnapshots
             cmpData.srand0Right);
         outputBuffer += tempBuffer;
 
+        if (!cmpData.entityChecksumMismatch.empty())
+        {
+            outputBuffer += "entity checksum mismatch, " + cmpData.entityChecksumMismatch + "\n";
+        }
+
         for (auto& change : cmpData.spriteChanges)
         {
             if (change.changeType == GameStateSpriteChange_t::EQUAL)
@@ -788,8 +843,348 @@ struct GameStateSnapshots final : public IGameStateSnapshots
         return true;
     }
 
+    virtual void RecordHistory(uint32_t tick, uint32_t srand0) override final
+    {
+        auto& ticks = _history.ticks;
+        if (!ticks.empty() && ticks.back().tick == tick)
+            return;
+
+        GameStateEntities_t current;
+        CaptureEntities(current);
+
+        GameStateHistoryTick_t entry;
+        entry.tick = tick;
+        entry.srand0 = srand0;
+
+        if (ticks.empty() || ticks.back().tick + 1 != tick)
+        {
+            // The history has to be contiguous, start over after a gap such as loading a new park.
+            ticks.clear();
+            _historyDigest = 0;
+            for (size_t i = 0; i < MAX_ENTITIES; i++)
+            {
+                _historyHashes[i] = current.Hash(i);
+                _historyDigest += _historyHashes[i];
+            }
+            _history.base = current;
+        }
+        else
+        {
+            entry.delta = CreateEntitiesDelta(_historyLast, current);
+            for (size_t i = 0; i < MAX_ENTITIES; i++)
+            {
+                if (_historyLast.IsEqual(current, i))
+                    continue;
+                _historyDigest -= _historyHashes[i];
+                _historyHashes[i] = current.Hash(i);
+                _historyDigest += _historyHashes[i];
+            }
+        }
+        entry.digest = _historyDigest;
+        ticks.push_back(std::move(entry));
+        _historyLast = std::move(current);
+
+        if (ticks.size() > GameStateHistoryTicks)
+        {
+            ticks.pop_front();
+
+            GameStateEntities_t base;
+            ApplyEntitiesDelta(_history.base, ticks.front().delta, base);
+            _history.base = std::move(base);
+            ticks.front().delta.clear();
+        }
+    }
+
+    virtual void WriteHistory(DataSerialiser& ds) const override final
+    {
+        uint32_t numTicks = static_cast<uint32_t>(_history.ticks.size());
+        ds << numTicks;
+        if (numTicks == 0)
+            return;
+
+        const auto& base = _history.base;
+        uint32_t numEntities = 0;
+        for (size_t i = 0; i < MAX_ENTITIES; i++)
+        {
+            if (base.GetSize(i) != 0)
+                numEntities++;
+        }
+        ds << numEntities;
+        for (size_t i = 0; i < MAX_ENTITIES; i++)
+        {
+            uint32_t size = static_cast<uint32_t>(base.GetSize(i));
+            if (size == 0)
+                continue;
+            uint16_t index = static_cast<uint16_t>(i);
+            ds << index;
+            ds << size;
+            ds.GetStream().Write(base.Get(i), size);
+        }
+
+        for (const auto& entry : _history.ticks)
+        {
+            uint32_t tick = entry.tick;
+            uint32_t srand0 = entry.srand0;
+            uint64_t digest = entry.digest;
+            uint32_t deltaSize = static_cast<uint32_t>(entry.delta.size());
+            ds << tick;
+            ds << srand0;
+            ds << digest;
+            ds << deltaSize;
+            ds.GetStream().Write(entry.delta.data(), deltaSize);
+        }
+    }
+
+    static bool ReadHistoryData(DataSerialiser& ds, GameStateHistory_t& history)
+    {
+        auto& stream = ds.GetStream();
+        const auto getRemaining = [&stream]() { return stream.GetLength() - stream.GetPosition(); };
+
+        uint32_t numTicks = 0;
+        ds << numTicks;
+        if (numTicks == 0)
+            return true;
+        if (numTicks > GameStateHistoryTicks)
+            return false;
+
+        auto& base = history.base;
+        uint32_t numEntities = 0;
+        ds << numEntities;
+        if (numEntities > MAX_ENTITIES)
+            return false;
+
+        size_t nextIndex = 0;
+        for (uint32_t n = 0; n < numEntities; n++)
+        {
+            uint16_t index = 0;
+            uint32_t size = 0;
+            ds << index;
+            ds << size;
+            if (index < nextIndex || index >= MAX_ENTITIES || size > getRemaining())
+                return false;
+
+            for (; nextIndex <= index; nextIndex++)
+            {
+                base.Offsets[nextIndex] = static_cast<uint32_t>(base.Data.size());
+            }
+            base.Data.resize(base.Data.size() + size);
+            stream.Read(base.Data.data() + base.Offsets[index], size);
+        }
+        for (; nextIndex <= MAX_ENTITIES; nextIndex++)
+        {
+            base.Offsets[nextIndex] = static_cast<uint32_t>(base.Data.size());
+        }
+
+        history.ticks.resize(numTicks);
+        for (auto& entry : history.ticks)
+        {
+            uint32_t deltaSize = 0;
+            ds << entry.tick;
+            ds << entry.srand0;
+            ds << entry.digest;
+            ds << deltaSize;
+            if (deltaSize > getRemaining())
+                return false;
+
+            entry.delta.resize(deltaSize);
+            stream.Read(entry.delta.data(), deltaSize);
+        }
+
+        // The ticks are looked up by their distance to the first one.
+        const uint32_t firstTick = history.ticks.front().tick;
+        if (firstTick > InvalidTick - numTicks)
+            return false;
+        for (uint32_t n = 0; n < numTicks; n++)
+        {
+            if (history.ticks[n].tick != firstTick + n)
+                return false;
+        }
+        return true;
+    }
+
+    // Reads a history written by WriteHistory on the other side, returns false if it is malformed.
+    static bool ReadHistory(DataSerialiser& ds, GameStateHistory_t& history)
+    {
+        try
+        {
+            return ReadHistoryData(ds, history);
+        }
+        catch (const std::exception&)
+        {
+            // Read past the end of the stream.
+            return false;
+        }
+    }
+
+    // Rebuilds the entities as they were at the given position of the history.
+    static bool GetHistoryEntities(const GameStateHistory_t& history, size_t position, GameStateEntities_t& entities)
+    {
+        entities = history.base;
+        for (size_t i = 1; i <= position; i++)
+        {
+            GameStateEntities_t next;
+            if (!ApplyEntitiesDelta(entities, history.ticks[i].delta, next))
+                return false;
+            entities = std::move(next);
+        }
+        return true;
+    }
+
+    static bool CreateHistorySnapshot(const GameStateHistory_t& history, size_t position, GameStateSnapshot_t& snapshot)
+    {
+        GameStateEntities_t entities;
+        if (!GetHistoryEntities(history, position, entities))
+            return false;
+
+        snapshot.tick = history.ticks[position].tick;
+        snapshot.srand0 = history.ticks[position].srand0;
+
+        // Same layout as GameStateSnapshot_t::SerialiseSprites writes.
+        snapshot.storedSprites.SetPosition(0);
+        DataSerialiser ds(true, snapshot.storedSprites);
+        GameStateSnapshot_t::SerialiseEntitySizes(ds);
+        uint32_t numSavedSprites = 0;
+        for (size_t i = 0; i < MAX_ENTITIES; i++)
+        {
+            if (entities.GetSize(i) != 0)
+                numSavedSprites++;
+        }
+        ds << numSavedSprites;
+        for (size_t i = 0; i < MAX_ENTITIES; i++)
+        {
+            if (entities.GetSize(i) == 0)
+                continue;
+            uint32_t index = static_cast<uint32_t>(i);
+            ds << index;
+            ds.GetStream().Write(entities.Get(i), entities.GetSize(i));
+        }
+        return true;
+    }
+
+    virtual std::optional<GameStateBisectResult_t> BisectHistory(DataSerialiser& ds) override final
+    {
+        GameStateHistory_t other;
+        if (!ReadHistory(ds, other))
+        {
+            log_warning("Received malformed game state history.");
+            return std::nullopt;
+        }
+
+        const auto& local = _history;
+        if (other.ticks.empty() || local.ticks.empty())
+            return std::nullopt;
+
+        const uint32_t firstTick = std::max(other.ticks.front().tick, local.ticks.front().tick);
+        const uint32_t lastTick = std::min(other.ticks.back().tick, local.ticks.back().tick);
+        if (firstTick > lastTick)
+            return std::nullopt;
+
+        const size_t otherStart = firstTick - other.ticks.front().tick;
+        const size_t localStart = firstTick - local.ticks.front().tick;
+        const auto isEqual = [&](uint32_t tick) {
+            const auto& a = other.ticks[otherStart + (tick - firstTick)];
+            const auto& b = local.ticks[localStart + (tick - firstTick)];
+            return a.digest == b.digest && a.srand0 == b.srand0;
+        };
+
+        // Once the states diverge they stay diverged, so the first tick that differs can be bisected.
+        uint32_t low = firstTick;
+        uint32_t high = lastTick + 1;
+        while (low < high)
+        {
+            const uint32_t mid = low + (high - low) / 2;
+            if (isEqual(mid))
+                low = mid + 1;
+            else
+                high = mid;
+        }
+
+        GameStateBisectResult_t result;
+        result.firstTick = firstTick;
+        result.lastTick = lastTick;
+        result.divergedTick = InvalidTick;
+        if (low > lastTick)
+            return result;
+
+        result.divergedTick = low;
+        GameStateSnapshot_t otherSnapshot;
+        GameStateSnapshot_t localSnapshot;
+        if (!CreateHistorySnapshot(other, otherStart + (low - firstTick), otherSnapshot)
+            || !CreateHistorySnapshot(local, localStart + (low - firstTick), localSnapshot))
+        {
+            log_warning("Received malformed game state history.");
+            return std::nullopt;
+        }
+        result.compareData = Compare(otherSnapshot, localSnapshot);
+        return result;
+    }
+
+    virtual std::string GetBisectResultText(const GameStateBisectResult_t& result) const override final
+    {
+        char tempBuffer[256] = {};
+        if (result.divergedTick == InvalidTick)
+        {
+            snprintf(
+                tempBuffer, sizeof(tempBuffer), "tick history agrees from tick %08X to %08X\n", result.firstTick,
+                result.lastTick);
+            return tempBuffer;
+        }
+
+        std::string outputBuffer;
+        if (result.divergedTick == result.firstTick)
+        {
+            snprintf(
+                tempBuffer, sizeof(tempBuffer), "tick history already differs at its first tick %08X\n",
+                result.divergedTick);
+        }
+        else
+        {
+            snprintf(
+                tempBuffer, sizeof(tempBuffer), "first divergent tick = %08X, last equal tick = %08X\n", result.divergedTick,
+                result.divergedTick - 1);
+        }
+        outputBuffer += tempBuffer;
+
+        const auto& cmpData = result.compareData;
+        if (cmpData.srand0Left != cmpData.srand0Right)
+        {
+            snprintf(
+                tempBuffer, sizeof(tempBuffer), "  srand0 left = %08X, srand0 right = %08X\n", cmpData.srand0Left,
+                cmpData.srand0Right);
+            outputBuffer += tempBuffer;
+        }
+        for (auto& change : cmpData.spriteChanges)
+        {
+            if (change.changeType == GameStateSpriteChange_t::EQUAL)
+                continue;
+
+            const char* typeName = GetEntityTypeName(change.entityType);
+            if (change.changeType == GameStateSpriteChange_t::MODIFIED && !change.diffs.empty())
+            {
+                const auto& diff = change.diffs.front();
+                snprintf(
+                    tempBuffer, sizeof(tempBuffer), "  first field = %s::%s (%s), index: %u\n", diff.structname,
+                    diff.fieldname, typeName, change.spriteIndex);
+            }
+            else
+            {
+                snprintf(tempBuffer, sizeof(tempBuffer), "  first entity = %s, index: %u\n", typeName, change.spriteIndex);
+            }
+            return outputBuffer + tempBuffer;
+        }
+        if (cmpData.srand0Left == cmpData.srand0Right)
+        {
+            outputBuffer += "  entities only differ in fields that are not compared\n";
+        }
+        return outputBuffer;
+    }
+
 private:
     CircularBuffer<std::unique_ptr<GameStateSnapshot_t>, MaximumGameStateSnapshots> _snapshots;
+    GameStateHistory_t _history;
+    GameStateEntities_t _historyLast;
+    std::vector<uint64_t> _historyHashes = std::vector<uint64_t>(MAX_ENTITIES, 0);
+    uint64_t _historyDigest = 0;
 };
 
 std::unique_ptr<IGameStateSnapshots> CreateGameStateSnapshots()
@@ -13,6 +13,7 @@
 #include "core/DataSerialiser.h"
 
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 
@@ -52,6 +53,20 @@ struct GameStateCompareData_t
     uint32_t srand0Left;
     uint32_t srand0Right;
     std::vector<GameStateSpriteChange_t> spriteChanges;
+    // Set when the desync was caught by the per tick entity checksum.
+    std::string entityChecksumMismatch;
+    // Set when the tick histories of both sides were bisected, see IGameStateSnapshots::BisectHistory.
+    std::string firstDivergence;
+};
+
+struct GameStateBisectResult_t
+{
+    // Range of ticks both histories have in common.
+    uint32_t firstTick;
+    uint32_t lastTick;
+    // First tick at which the histories differ, 0xFFFFFFFF if they agree on the whole range.
+    uint32_t divergedTick;
+    GameStateCompareData_t compareData;
 };
 
 /*
@@ -108,6 +123,29 @@ struct IGameStateSnapshots
      * Generates a string of readable text from GameStateCompareData_t
      */
     virtual std::string GetCompareDataText(const GameStateCompareData_t& cmpData) const = 0;
+
+    /*
+     * Records the entities of the current tick into a history of the last few hundred ticks, only the changes
+     * to the previous tick are kept. Recording a tick that does not follow the previous one starts a new history.
+     */
+    virtual void RecordHistory(uint32_t tick, uint32_t srand0) = 0;
+
+    /*
+     * Serialises the tick history so that it can be bisected against the history of another game.
+     */
+    virtual void WriteHistory(DataSerialiser& serialiser) const = 0;
+
+    /*
+     * Reads the tick history of another game and searches for the first tick both disagree on, the entities of
+     * that tick are compared with the other game on the left. Returns nothing when the histories have no ticks in common
+     * or the other history is malformed.
+     */
+    virtual std::optional<GameStateBisectResult_t> BisectHistory(DataSerialiser& otherHistory) = 0;
+
+    /*
+     * Generates a short summary of a bisect, the first divergent tick and the first entity field that differs.
+     */
+    virtual std::string GetBisectResultText(const GameStateBisectResult_t& result) const = 0;
 };
 
 [[nodiscard]] std::unique_ptr<IGameStateSnapshots> CreateGameStateSnapshots();
@@ -0,0 +1,152 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "LogicPhaseGraph.h"
+
+#include "core/JobPool.h"
+#include "drawing/Drawing.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace OpenRCT2;
+
+// Effects deferred by the phase running on this thread, null outside a thread safe phase of a wave.
+static thread_local std::vector<std::function<void()>>* _currentDeferredEffects;
+
+void LogicPhaseGraph::Add(LogicPhase phase)
+{
+    _phases.push_back(std::move(phase));
+    _waves.clear();
+}
+
+/**
+ * a is the phase added first. Its deferred effects run after every thread safe phase of its wave, so they
+ * must not touch anything such a phase b uses.
+ */
+bool LogicPhaseGraph::Conflicts(const LogicPhase& a, const LogicPhase& b)
+{
+    if ((a.Writes & (b.Reads | b.Writes)) != 0 || (b.Writes & a.Reads) != 0)
+    {
+        return true;
+    }
+    return b.ThreadSafe && (a.Commits & (b.Reads | b.Writes)) != 0;
+}
+
+/**
+ * Assigns every phase to the earliest wave after all earlier phases it conflicts with.
+ * Phases sharing a wave are independent of each other and may run concurrently.
+ */
+void LogicPhaseGraph::Build()
+{
+    std::vector<size_t> level(_phases.size(), 0);
+    size_t numWaves = 0;
+    for (size_t j = 0; j < _phases.size(); j++)
+    {
+        for (size_t i = 0; i < j; i++)
+        {
+            if (Conflicts(_phases[i], _phases[j]))
+            {
+                level[j] = std::max(level[j], level[i] + 1);
+            }
+        }
+        numWaves = std::max(numWaves, level[j] + 1);
+    }
+
+    _waves.clear();
+    _waves.resize(numWaves);
+    for (size_t j = 0; j < _phases.size(); j++)
+    {
+        _waves[level[j]].push_back(j);
+    }
+    _deferredDirtyBlocks.resize(_phases.size());
+    _deferredEffects.resize(_phases.size());
+}
+
+const std::vector<std::vector<size_t>>& LogicPhaseGraph::GetWaves() const
+{
+    return _waves;
+}
+
+void LogicPhaseGraph::Defer(std::function<void()> effect)
+{
+    if (_currentDeferredEffects != nullptr)
+    {
+        _currentDeferredEffects->push_back(std::move(effect));
+    }
+    else
+    {
+        effect();
+    }
+}
+
+void LogicPhaseGraph::RunSerial(const std::function<void(LogicTimePart)>& reportFn) const
+{
+    for (const auto& phase : _phases)
+    {
+        phase.Update();
+        reportFn(phase.Part);
+    }
+}
+
+void LogicPhaseGraph::RunParallel(JobPool& jobPool, const std::function<void(LogicTimePart)>& reportFn) const
+{
+    for (const auto& wave : _waves)
+    {
+        if (wave.size() == 1)
+        {
+            const auto& phase = _phases[wave[0]];
+            phase.Update();
+            reportFn(phase.Part);
+            continue;
+        }
+
+        JobPool::TaskGroup group(jobPool);
+        for (auto index : wave)
+        {
+            if (_phases[index].ThreadSafe)
+            {
+                group.Run([this, index]() {
+                    gfx_defer_dirty_blocks(&_deferredDirtyBlocks[index]);
+                    // A worker waiting inside a phase may pick up another phase's task.
+                    auto* outerEffects = std::exchange(_currentDeferredEffects, &_deferredEffects[index]);
+                    _phases[index].Update();
+                    _currentDeferredEffects = outerEffects;
+                    gfx_defer_dirty_blocks(nullptr);
+                });
+            }
+        }
+        group.Wait();
+
+        for (auto index : wave)
+        {
+            if (_phases[index].ThreadSafe)
+            {
+                auto& effects = _deferredEffects[index];
+                for (const auto& effect : effects)
+                {
+                    effect();
+                }
+                effects.clear();
+            }
+            else
+            {
+                _phases[index].Update();
+            }
+
+            auto& dirtyBlocks = _deferredDirtyBlocks[index];
+            for (const auto& rect : dirtyBlocks)
+            {
+                gfx_set_dirty_blocks(rect);
+            }
+            dirtyBlocks.clear();
+            reportFn(_phases[index].Part);
+        }
+    }
+}
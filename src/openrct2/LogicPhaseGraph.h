@@ -0,0 +1,99 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GameState.h"
+#include "util/Util.h"
+#include "world/Location.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class JobPool;
+
+namespace OpenRCT2
+{
+    // Coarse partitions of the game state, logic phases declare which of them they read and write.
+    enum class LogicResource : uint8_t
+    {
+        Date,
+        Scenario,
+        Climate,
+        TileElements,
+        Entities,
+        Rides,
+        RideRatings,
+        RideMeasurements,
+        Park,
+        Finance,
+        Research,
+        News,
+        MapAnimations,
+        Objects,
+        Windows,
+        Audio,
+        Random,
+        GameActions,
+        Network,
+        Count,
+    };
+
+    using LogicResources = uint64_t;
+
+    constexpr LogicResources LogicResourcesAll = (1ULL << EnumValue(LogicResource::Count)) - 1;
+
+    struct LogicPhase
+    {
+        LogicTimePart Part;
+        LogicResources Reads;
+        LogicResources Writes;
+        // Written by the effects the phase defers, see LogicPhaseGraph::Defer.
+        LogicResources Commits;
+        // Phases that are not thread safe always run on the thread updating the game state.
+        bool ThreadSafe;
+        std::function<void()> Update;
+    };
+
+    /**
+     * Runs the phases of a logic tick. Two phases conflict when one writes a resource the other reads or
+     * writes, conflicting phases always run in the order they were added. Everything else may overlap,
+     * so as long as the declarations are truthful the outcome is identical to a serial update.
+     *
+     * The thread safe phases of a wave run first. Their deferred effects and the phases that are not thread
+     * safe are then run on the updating thread in the order the phases were added.
+     */
+    class LogicPhaseGraph
+    {
+    private:
+        std::vector<LogicPhase> _phases;
+        std::vector<std::vector<size_t>> _waves;
+        mutable std::vector<std::vector<ScreenRect>> _deferredDirtyBlocks;
+        mutable std::vector<std::vector<std::function<void()>>> _deferredEffects;
+
+    public:
+        void Add(LogicPhase phase);
+        void Build();
+
+        static bool Conflicts(const LogicPhase& a, const LogicPhase& b);
+        const std::vector<std::vector<size_t>>& GetWaves() const;
+
+        /**
+         * Runs an effect that is only safe on the thread updating the game state, such as calling scripts,
+         * invalidating windows or executing game actions. Inside a thread safe phase that runs alongside
+         * others the effect is held back until the wave is done, everywhere else it runs straight away.
+         */
+        static void Defer(std::function<void()> effect);
+
+        // reportFn is invoked on the calling thread once the given phase has finished.
+        void RunSerial(const std::function<void(LogicTimePart)>& reportFn) const;
+        void RunParallel(JobPool& jobPool, const std::function<void(LogicTimePart)>& reportFn) const;
+    };
+} // namespace OpenRCT2
@@ -53,11 +53,16 @@
 #include "world/Park.h"
 #include "world/Scenery.h"
 
+#include <condition_variable>
 #include <cstdint>
 #include <ctime>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <numeric>
 #include <optional>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 using namespace OpenRCT2;
@@ -73,11 +78,14 @@ static void UpdateFootpathsFromMapping(
 namespace OpenRCT2
 {
     // Current version that is saved.
-    constexpr uint32_t PARK_FILE_CURRENT_VERSION = 0x7;
+    constexpr uint32_t PARK_FILE_CURRENT_VERSION = 0x8;
 
     // The minimum version that is forwards compatible with the current version.
     constexpr uint32_t PARK_FILE_MIN_VERSION = 0x7;
 
+    // The minimum version that can read block compressed files.
+    constexpr uint32_t PARK_FILE_GZIP_BLOCKS_MIN_VERSION = 0x8;
+
     namespace ParkFileChunkType
     {
         // clang-format off
@@ -103,12 +111,111 @@ namespace OpenRCT2
         // clang-format on
     }; // namespace ParkFileChunkType
 
+    /**
+     * Compresses and writes serialised parks on a background thread, in the order they were queued.
+     */
+    class AsyncSaveWriter
+    {
+    private:
+        struct PendingSave
+        {
+            std::string Path;
+            OrcaStream::PendingWrite Data;
+            std::function<void(bool)> Callback;
+        };
+
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::deque<PendingSave> _queue;
+        std::thread _thread;
+        bool _writing{};
+        bool _shouldStop{};
+
+    public:
+        static AsyncSaveWriter& Get()
+        {
+            static AsyncSaveWriter instance;
+            return instance;
+        }
+
+        ~AsyncSaveWriter()
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _shouldStop = true;
+            }
+            _condition.notify_all();
+            if (_thread.joinable())
+            {
+                _thread.join();
+            }
+        }
+
+        void Enqueue(std::string path, OrcaStream::PendingWrite&& data, std::function<void(bool)> callback)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _queue.push_back({ std::move(path), std::move(data), std::move(callback) });
+            if (!_thread.joinable())
+            {
+                _thread = std::thread(&AsyncSaveWriter::ProcessQueue, this);
+            }
+            _condition.notify_all();
+        }
+
+        // Blocks until every queued save has been written.
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]() { return _queue.empty() && !_writing; });
+        }
+
+    private:
+        void ProcessQueue()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (true)
+            {
+                _condition.wait(lock, [this]() { return _shouldStop || !_queue.empty(); });
+                if (_queue.empty())
+                {
+                    break;
+                }
+
+                auto save = std::move(_queue.front());
+                _queue.pop_front();
+                _writing = true;
+                lock.unlock();
+
+                bool result = false;
+                try
+                {
+                    FileStream fs(save.Path, FILE_MODE_WRITE);
+                    save.Data.WriteTo(fs);
+                    result = true;
+                }
+                catch (const std::exception& e)
+                {
+                    log_error("Unable to write %s: %s", save.Path.c_str(), e.what());
+                }
+                if (save.Callback)
+                {
+                    save.Callback(result);
+                }
+
+                lock.lock();
+                _writing = false;
+                _condition.notify_all();
+            }
+        }
+    };
+
     class ParkFile
     {
     public:
         ObjectList RequiredObjects;
         std::vector<const ObjectRepositoryItem*> ExportObjectsList;
         bool OmitTracklessRides{};
+        uint32_t Compression = OrcaStream::COMPRESSION_GZIP_BLOCKS;
 
     private:
         std::unique_ptr<OrcaStream> _os;
@@ -119,6 +226,8 @@ namespace OpenRCT2
     public:
         void Load(const std::string_view& path)
         {
+            // The file may still be written by a background save.
+            AsyncSaveWriter::Get().Wait();
             FileStream fs(path, FILE_MODE_OPEN);
             Load(fs);
         }
@@ -158,12 +267,23 @@ namespace OpenRCT2
 
         void Save(IStream& stream)
         {
-            OrcaStream os(stream, OrcaStream::Mode::WRITING);
+            Serialise().WriteTo(stream);
+        }
+
+        /**
+         * Writes every chunk of the park to memory. Compressing and writing the returned data no longer touches the
+         * game state.
+         */
+        OrcaStream::PendingWrite Serialise()
+        {
+            OrcaStream os;
 
             auto& header = os.GetHeader();
             header.Magic = PARK_FILE_MAGIC;
             header.TargetVersion = PARK_FILE_CURRENT_VERSION;
-            header.MinVersion = PARK_FILE_MIN_VERSION;
+            header.MinVersion = Compression == OrcaStream::COMPRESSION_GZIP_BLOCKS ? PARK_FILE_GZIP_BLOCKS_MIN_VERSION
+                                                                                    : PARK_FILE_MIN_VERSION;
+            header.Compression = Compression;
 
             ReadWriteAuthoringChunk(os);
             ReadWriteObjectsChunk(os);
@@ -181,12 +301,44 @@ namespace OpenRCT2
             ReadWriteCheatsChunk(os);
             ReadWriteRestrictedObjectsChunk(os);
             ReadWritePackedObjectsChunk(os);
+            return os.Detach();
         }
 
         void Save(const std::string_view& path)
         {
+            auto data = Serialise();
+            AsyncSaveWriter::Get().Wait();
             FileStream fs(path, FILE_MODE_WRITE);
-            Save(fs);
+            data.WriteTo(fs);
+        }
+
+        /**
+         * Reads the header and the few chunks needed to list the park. Only the blocks those chunks are stored in
+         * are inflated.
+         */
+        ParkFileMetadata ReadMetadata(IStream& stream)
+        {
+            _os = std::make_unique<OrcaStream>(stream, OrcaStream::Mode::READING, true);
+            auto& os = *_os;
+            if (os.GetHeader().Magic != PARK_FILE_MAGIC)
+            {
+                throw std::runtime_error("Not a park file.");
+            }
+
+            ParkFileMetadata metadata;
+            metadata.TargetVersion = os.GetHeader().TargetVersion;
+            metadata.Scenario = ReadScenarioChunk();
+            os.ReadWriteChunk(ParkFileChunkType::GENERAL, [&metadata](OrcaStream::ChunkStream& cs) {
+                cs.Ignore<uint8_t>();
+                cs.ReadWrite(metadata.CurrentTicks);
+                cs.Ignore<uint16_t>();
+                cs.ReadWrite(metadata.MonthsElapsed);
+            });
+            os.ReadWriteChunk(ParkFileChunkType::PARK, [&metadata](OrcaStream::ChunkStream& cs) {
+                cs.ReadWrite(metadata.ParkName);
+                cs.ReadWrite(metadata.Cash);
+            });
+            return metadata;
         }
 
         scenario_index_entry ReadScenarioChunk()
@@ -2213,9 +2365,27 @@ namespace OpenRCT2
     }
 } // namespace OpenRCT2
 
+ParkFileExporter::ParkFileExporter()
+    : Compression(OrcaStream::COMPRESSION_GZIP_BLOCKS)
+{
+}
+
+ParkFileMetadata OpenRCT2::ReadParkFileMetadata(std::string_view path)
+{
+    FileStream fs(path, FILE_MODE_OPEN);
+    return ReadParkFileMetadata(fs);
+}
+
+ParkFileMetadata OpenRCT2::ReadParkFileMetadata(IStream& stream)
+{
+    auto parkFile = std::make_unique<OpenRCT2::ParkFile>();
+    return parkFile->ReadMetadata(stream);
+}
+
 void ParkFileExporter::Export(std::string_view path)
 {
     auto parkFile = std::make_unique<OpenRCT2::ParkFile>();
+    parkFile->Compression = Compression;
     parkFile->Save(path);
 }
 
@@ -2223,6 +2393,7 @@ void ParkFileExporter::Export(IStream& stream)
 {
     auto parkFile = std::make_unique<OpenRCT2::ParkFile>();
     parkFile->ExportObjectsList = ExportObjectsList;
+    parkFile->Compression = Compression;
     parkFile->Save(stream);
 }
 
@@ -2285,6 +2456,45 @@ int32_t scenario_save(const utf8* path, int32_t flags)
     return result;
 }
 
+bool scenario_save_async(const utf8* path, int32_t flags, std::function<void(bool)> callback)
+{
+    if (!(flags & S6_SAVE_FLAG_AUTOMATIC))
+    {
+        window_close_construction_windows();
+    }
+
+    viewport_set_saved_view();
+
+    try
+    {
+        auto parkFile = std::make_unique<OpenRCT2::ParkFile>();
+        if (flags & S6_SAVE_FLAG_EXPORT)
+        {
+            auto& objManager = OpenRCT2::GetContext()->GetObjectManager();
+            parkFile->ExportObjectsList = objManager.GetPackableObjects();
+        }
+        parkFile->OmitTracklessRides = true;
+        OpenRCT2::AsyncSaveWriter::Get().Enqueue(path, parkFile->Serialise(), std::move(callback));
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+
+    gfx_invalidate_screen();
+
+    if (!(flags & S6_SAVE_FLAG_AUTOMATIC))
+    {
+        gScreenAge = 0;
+    }
+    return true;
+}
+
+void scenario_save_async_wait()
+{
+    OpenRCT2::AsyncSaveWriter::Get().Wait();
+}
+
 class ParkFileImporter final : public IParkImporter
 {
 private:
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "scenario/ScenarioRepository.h"
+
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -10,12 +13,32 @@ namespace OpenRCT2
     constexpr uint32_t PARK_FILE_MAGIC = 0x4B524150; // PARK
 
     struct IStream;
+
+    /**
+     * The parts of a park file needed to list it, read without inflating the tile map, entities or objects.
+     */
+    struct ParkFileMetadata
+    {
+        uint32_t TargetVersion{};
+        scenario_index_entry Scenario{};
+        std::string ParkName;
+        money64 Cash{};
+        uint32_t CurrentTicks{};
+        int32_t MonthsElapsed{};
+    };
+
+    ParkFileMetadata ReadParkFileMetadata(std::string_view path);
+    ParkFileMetadata ReadParkFileMetadata(IStream& stream);
 } // namespace OpenRCT2
 
 class ParkFileExporter
 {
 public:
     std::vector<const ObjectRepositoryItem*> ExportObjectsList;
+    // One of the OrcaStream compression modes.
+    uint32_t Compression;
+
+    ParkFileExporter();
 
     void Export(std::string_view path);
     void Export(OpenRCT2::IStream& stream);
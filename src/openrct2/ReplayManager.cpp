@@ -11,6 +11,7 @@
 
 #include "Context.h"
 #include "Game.h"
+#include "GameState.h"
 #include "GameStateSnapshots.h"
 #include "OpenRCT2.h"
 #include "ParkFile.h"
@@ -35,6 +36,7 @@
 #include "world/Park.h"
 #include "zlib.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <vector>
@@ -78,6 +80,13 @@ namespace OpenRCT2
         OpenRCT2::MemoryStream data;
     };
 
+    struct ReplayKeyframe
+    {
+        uint32_t tick;
+        OpenRCT2::MemoryStream parkData;
+        OpenRCT2::MemoryStream parkParams;
+    };
+
     struct ReplayRecordData
     {
         uint32_t magic;
@@ -92,18 +101,22 @@ namespace OpenRCT2
         uint32_t tickStart;    // First tick of replay.
         uint32_t tickEnd;      // Last tick of replay.
         std::multiset<ReplayCommand> commands;
+        std::multiset<ReplayCommand>::iterator nextCommand; // Next command to replay, commands are kept for seeking.
         std::vector<std::pair<uint32_t, EntitiesChecksum>> checksums;
         uint32_t checksumIndex;
         OpenRCT2::MemoryStream gameStateSnapshots;
+        std::vector<ReplayKeyframe> keyframes; // Park state at the start of every KeyframeTicks ticks.
     };
 
     class ReplayManager final : public IReplayManager
     {
-        static constexpr uint16_t ReplayVersion = 10;
+        static constexpr uint16_t ReplayVersion = 11;
+        static constexpr uint16_t ReplayKeyframesVersion = 11;
         static constexpr uint32_t ReplayMagic = 0x5243524F; // ORCR.
         static constexpr int ReplayCompressionLevel = 9;
         static constexpr int NormalRecordingChecksumTicks = 1;
         static constexpr int SilentRecordingChecksumTicks = 40; // Same as network server
+        static constexpr uint32_t KeyframeTicks = 40 * 60 * 2;  // Two minutes of game time.
 
         enum class ReplayMode
         {
@@ -159,6 +172,13 @@ namespace OpenRCT2
             if (_mode == ReplayMode::NONE)
                 return;
 
+            // Taken before anything runs this tick, so the commands of this tick are replayed after restoring it.
+            if ((_mode == ReplayMode::RECORDING || _mode == ReplayMode::NORMALISATION) && gCurrentTicks >= _nextKeyframeTick)
+            {
+                AddKeyframe();
+                _nextKeyframeTick = gCurrentTicks + _keyframeTicks;
+            }
+
             if ((_mode == ReplayMode::RECORDING || _mode == ReplayMode::NORMALISATION) && gCurrentTicks == _nextChecksumTick)
             {
                 EntitiesChecksum checksum = GetAllEntitiesChecksum();
@@ -196,7 +216,7 @@ namespace OpenRCT2
                 ReplayCommands();
 
                 // If we run out of commands we can just stop
-                if (_currentReplay->commands.empty())
+                if (_currentReplay->nextCommand == _currentReplay->commands.end())
                 {
                     StopPlayback();
                     StopRecording();
@@ -245,10 +265,9 @@ namespace OpenRCT2
 
             auto context = GetContext();
             auto& objManager = context->GetObjectManager();
-            auto objects = objManager.GetPackableObjects();
 
             auto exporter = std::make_unique<ParkFileExporter>();
-            exporter->ExportObjectsList = objects;
+            exporter->ExportObjectsList = objManager.GetPackableObjects();
             exporter->Export(replayData->parkData);
 
             replayData->timeRecorded = std::chrono::seconds(std::time(nullptr)).count();
@@ -267,6 +286,7 @@ namespace OpenRCT2
             _currentRecording = std::move(replayData);
             _recordType = rt;
             _nextChecksumTick = gCurrentTicks + 1;
+            _nextKeyframeTick = gCurrentTicks + _keyframeTicks;
 
             return true;
         }
@@ -371,6 +391,7 @@ namespace OpenRCT2
                 info.Ticks = data->tickEnd - data->tickStart;
             info.NumCommands = static_cast<uint32_t>(data->commands.size());
             info.NumChecksums = static_cast<uint32_t>(data->checksums.size());
+            info.NumKeyframes = static_cast<uint32_t>(data->keyframes.size());
 
             return true;
         }
@@ -427,7 +448,7 @@ namespace OpenRCT2
                 return false;
             }
 
-            if (!LoadReplayDataMap(*replayData))
+            if (!LoadReplayDataMap(replayData->parkData, replayData->parkParams))
             {
                 log_error("Unable to load map.");
                 return false;
@@ -438,8 +459,9 @@ namespace OpenRCT2
             LoadAndCompareSnapshot(replayData->gameStateSnapshots);
 
             _currentReplay = std::move(replayData);
+            _currentReplay->nextCommand = _currentReplay->commands.begin();
             _currentReplay->checksumIndex = 0;
-            _faultyChecksumIndex = -1;
+            _firstMismatch.reset();
 
             // Make sure game is not paused.
             gGamePaused = 0;
@@ -452,7 +474,57 @@ namespace OpenRCT2
 
         virtual bool IsPlaybackStateMismatching() const override
         {
-            return _faultyChecksumIndex != -1;
+            return _firstMismatch.has_value();
+        }
+
+        virtual std::optional<ReplayChecksumMismatch> GetFirstChecksumMismatch() const override
+        {
+            return _firstMismatch;
+        }
+
+        /**
+         * Moves playback to the given number of ticks since the start of the replay. Unless playback is already between
+         * it and the target, the closest keyframe before the target is restored first, the remaining ticks are simulated.
+         */
+        virtual bool SeekPlayback(uint32_t tick) override
+        {
+            if (_mode != ReplayMode::PLAYING)
+                return false;
+
+            auto& replay = *_currentReplay;
+            if (tick > replay.tickEnd - replay.tickStart)
+                return false;
+
+            const uint32_t targetTick = replay.tickStart + tick;
+            auto keyframe = std::upper_bound(
+                replay.keyframes.begin(), replay.keyframes.end(), targetTick,
+                [](uint32_t value, const ReplayKeyframe& k) { return value < k.tick; });
+            auto* restoreKeyframe = keyframe == replay.keyframes.begin() ? nullptr : &*std::prev(keyframe);
+            const uint32_t restoreTick = restoreKeyframe != nullptr ? restoreKeyframe->tick : replay.tickStart;
+            if (gCurrentTicks > targetTick || gCurrentTicks < restoreTick)
+            {
+                if (!RestoreKeyframe(restoreKeyframe))
+                {
+                    log_error("Unable to restore replay keyframe at tick %u.", restoreTick);
+                    return false;
+                }
+            }
+
+            _seeking = true;
+            auto* gameState = GetContext()->GetGameState();
+            while (_mode == ReplayMode::PLAYING && gCurrentTicks < targetTick)
+            {
+                gameState->UpdateLogic();
+            }
+            _seeking = false;
+
+            return gCurrentTicks == targetTick;
+        }
+
+        // Only affects recordings started afterwards.
+        virtual void SetKeyframeInterval(uint32_t ticks) override
+        {
+            _keyframeTicks = std::max<uint32_t>(ticks, 1);
         }
 
         virtual bool StopPlayback() override
@@ -513,17 +585,18 @@ namespace OpenRCT2
             }
         }
 
-        bool LoadReplayDataMap(ReplayRecordData& data)
+        bool LoadReplayDataMap(MemoryStream& parkData, MemoryStream& parkParams)
         {
             try
             {
-                data.parkData.SetPosition(0);
+                parkData.SetPosition(0);
+                parkParams.SetPosition(0);
 
                 auto context = GetContext();
                 auto& objManager = context->GetObjectManager();
                 auto importer = ParkImporter::CreateParkFile(context->GetObjectRepository());
 
-                auto loadResult = importer->LoadFromStream(&data.parkData, false);
+                auto loadResult = importer->LoadFromStream(&parkData, false);
                 objManager.LoadObjects(loadResult.RequiredObjects);
 
                 importer->Import();
@@ -531,7 +604,7 @@ namespace OpenRCT2
                 EntityTweener::Get().Reset();
 
                 // Load all map global variables.
-                DataSerialiser parkParamsDs(false, data.parkParams);
+                DataSerialiser parkParamsDs(false, parkParams);
                 SerialiseParkParameters(parkParamsDs);
 
                 game_load_init();
@@ -545,6 +618,47 @@ namespace OpenRCT2
             return true;
         }
 
+        void AddKeyframe()
+        {
+            auto& keyframe = _currentRecording->keyframes.emplace_back();
+            keyframe.tick = gCurrentTicks;
+
+            // Objects are only packed with the starting park, they are installed by the time a keyframe is restored.
+            auto exporter = std::make_unique<ParkFileExporter>();
+            exporter->Export(keyframe.parkData);
+
+            DataSerialiser parkParamsDs(true, keyframe.parkParams);
+            SerialiseParkParameters(parkParamsDs);
+        }
+
+        // Restores the given keyframe, or the starting park when there is none, and rewinds the commands and checksums.
+        bool RestoreKeyframe(ReplayKeyframe* keyframe)
+        {
+            auto& replay = *_currentReplay;
+            auto& parkData = keyframe != nullptr ? keyframe->parkData : replay.parkData;
+            auto& parkParams = keyframe != nullptr ? keyframe->parkParams : replay.parkParams;
+            if (!LoadReplayDataMap(parkData, parkParams))
+                return false;
+
+            gCurrentTicks = keyframe != nullptr ? keyframe->tick : replay.tickStart;
+            gGamePaused = 0;
+
+            ReplayCommand firstCommand;
+            firstCommand.tick = gCurrentTicks;
+            replay.nextCommand = replay.commands.lower_bound(firstCommand);
+
+            auto checksum = std::lower_bound(
+                replay.checksums.begin(), replay.checksums.end(), gCurrentTicks,
+                [](const std::pair<uint32_t, EntitiesChecksum>& entry, uint32_t value) { return entry.first < value; });
+            replay.checksumIndex = static_cast<uint32_t>(std::distance(replay.checksums.begin(), checksum));
+
+            if (_firstMismatch.has_value() && replay.tickStart + _firstMismatch->Tick >= gCurrentTicks)
+            {
+                _firstMismatch.reset();
+            }
+            return true;
+        }
+
         bool ReadReplayFromFile(const std::string& file, MemoryStream& stream)
         {
             FILE* fp = fopen(file.c_str(), "rb");
@@ -640,6 +754,11 @@ namespace OpenRCT2
             data.parkParams.SetPosition(0);
             data.cheatData.SetPosition(0);
             data.gameStateSnapshots.SetPosition(0);
+            for (auto& keyframe : data.keyframes)
+            {
+                keyframe.parkData.SetPosition(0);
+                keyframe.parkParams.SetPosition(0);
+            }
 
             return true;
         }
@@ -704,7 +823,8 @@ namespace OpenRCT2
 
         bool Compatible(ReplayRecordData& data)
         {
-            return data.version == ReplayVersion;
+            // Replays from before keyframes can still be played, seeking always starts at the beginning.
+            return data.version >= ReplayKeyframesVersion - 1 && data.version <= ReplayVersion;
         }
 
         bool Serialise(DataSerialiser& serialiser, ReplayRecordData& data)
@@ -777,6 +897,24 @@ namespace OpenRCT2
             }
 
             serialiser << data.gameStateSnapshots;
+
+            if (data.version >= ReplayKeyframesVersion)
+            {
+                uint32_t countKeyframes = static_cast<uint32_t>(data.keyframes.size());
+                serialiser << countKeyframes;
+
+                if (serialiser.IsLoading())
+                {
+                    data.keyframes.resize(countKeyframes);
+                }
+
+                for (auto& keyframe : data.keyframes)
+                {
+                    serialiser << keyframe.tick;
+                    serialiser << keyframe.parkData;
+                    serialiser << keyframe.parkParams;
+                }
+            }
             return true;
         }
 
@@ -803,7 +941,11 @@ namespace OpenRCT2
                         "Different sprite checksum at tick %u (Replay Tick: %u) ; Saved: %s, Current: %s", gCurrentTicks,
                         replayTick, savedChecksum.second.ToString().c_str(), checksum.ToString().c_str());
 
-                    _faultyChecksumIndex = checksumIndex;
+                    if (!_firstMismatch.has_value())
+                    {
+                        _firstMismatch = ReplayChecksumMismatch{ replayTick, savedChecksum.second.ToString(),
+                                                                 checksum.ToString() };
+                    }
                 }
                 else
                 {
@@ -819,10 +961,11 @@ namespace OpenRCT2
         void ReplayCommands()
         {
             auto& replayQueue = _currentReplay->commands;
+            auto& nextCommand = _currentReplay->nextCommand;
 
-            while (replayQueue.begin() != replayQueue.end())
+            while (nextCommand != replayQueue.end())
             {
-                const ReplayCommand& command = (*replayQueue.begin());
+                const ReplayCommand& command = *nextCommand;
 
                 if (_mode == ReplayMode::PLAYING)
                 {
@@ -841,24 +984,25 @@ namespace OpenRCT2
 
                 bool isPositionValid = false;
 
-                GameAction* action = command.action.get();
+                // Execute a copy, the recorded command is kept so that playback can seek back over it.
+                auto action = GameActions::Clone(command.action.get());
                 action->SetFlags(action->GetFlags() | GAME_COMMAND_FLAG_REPLAY);
 
-                GameActions::Result result = GameActions::Execute(action);
+                GameActions::Result result = GameActions::Execute(action.get());
                 if (result.Error == GameActions::Status::Ok)
                 {
                     isPositionValid = true;
                 }
 
                 // Focus camera on event.
-                if (isPositionValid && !result.Position.IsNull())
+                if (isPositionValid && !result.Position.IsNull() && !_seeking)
                 {
                     auto* mainWindow = window_get_main();
                     if (mainWindow != nullptr)
                         window_scroll_to_location(mainWindow, result.Position);
                 }
 
-                replayQueue.erase(replayQueue.begin());
+                ++nextCommand;
             }
         }
 
@@ -866,11 +1010,14 @@ namespace OpenRCT2
         ReplayMode _mode = ReplayMode::NONE;
         std::unique_ptr<ReplayRecordData> _currentRecording;
         std::unique_ptr<ReplayRecordData> _currentReplay;
-        int32_t _faultyChecksumIndex = -1;
+        std::optional<ReplayChecksumMismatch> _firstMismatch;
         uint32_t _commandId = 0;
         uint32_t _nextChecksumTick = 0;
+        uint32_t _nextKeyframeTick = 0;
+        uint32_t _keyframeTicks = KeyframeTicks;
         uint32_t _nextReplayTick = 0;
         RecordType _recordType = RecordType::NORMAL;
+        bool _seeking = false;
     };
 
     std::unique_ptr<IReplayManager> CreateReplayManager()
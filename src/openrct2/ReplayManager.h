@@ -12,6 +12,7 @@
 #include "common.h"
 
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 
@@ -28,10 +29,18 @@ namespace OpenRCT2
         uint64_t TimeRecorded;
         uint32_t NumCommands;
         uint32_t NumChecksums;
+        uint32_t NumKeyframes;
         std::string Name;
         std::string FilePath;
     };
 
+    struct ReplayChecksumMismatch
+    {
+        uint32_t Tick; // Ticks since the start of the replay.
+        std::string SavedChecksum;
+        std::string CurrentChecksum;
+    };
+
     struct IReplayManager
     {
     public:
@@ -60,6 +69,9 @@ namespace OpenRCT2
 
         virtual bool StartPlayback(const std::string& file) = 0;
         virtual bool IsPlaybackStateMismatching() const = 0;
+        virtual std::optional<ReplayChecksumMismatch> GetFirstChecksumMismatch() const = 0;
+        virtual bool SeekPlayback(uint32_t tick) = 0;
+        virtual void SetKeyframeInterval(uint32_t ticks) = 0;
         virtual bool StopPlayback() = 0;
 
         virtual bool NormaliseReplay(const std::string& inputFile, const std::string& outputFile) = 0;
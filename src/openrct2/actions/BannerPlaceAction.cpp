@@ -142,7 +142,8 @@ GameActions::Result BannerPlaceAction::Execute() const
     banner->position = TileCoordsXY(_loc);
 
     res.SetData(BannerPlaceActionResult{ banner->id });
-    auto* bannerElement = TileElementInsert<BannerElement>({ _loc, _loc.z + (2 * COORDS_Z_STEP) }, 0b0000);
+    auto* bannerElement = TileElementInsert<BannerElement>(
+        { _loc, _loc.z + (2 * COORDS_Z_STEP) }, 0b0000, GetFlags() & GAME_COMMAND_FLAG_GHOST);
     Guard::Assert(bannerElement != nullptr);
 
     bannerElement->SetClearanceZ(_loc.z + PATH_CLEARANCE);
@@ -122,7 +122,7 @@ GameActions::Result BannerRemoveAction::Execute() const
 
     reinterpret_cast<TileElement*>(bannerElement)->RemoveBannerEntry();
     map_invalidate_tile_zoom1({ _loc, _loc.z, _loc.z + 32 });
-    bannerElement->Remove();
+    bannerElement->Remove(_loc);
 
     return res;
 }
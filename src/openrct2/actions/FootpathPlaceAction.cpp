@@ -406,7 +406,7 @@ GameActions::Result FootpathPlaceAction::ElementInsertExecute(GameActions::Resul
     }
     else
     {
-        auto* pathElement = TileElementInsert<PathElement>(_loc, 0b1111);
+        auto* pathElement = TileElementInsert<PathElement>(_loc, 0b1111, GetFlags() & GAME_COMMAND_FLAG_GHOST);
         Guard::Assert(pathElement != nullptr);
 
         pathElement->SetClearanceZ(zHigh);
@@ -250,7 +250,7 @@ GameActions::Result FootpathPlaceFromTrackAction::ElementInsertExecute(GameActio
     }
     else
     {
-        auto* pathElement = TileElementInsert<PathElement>(_loc, 0b1111);
+        auto* pathElement = TileElementInsert<PathElement>(_loc, 0b1111, GetFlags() & GAME_COMMAND_FLAG_GHOST);
         Guard::Assert(pathElement != nullptr);
 
         pathElement->SetClearanceZ(zHigh);
@@ -17,7 +17,9 @@
 #include "../entity/MoneyEffect.h"
 #include "../localisation/Localisation.h"
 #include "../network/network.h"
+#include "../peep/PathfindingGraph.h"
 #include "../platform/platform.h"
+#include "../ride/ProximityIndex.h"
 #include "../scenario/Scenario.h"
 #include "../scripting/Duktape.hpp"
 #include "../scripting/HookEngine.h"
@@ -283,6 +285,58 @@ namespace GameActions
         network_append_server_log(text);
     }
 
+    // Actions that can change which paths connect, or where guests enter and leave rides and the park.
+    static bool ChangesFootpathNetwork(GameCommand type)
+    {
+        switch (type)
+        {
+            case GameCommand::PlacePath:
+            case GameCommand::PlacePathFromTrack:
+            case GameCommand::RemovePath:
+            case GameCommand::PlaceTrack:
+            case GameCommand::RemoveTrack:
+            case GameCommand::PlaceTrackDesign:
+            case GameCommand::SetMazeTrack:
+            case GameCommand::PlaceMazeDesign:
+            case GameCommand::PlaceRideEntranceOrExit:
+            case GameCommand::RemoveRideEntranceOrExit:
+            case GameCommand::PlaceParkEntrance:
+            case GameCommand::RemoveParkEntrance:
+            case GameCommand::DemolishRide:
+            case GameCommand::SetRideStatus:
+            case GameCommand::SetLandHeight:
+            case GameCommand::RaiseLand:
+            case GameCommand::LowerLand:
+            case GameCommand::EditLandSmooth:
+            case GameCommand::ClearScenery:
+            case GameCommand::ModifyTile:
+            case GameCommand::ChangeMapSize:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Actions that change land or water in place, the proximity index follows inserted and removed elements itself.
+    static bool ChangesLandOrWater(GameCommand type)
+    {
+        switch (type)
+        {
+            case GameCommand::SetLandHeight:
+            case GameCommand::RaiseLand:
+            case GameCommand::LowerLand:
+            case GameCommand::EditLandSmooth:
+            case GameCommand::SetWaterHeight:
+            case GameCommand::RaiseWater:
+            case GameCommand::LowerWater:
+            case GameCommand::ModifyTile:
+            case GameCommand::ChangeMapSize:
+                return true;
+            default:
+                return false;
+        }
+    }
+
     static GameActions::Result ExecuteInternal(const GameAction* action, bool topLevel)
     {
         Guard::ArgumentNotNull(action);
@@ -351,6 +405,22 @@ namespace GameActions
 
             // Execute the action, changing the game state
             result = action->Execute();
+            // Guests never walk on ghosts and the elements a ghost action inserts or removes
+            // invalidate their own surroundings, so provisional construction is left out.
+            if (result.Error == GameActions::Status::Ok && !(flags & GAME_COMMAND_FLAG_GHOST))
+            {
+                // These reach the footpath network in too many ways to track, from connecting
+                // neighbouring edges to rechaining whole queue lines.
+                if (ChangesFootpathNetwork(action->GetType()))
+                {
+                    PathfindingGraph::InvalidateAll();
+                    PathfindingGraph::InvalidateRoutes();
+                }
+                if (ChangesLandOrWater(action->GetType()))
+                {
+                    ProximityIndex::InvalidateAll();
+                }
+            }
 #ifdef ENABLE_SCRIPTING
             if (result.Error == GameActions::Status::Ok)
             {
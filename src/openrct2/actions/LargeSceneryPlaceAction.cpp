@@ -280,7 +280,8 @@ GameActions::Result LargeSceneryPlaceAction::Execute() const
         }
 
         auto* newSceneryElement = TileElementInsert<LargeSceneryElement>(
-            CoordsXYZ{ curTile.x, curTile.y, zLow }, quarterTile.GetBaseQuarterOccupied());
+            CoordsXYZ{ curTile.x, curTile.y, zLow }, quarterTile.GetBaseQuarterOccupied(),
+            GetFlags() & GAME_COMMAND_FLAG_GHOST);
         Guard::Assert(newSceneryElement != nullptr);
         newSceneryElement->SetClearanceZ(zHigh);
 
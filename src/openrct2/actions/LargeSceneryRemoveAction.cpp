@@ -175,7 +175,7 @@ GameActions::Result LargeSceneryRemoveAction::Execute() const
         if (sceneryElement != nullptr)
         {
             map_invalidate_tile_full(currentTile);
-            tile_element_remove(sceneryElement);
+            tile_element_remove(currentTile, sceneryElement);
         }
         else
         {
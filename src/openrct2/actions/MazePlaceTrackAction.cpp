@@ -165,7 +165,7 @@ GameActions::Result MazePlaceTrackAction::Execute() const
 
     auto startLoc = _loc.ToTileStart();
 
-    auto* trackElement = TileElementInsert<TrackElement>(_loc, 0b1111);
+    auto* trackElement = TileElementInsert<TrackElement>(_loc, 0b1111, GetFlags() & GAME_COMMAND_FLAG_GHOST);
     Guard::Assert(trackElement != nullptr);
 
     trackElement->SetClearanceZ(clearanceHeight);
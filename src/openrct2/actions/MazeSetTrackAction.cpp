@@ -179,7 +179,7 @@ GameActions::Result MazeSetTrackAction::Execute() const
 
         auto startLoc = _loc.ToTileStart();
 
-        auto* trackElement = TileElementInsert<TrackElement>(_loc, 0b1111);
+        auto* trackElement = TileElementInsert<TrackElement>(_loc, 0b1111, GetFlags() & GAME_COMMAND_FLAG_GHOST);
         Guard::Assert(trackElement != nullptr);
 
         trackElement->SetClearanceZ(_loc.z + MAZE_CLEARANCE_HEIGHT);
@@ -294,7 +294,7 @@ GameActions::Result MazeSetTrackAction::Execute() const
 
     if ((tileElement->AsTrack()->GetMazeEntry() & 0x8888) == 0x8888)
     {
-        tile_element_remove(tileElement);
+        tile_element_remove(_loc, tileElement);
         ride->ValidateStations();
         ride->maze_tiles--;
     }
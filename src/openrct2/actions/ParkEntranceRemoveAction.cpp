@@ -92,6 +92,6 @@ void ParkEntranceRemoveAction::ParkEntranceRemoveSegment(const CoordsXYZ& loc) c
     }
 
     map_invalidate_tile({ loc, entranceElement->GetBaseZ(), entranceElement->GetClearanceZ() });
-    entranceElement->Remove();
+    entranceElement->Remove(loc);
     update_park_fences({ loc.x, loc.y });
 }
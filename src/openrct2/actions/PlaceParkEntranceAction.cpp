@@ -137,7 +137,8 @@ GameActions::Result PlaceParkEntranceAction::Execute() const
             }
         }
 
-        auto* entranceElement = TileElementInsert<EntranceElement>(CoordsXYZ{ entranceLoc, zLow }, 0b1111);
+        auto* entranceElement = TileElementInsert<EntranceElement>(
+            CoordsXYZ{ entranceLoc, zLow }, 0b1111, GetFlags() & GAME_COMMAND_FLAG_GHOST);
         Guard::Assert(entranceElement != nullptr);
 
         entranceElement->SetClearanceZ(zHigh);
@@ -179,7 +179,8 @@ GameActions::Result RideEntranceExitPlaceAction::Execute() const
     res.Position = { _loc.ToTileCentre(), z };
     res.Expenditure = ExpenditureType::RideConstruction;
 
-    auto* entranceElement = TileElementInsert<EntranceElement>(CoordsXYZ{ _loc, z }, 0b1111);
+    auto* entranceElement = TileElementInsert<EntranceElement>(
+        CoordsXYZ{ _loc, z }, 0b1111, GetFlags() & GAME_COMMAND_FLAG_GHOST);
     Guard::Assert(entranceElement != nullptr);
 
     entranceElement->SetDirection(_direction);
@@ -240,6 +240,16 @@ GameActions::Result ScenarioSetSettingAction::Execute() const
         case ScenarioSetSetting::AllowEarlyCompletion:
             gAllowEarlyCompletionInNetworkPlay = _value;
             break;
+        case ScenarioSetSetting::SharedGuestRoutes:
+            if (_value != 0)
+            {
+                gParkFlags |= PARK_FLAGS_SHARED_GUEST_ROUTES;
+            }
+            else
+            {
+                gParkFlags &= ~PARK_FLAGS_SHARED_GUEST_ROUTES;
+            }
+            break;
         default:
             log_error("Invalid setting: %u", _setting);
             return GameActions::Result(GameActions::Status::InvalidParameters, STR_NONE, STR_NONE);
@@ -405,7 +405,7 @@ GameActions::Result SmallSceneryPlaceAction::Execute() const
     res.Cost = (sceneryEntry->price * 10) + canBuild.Cost;
 
     auto* sceneryElement = TileElementInsert<SmallSceneryElement>(
-        CoordsXYZ{ _loc, zLow }, quarterTile.GetBaseQuarterOccupied());
+        CoordsXYZ{ _loc, zLow }, quarterTile.GetBaseQuarterOccupied(), GetFlags() & GAME_COMMAND_FLAG_GHOST);
     if (sceneryElement == nullptr)
     {
         return GameActions::Result(
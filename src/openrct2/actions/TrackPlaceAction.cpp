@@ -585,7 +585,8 @@ GameActions::Result TrackPlaceAction::Execute() const
             ride->overall_view = mapLoc;
         }
 
-        auto* trackElement = TileElementInsert<TrackElement>(mapLoc, quarterTile.GetBaseQuarterOccupied());
+        auto* trackElement = TileElementInsert<TrackElement>(
+            mapLoc, quarterTile.GetBaseQuarterOccupied(), GetFlags() & GAME_COMMAND_FLAG_GHOST);
         if (trackElement == nullptr)
         {
             log_warning("Cannot create track element for ride = %d", EnumValue(_rideIndex));
@@ -428,7 +428,7 @@ GameActions::Result TrackRemoveAction::Execute() const
         {
             footpath_remove_edges_at(mapLoc, tileElement);
         }
-        tile_element_remove(tileElement);
+        tile_element_remove(mapLoc, tileElement);
         ride->ValidateStations();
         if (!(GetFlags() & GAME_COMMAND_FLAG_GHOST))
         {
@@ -355,7 +355,7 @@ GameActions::Result WallPlaceAction::Execute() const
         }
     }
 
-    auto* wallElement = TileElementInsert<WallElement>(targetLoc, 0b0000);
+    auto* wallElement = TileElementInsert<WallElement>(targetLoc, 0b0000, GetFlags() & GAME_COMMAND_FLAG_GHOST);
     if (wallElement == nullptr)
     {
         return GameActions::Result(
@@ -0,0 +1,226 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../core/JobPool.h"
+
+#    include <benchmark/benchmark.h>
+#    include <condition_variable>
+#    include <cstdint>
+#    include <deque>
+#    include <functional>
+#    include <mutex>
+#    include <thread>
+#    include <vector>
+
+/**
+ * The scheduler JobPool used before it switched to work stealing: one deque of std::function
+ * behind a single mutex. Kept here as the reference the new scheduler is measured against.
+ */
+class MutexJobPool
+{
+private:
+    bool _shouldStop = false;
+    size_t _processing = 0;
+    std::vector<std::thread> _threads;
+    std::deque<std::function<void()>> _pending;
+    std::condition_variable _condPending;
+    std::condition_variable _condComplete;
+    std::mutex _mutex;
+
+public:
+    MutexJobPool(size_t numThreads)
+    {
+        for (size_t n = 0; n < numThreads; n++)
+        {
+            _threads.emplace_back(&MutexJobPool::ProcessQueue, this);
+        }
+    }
+
+    ~MutexJobPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _shouldStop = true;
+            _condPending.notify_all();
+        }
+        for (auto& th : _threads)
+        {
+            th.join();
+        }
+    }
+
+    void AddTask(std::function<void()> workFn)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _pending.push_back(std::move(workFn));
+        _condPending.notify_one();
+    }
+
+    void Join()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condComplete.wait(lock, [this]() { return _pending.empty() && _processing == 0; });
+    }
+
+private:
+    void ProcessQueue()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _condPending.wait(lock, [this]() { return _shouldStop || !_pending.empty(); });
+            if (_pending.empty())
+            {
+                break;
+            }
+
+            auto workFn = std::move(_pending.front());
+            _pending.pop_front();
+            _processing++;
+            lock.unlock();
+
+            workFn();
+
+            lock.lock();
+            _processing--;
+            _condComplete.notify_all();
+        }
+    }
+};
+
+// Stand-in for filling one 32px viewport column, roughly the cost of an empty column.
+static void SimulateColumn(uint32_t* column, int64_t work)
+{
+    for (int64_t i = 0; i < work; i++)
+    {
+        column[i & 31] += static_cast<uint32_t>(i);
+    }
+    benchmark::DoNotOptimize(column);
+}
+
+template<typename TPool> static void BM_schedule_columns(benchmark::State& state)
+{
+    const auto numColumns = static_cast<size_t>(state.range(0));
+    const int64_t work = state.range(1);
+    std::vector<uint32_t> columns(numColumns * 32);
+
+    TPool pool(JobPool::GetDefaultWorkerCount());
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < numColumns; i++)
+        {
+            uint32_t* column = &columns[i * 32];
+            pool.AddTask([column, work]() { SimulateColumn(column, work); });
+        }
+        pool.Join();
+    }
+    state.SetItemsProcessed(state.iterations() * numColumns);
+    state.counters["ns_per_column"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * numColumns),
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+static void BM_parallel_for_columns(benchmark::State& state)
+{
+    const auto numColumns = static_cast<size_t>(state.range(0));
+    const int64_t work = state.range(1);
+    std::vector<uint32_t> columns(numColumns * 32);
+
+    JobPool pool;
+    for (auto _ : state)
+    {
+        pool.ParallelFor(numColumns, 1, [&columns, work](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+            {
+                SimulateColumn(&columns[i * 32], work);
+            }
+        });
+    }
+    state.SetItemsProcessed(state.iterations() * numColumns);
+    state.counters["ns_per_column"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * numColumns),
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// Column counts for 1080p, 4K and a zoomed out 4K viewport, with an empty and a busy column.
+static void ColumnArguments(benchmark::internal::Benchmark* b)
+{
+    for (int64_t columns : { 60, 120, 480 })
+    {
+        for (int64_t work : { 0, 2000 })
+        {
+            b->Args({ columns, work });
+        }
+    }
+    b->ArgNames({ "columns", "work" });
+}
+
+static int CmdlineForBenchJobPool(int argc, const char* const* argv)
+{
+    benchmark::RegisterBenchmark("mutex_pool", BM_schedule_columns<MutexJobPool>)->Apply(ColumnArguments);
+    benchmark::RegisterBenchmark("job_pool", BM_schedule_columns<JobPool>)->Apply(ColumnArguments);
+    benchmark::RegisterBenchmark("job_pool_parallel_for", BM_parallel_for_columns)->Apply(ColumnArguments);
+
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+    for (int i = 0; i < argc; i++)
+    {
+        argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+    }
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchJobPool(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = CmdlineForBenchJobPool(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchJobPool(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchJobPoolCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "[--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchJobPool),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchJobPool), CommandTableEnd
+#endif // USE_BENCHMARK
+};
@@ -0,0 +1,218 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#if defined(USE_BENCHMARK) && !defined(DISABLE_NETWORK)
+
+#    include "../Game.h"
+#    include "../network/NetworkConnection.h"
+#    include "../network/Socket.h"
+
+#    include <benchmark/benchmark.h>
+#    include <chrono>
+#    include <cstdint>
+#    include <thread>
+#    include <vector>
+
+static uint16_t _benchPort = 11800;
+
+/**
+ * Two connections talking to each other over a loopback socket, standing in for a server and one of its clients.
+ */
+struct LoopbackConnections
+{
+    NetworkConnection Server;
+    NetworkConnection Client;
+};
+
+static bool CreateLoopbackConnections(LoopbackConnections& connections, bool frames)
+{
+    // Use a fresh port for every run, the previous one may still linger.
+    const uint16_t port = _benchPort++;
+    try
+    {
+        auto listenSocket = CreateTcpSocket();
+        listenSocket->Listen("127.0.0.1", port);
+        connections.Client.Socket = CreateTcpSocket();
+        connections.Client.Socket->Connect("127.0.0.1", port);
+        for (int32_t i = 0; i < 1000 && connections.Server.Socket == nullptr; i++)
+        {
+            connections.Server.Socket = listenSocket->Accept();
+            if (connections.Server.Socket == nullptr)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    if (connections.Server.Socket == nullptr)
+    {
+        return false;
+    }
+
+    for (auto* connection : { &connections.Server, &connections.Client })
+    {
+        connection->AuthStatus = NetworkAuth::Ok;
+        connection->FramesEnabled = frames;
+        connection->FramesAccepted = frames;
+    }
+    return true;
+}
+
+// Roughly what a serialised footpath or scenery placement looks like.
+static NetworkPacket CreateGameActionPacket(uint32_t tick, uint32_t index)
+{
+    NetworkPacket packet(NetworkCommand::GameAction);
+    packet << tick << static_cast<uint32_t>(GameCommand::PlacePath);
+    packet << static_cast<uint32_t>(0) << static_cast<uint32_t>(index) << static_cast<uint8_t>(index % 16);
+    packet << static_cast<int32_t>(32 * (index % 64)) << static_cast<int32_t>(32 * (index / 64)) << static_cast<int32_t>(112);
+    packet << static_cast<uint8_t>(index & 3) << static_cast<uint16_t>(1) << static_cast<uint8_t>(0);
+    return packet;
+}
+
+// Sends everything queued on the sender while draining the receiver, returns false if the packets never arrive.
+static bool Transfer(NetworkConnection& sender, NetworkConnection& receiver, size_t numPackets)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    size_t numReceived = 0;
+    while (numReceived < numPackets)
+    {
+        sender.SendQueuedPackets();
+        auto status = receiver.ReadPacket();
+        if (status == NetworkReadPacket::Success)
+        {
+            receiver.InboundPacket.Clear();
+            numReceived++;
+        }
+        else if (status == NetworkReadPacket::Disconnected)
+        {
+            return false;
+        }
+        else if (std::chrono::steady_clock::now() - startTime > std::chrono::seconds(5))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * One server flush with a number of game actions and a tick, answered by a heartbeat from the client. The time per
+ * iteration is the round trip, the counters show how many bytes each flush took on the wire.
+ */
+static void BM_network_flush(benchmark::State& state, bool frames)
+{
+    LoopbackConnections connections;
+    if (!CreateLoopbackConnections(connections, frames))
+    {
+        state.SkipWithError("Unable to open loopback connection.");
+        return;
+    }
+
+    const auto numActions = static_cast<uint32_t>(state.range(0));
+    uint32_t tick = 0;
+    for (auto _ : state)
+    {
+        for (uint32_t i = 0; i < numActions; i++)
+        {
+            connections.Server.QueuePacket(CreateGameActionPacket(tick, i));
+        }
+        NetworkPacket tickPacket(NetworkCommand::Tick);
+        tickPacket << tick << static_cast<uint32_t>(0x12345678) << static_cast<uint32_t>(0);
+        connections.Server.QueuePacket(std::move(tickPacket));
+        if (!Transfer(connections.Server, connections.Client, numActions + 1))
+        {
+            state.SkipWithError("Packets were not received.");
+            return;
+        }
+
+        connections.Client.QueuePacket(NetworkPacket(NetworkCommand::Heartbeat));
+        if (!Transfer(connections.Client, connections.Server, 1))
+        {
+            state.SkipWithError("Packets were not received.");
+            return;
+        }
+        tick++;
+    }
+
+    const auto total = EnumValue(NetworkStatisticsGroup::Total);
+    state.counters["bytes_per_flush"] = benchmark::Counter(
+        static_cast<double>(connections.Server.Stats.bytesSent[total]), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * (numActions + 1));
+}
+
+static int CmdlineForBenchNetwork(int argc, const char* const* argv)
+{
+    for (bool frames : { false, true })
+    {
+        benchmark::RegisterBenchmark(frames ? "loopback/frames" : "loopback/packets", BM_network_flush, frames)
+            ->Arg(1)
+            ->Arg(16)
+            ->Arg(64)
+            ->Arg(256)
+            ->ArgName("actions");
+    }
+
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+    for (int i = 0; i < argc; i++)
+    {
+        argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+    }
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchNetwork(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = CmdlineForBenchNetwork(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchNetwork(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark or networking not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK && !DISABLE_NETWORK
+
+const CommandLineCommand CommandLine::BenchNetworkCommands[]{
+#if defined(USE_BENCHMARK) && !defined(DISABLE_NETWORK)
+    DefineCommand(
+        "",
+        "[--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchNetwork),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchNetwork), CommandTableEnd
+#endif // USE_BENCHMARK && !DISABLE_NETWORK
+};
@@ -0,0 +1,161 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../Context.h"
+#    include "../OpenRCT2.h"
+#    include "../ParkFile.h"
+#    include "../core/MemoryStream.h"
+#    include "../core/OrcaStream.hpp"
+#    include "../object/ObjectManager.h"
+#    include "../platform/Platform2.h"
+#    include "../platform/platform.h"
+
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <string>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+static bool LoadBenchmarkPark(benchmark::State& state, std::unique_ptr<IContext>& context, const std::string& filename)
+{
+    context = CreateContext();
+    if (!context->Initialise())
+    {
+        state.SkipWithError("Context initialization failed.");
+        return false;
+    }
+    if (!context->LoadParkFromFile(filename))
+    {
+        state.SkipWithError("Failed to load file!");
+        return false;
+    }
+    return true;
+}
+
+static MemoryStream SavePark(IContext& context, uint32_t compression)
+{
+    MemoryStream stream;
+    ParkFileExporter exporter;
+    exporter.ExportObjectsList = context.GetObjectManager().GetPackableObjects();
+    exporter.Compression = compression;
+    exporter.Export(stream);
+    return stream;
+}
+
+static void BM_park_save(benchmark::State& state, const std::string& filename, uint32_t compression)
+{
+    std::unique_ptr<IContext> context;
+    if (!LoadBenchmarkPark(state, context, filename))
+        return;
+
+    uint64_t size = 0;
+    for (auto _ : state)
+    {
+        auto stream = SavePark(*context, compression);
+        size = stream.GetLength();
+    }
+    state.counters["file_size"] = static_cast<double>(size);
+}
+
+static void BM_park_load(benchmark::State& state, const std::string& filename, uint32_t compression)
+{
+    std::unique_ptr<IContext> context;
+    if (!LoadBenchmarkPark(state, context, filename))
+        return;
+
+    auto saved = SavePark(*context, compression);
+    for (auto _ : state)
+    {
+        // Only the container is read, the chunks are not imported into the game state.
+        saved.SetPosition(0);
+        OrcaStream os(saved, OrcaStream::Mode::READING);
+        benchmark::DoNotOptimize(os.GetHeader());
+    }
+    state.counters["file_size"] = static_cast<double>(saved.GetLength());
+}
+
+static int CmdlineForBenchParkFile(int argc, const char* const* argv)
+{
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+
+    // Extract file names from argument list. If there is no such file, consider it benchmark option.
+    for (int i = 0; i < argc; i++)
+    {
+        if (Platform::FileExists(argv[i]))
+        {
+            const std::string name = argv[i];
+            benchmark::RegisterBenchmark((name + "/save/gzip").c_str(), BM_park_save, name, OrcaStream::COMPRESSION_GZIP);
+            benchmark::RegisterBenchmark(
+                (name + "/save/gzip_blocks").c_str(), BM_park_save, name, OrcaStream::COMPRESSION_GZIP_BLOCKS);
+            benchmark::RegisterBenchmark((name + "/load/gzip").c_str(), BM_park_load, name, OrcaStream::COMPRESSION_GZIP);
+            benchmark::RegisterBenchmark(
+                (name + "/load/gzip_blocks").c_str(), BM_park_load, name, OrcaStream::COMPRESSION_GZIP_BLOCKS);
+        }
+        else
+        {
+            argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+        }
+    }
+    // Update argc with all the changes made
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+
+    core_init();
+    gOpenRCT2Headless = true;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchParkFile(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = CmdlineForBenchParkFile(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchParkFile(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchParkFileCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "<file>... [--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchParkFile),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchParkFile), CommandTableEnd
+#endif // USE_BENCHMARK
+};
@@ -0,0 +1,158 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../Context.h"
+#    include "../OpenRCT2.h"
+#    include "../entity/EntityList.h"
+#    include "../entity/Guest.h"
+#    include "../peep/GuestPathfinding.h"
+#    include "../peep/PathfindingGraph.h"
+#    include "../platform/Platform2.h"
+#    include "../platform/platform.h"
+#    include "../world/Entrance.h"
+
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <string>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+enum class PathfindingGraphState
+{
+    // Every decision walks the neighbouring tiles, as without the graph.
+    Disabled,
+    // The graph is dropped before every round, each node is worked out once per round.
+    Cold,
+    // The graph is kept between rounds, as between ticks of a park nobody is building in.
+    Warm,
+};
+
+static void BM_pathfinding(benchmark::State& state, const std::string& filename, PathfindingGraphState graphState)
+{
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        state.SkipWithError("Context initialization failed.");
+        return;
+    }
+    if (!context->LoadParkFromFile(filename))
+    {
+        state.SkipWithError("Failed to load file!");
+        return;
+    }
+    if (gParkEntrances.empty())
+    {
+        state.SkipWithError("Park has no entrance.");
+        return;
+    }
+
+    // Every guest heads for the first park entrance, the same search guests leaving the park do.
+    gPeepPathFindGoalPosition = TileCoordsXYZ{ CoordsXYZ{ gParkEntrances[0] } };
+    gPeepPathFindIgnoreForeignQueues = true;
+    gPeepPathFindQueueRideIndex = RIDE_ID_NULL;
+
+    PathfindingGraph::SetEnabled(graphState != PathfindingGraphState::Disabled);
+
+    int64_t numDecisions = 0;
+    for (auto _ : state)
+    {
+        if (graphState == PathfindingGraphState::Cold)
+        {
+            state.PauseTiming();
+            PathfindingGraph::InvalidateAll();
+            state.ResumeTiming();
+        }
+
+        for (auto* guest : EntityList<Guest>())
+        {
+            benchmark::DoNotOptimize(peep_pathfind_choose_direction(TileCoordsXYZ{ guest->NextLoc }, guest));
+            numDecisions++;
+        }
+    }
+    state.SetItemsProcessed(numDecisions);
+
+    PathfindingGraph::SetEnabled(true);
+}
+
+static int CmdlineForBenchPathfinding(int argc, const char* const* argv)
+{
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+
+    // Extract file names from argument list. If there is no such file, consider it benchmark option.
+    for (int i = 0; i < argc; i++)
+    {
+        if (Platform::FileExists(argv[i]))
+        {
+            const std::string name = argv[i];
+            benchmark::RegisterBenchmark((name + "/no_graph").c_str(), BM_pathfinding, name, PathfindingGraphState::Disabled);
+            benchmark::RegisterBenchmark((name + "/cold").c_str(), BM_pathfinding, name, PathfindingGraphState::Cold);
+            benchmark::RegisterBenchmark((name + "/warm").c_str(), BM_pathfinding, name, PathfindingGraphState::Warm);
+        }
+        else
+        {
+            argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+        }
+    }
+    // Update argc with all the changes made
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+
+    core_init();
+    gOpenRCT2Headless = true;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchPathfinding(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = CmdlineForBenchPathfinding(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchPathfinding(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchPathfindingCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "<file>... [--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchPathfinding),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchPathfinding), CommandTableEnd
+#endif // USE_BENCHMARK
+};
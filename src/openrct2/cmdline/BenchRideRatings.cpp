@@ -0,0 +1,150 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../Context.h"
+#    include "../OpenRCT2.h"
+#    include "../core/JobPool.h"
+#    include "../platform/Platform2.h"
+#    include "../platform/platform.h"
+#    include "../ride/ProximityIndex.h"
+#    include "../ride/Ride.h"
+#    include "../ride/RideRatings.h"
+
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <string>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+enum class ProximityIndexState
+{
+    // The proximity index is cleared before every round, every tile is looked at from scratch.
+    Cold,
+    // The proximity index is kept as it is between ticks.
+    Warm,
+};
+
+static void BM_ride_ratings(
+    benchmark::State& state, const std::string& filename, ProximityIndexState indexState, bool parallel)
+{
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        state.SkipWithError("Context initialization failed.");
+        return;
+    }
+    if (!context->LoadParkFromFile(filename))
+    {
+        state.SkipWithError("Failed to load file!");
+        return;
+    }
+
+    std::unique_ptr<JobPool> jobPool;
+    if (parallel)
+    {
+        jobPool = std::make_unique<JobPool>();
+    }
+
+    // Fill the proximity index once so warm runs start warm.
+    ride_ratings_update_rides(jobPool.get());
+
+    int64_t numRides = 0;
+    for (auto _ : state)
+    {
+        if (indexState == ProximityIndexState::Cold)
+        {
+            state.PauseTiming();
+            ProximityIndex::InvalidateAll();
+            state.ResumeTiming();
+        }
+
+        ride_ratings_update_rides(jobPool.get());
+        numRides += ride_get_count();
+    }
+    state.SetItemsProcessed(numRides);
+    state.counters["rides"] = static_cast<double>(ride_get_count());
+}
+
+static int CmdlineForBenchRideRatings(int argc, const char* const* argv)
+{
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+
+    // Extract file names from argument list. If there is no such file, consider it benchmark option.
+    for (int i = 0; i < argc; i++)
+    {
+        if (Platform::FileExists(argv[i]))
+        {
+            const std::string name = argv[i];
+            benchmark::RegisterBenchmark((name + "/cold").c_str(), BM_ride_ratings, name, ProximityIndexState::Cold, false);
+            benchmark::RegisterBenchmark((name + "/warm").c_str(), BM_ride_ratings, name, ProximityIndexState::Warm, false);
+            benchmark::RegisterBenchmark(
+                (name + "/warm_parallel").c_str(), BM_ride_ratings, name, ProximityIndexState::Warm, true);
+        }
+        else
+        {
+            argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+        }
+    }
+    // Update argc with all the changes made
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+
+    core_init();
+    gOpenRCT2Headless = true;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchRideRatings(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = CmdlineForBenchRideRatings(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchRideRatings(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchRideRatingsCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "<file>... [--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchRideRatings),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchRideRatings), CommandTableEnd
+#endif // USE_BENCHMARK
+};
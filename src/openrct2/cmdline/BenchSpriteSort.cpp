@@ -32,6 +32,9 @@
 #    include <benchmark/benchmark.h>
 #    include <cstdint>
 #    include <iterator>
+#    include <limits>
+#    include <random>
+#    include <string>
 #    include <vector>
 
 static void fixup_pointers(std::vector<RecordedPaintSession>& s)
@@ -135,8 +138,94 @@ static std::vector<RecordedPaintSession> extract_paint_session(std::string_view
     return sessions;
 }
 
+/**
+ * Creates sessions like those recorded for the columns of a densely built park, with every tile holding
+ * structsPerTile paint structs at various heights. A fixed seed keeps runs comparable.
+ */
+static std::vector<RecordedPaintSession> create_dense_paint_sessions(uint32_t structsPerTile)
+{
+    constexpr size_t numColumns = 16;
+    constexpr int32_t numRows = 64;
+    constexpr int32_t tilesPerRow = 2;
+    constexpr int32_t firstTile = 8;
+
+    std::mt19937 prng(structsPerTile);
+    std::vector<RecordedPaintSession> sessions(numColumns);
+    for (auto& recordedSession : sessions)
+    {
+        auto& session = recordedSession.Session;
+        std::fill(std::begin(session.Quadrants), std::end(session.Quadrants), reinterpret_cast<paint_struct*>(-1));
+        session.PaintHead = {};
+        session.QuadrantBackIndex = std::numeric_limits<uint32_t>::max();
+        session.QuadrantFrontIndex = 0;
+        session.CurrentRotation = 0;
+
+        // A column crosses a couple of tiles on every diagonal row of the map, rows are the quadrants of rotation 0.
+        recordedSession.Entries.resize(numRows * tilesPerRow * structsPerTile);
+        size_t entryIndex = 0;
+        for (int32_t row = 0; row < numRows; row++)
+        {
+            for (int32_t tile = 0; tile < tilesPerRow; tile++)
+            {
+                const auto tileX = (firstTile + row / 2 + tile) * COORDS_XY_STEP;
+                const auto tileY = (firstTile + row - row / 2 - tile) * COORDS_XY_STEP;
+                const auto baseZ = static_cast<int32_t>(prng() % 16) * COORDS_Z_STEP * 2;
+                for (uint32_t i = 0; i < structsPerTile; i++)
+                {
+                    auto& ps = recordedSession.Entries[entryIndex].basic;
+                    ps.bounds.x = tileX + static_cast<int32_t>(prng() % COORDS_XY_STEP);
+                    ps.bounds.y = tileY + static_cast<int32_t>(prng() % COORDS_XY_STEP);
+                    ps.bounds.z = baseZ + static_cast<int32_t>(prng() % 8) * COORDS_Z_STEP;
+                    ps.bounds.x_end = ps.bounds.x + static_cast<int32_t>(prng() % COORDS_XY_STEP);
+                    ps.bounds.y_end = ps.bounds.y + static_cast<int32_t>(prng() % COORDS_XY_STEP);
+                    ps.bounds.z_end = ps.bounds.z + static_cast<int32_t>(prng() % 64);
+
+                    const auto quadrantIndex = static_cast<uint32_t>((ps.bounds.x + ps.bounds.y) / COORDS_XY_STEP);
+                    ps.quadrant_index = static_cast<uint16_t>(quadrantIndex);
+                    ps.next_quadrant_ps = session.Quadrants[quadrantIndex];
+                    session.Quadrants[quadrantIndex] = reinterpret_cast<paint_struct*>(entryIndex * sizeof(paint_entry));
+                    session.QuadrantBackIndex = std::min(session.QuadrantBackIndex, quadrantIndex);
+                    session.QuadrantFrontIndex = std::max(session.QuadrantFrontIndex, quadrantIndex);
+                    entryIndex++;
+                }
+            }
+        }
+    }
+    return sessions;
+}
+
+static std::vector<size_t> get_drawing_order(const RecordedPaintSession& session)
+{
+    std::vector<size_t> order;
+    for (auto* ps = session.Session.PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+    {
+        order.push_back(reinterpret_cast<const paint_entry*>(ps) - session.Entries.data());
+    }
+    return order;
+}
+
+// Both sorting methods have to put the recorded sessions into the same order.
+static bool check_sorting_methods_agree(const std::vector<RecordedPaintSession>& inputSessions)
+{
+    auto linkedSessions = inputSessions;
+    auto compactSessions = inputSessions;
+    fixup_pointers(linkedSessions);
+    fixup_pointers(compactSessions);
+    for (size_t i = 0; i < inputSessions.size(); i++)
+    {
+        PaintSessionArrange(&linkedSessions[i].Session, PaintSortMethod::Linked);
+        PaintSessionArrange(&compactSessions[i].Session, PaintSortMethod::Compact);
+        if (get_drawing_order(linkedSessions[i]) != get_drawing_order(compactSessions[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 // This function is based on benchgfx_render_screenshots
-static void BM_paint_session_arrange(benchmark::State& state, const std::vector<RecordedPaintSession> inputSessions)
+static void BM_paint_session_arrange(
+    benchmark::State& state, const std::vector<RecordedPaintSession> inputSessions, PaintSortMethod method)
 {
     auto sessions = inputSessions;
     // Fixing up the pointers continuously is wasteful. Fix it up once for `sessions` and store a copy.
@@ -150,13 +239,26 @@ static void BM_paint_session_arrange(benchmark::State& state, const std::vector<
         state.PauseTiming();
         std::copy_n(local_s, std::size(sessions), sessions.begin());
         state.ResumeTiming();
-        PaintSessionArrange(&sessions[0].Session);
+        for (auto& session : sessions)
+        {
+            PaintSessionArrange(&session.Session, method);
+        }
         benchmark::DoNotOptimize(sessions);
     }
     state.SetItemsProcessed(state.iterations() * std::size(sessions));
     delete[] local_s;
 }
 
+static void register_sorting_benchmarks(const std::string& name, const std::vector<RecordedPaintSession>& sessions)
+{
+    if (!check_sorting_methods_agree(sessions))
+    {
+        log_error("%s: linked and compact sorting give a different drawing order.", name.c_str());
+    }
+    benchmark::RegisterBenchmark((name + "/linked").c_str(), BM_paint_session_arrange, sessions, PaintSortMethod::Linked);
+    benchmark::RegisterBenchmark((name + "/compact").c_str(), BM_paint_session_arrange, sessions, PaintSortMethod::Compact);
+}
+
 static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
 {
     {
@@ -170,7 +272,13 @@ static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
         {
             quad = reinterpret_cast<paint_struct*>(-1);
         }
-        benchmark::RegisterBenchmark("baseline", BM_paint_session_arrange, sessions);
+        benchmark::RegisterBenchmark("baseline", BM_paint_session_arrange, sessions, PaintSortMethod::Auto);
+    }
+
+    // Synthetic dense parks, from a few structs per tile up to heavily themed areas.
+    for (uint32_t structsPerTile : { 4, 16, 48, 96 })
+    {
+        register_sorting_benchmarks("dense/" + std::to_string(structsPerTile), create_dense_paint_sessions(structsPerTile));
     }
 
     // Google benchmark does stuff to argv. It doesn't modify the pointees,
@@ -188,7 +296,7 @@ static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
             // Register benchmark for sv6 if valid
             std::vector<RecordedPaintSession> sessions = extract_paint_session(argv[i]);
             if (!sessions.empty())
-                benchmark::RegisterBenchmark(argv[i], BM_paint_session_arrange, sessions);
+                register_sorting_benchmarks(argv[i], sessions);
         }
         else
         {
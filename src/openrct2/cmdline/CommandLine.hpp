@@ -119,7 +119,14 @@ namespace CommandLine
     extern const CommandLineCommand BenchGfxCommands[];
     extern const CommandLineCommand BenchSpriteSortCommands[];
     extern const CommandLineCommand BenchUpdateCommands[];
+    extern const CommandLineCommand BenchJobPoolCommands[];
+    extern const CommandLineCommand BenchRideRatingsCommands[];
+    extern const CommandLineCommand BenchParkFileCommands[];
+    extern const CommandLineCommand BenchNetworkCommands[];
+    extern const CommandLineCommand BenchPathfindingCommands[];
     extern const CommandLineCommand SimulateCommands[];
+    extern const CommandLineCommand SimulateBatchCommands[];
+    extern const CommandLineCommand ReplayCommands[];
 
     extern const CommandLineExample RootExamples[];
 
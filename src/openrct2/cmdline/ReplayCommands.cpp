@@ -0,0 +1,306 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../Context.h"
+#include "../Game.h"
+#include "../GameState.h"
+#include "../GameStateSnapshots.h"
+#include "../OpenRCT2.h"
+#include "../ReplayManager.h"
+#include "../core/Console.hpp"
+#include "../core/MemoryStream.h"
+#include "../entity/EntityRegistry.h"
+#include "../platform/platform.h"
+#include "../scenario/Scenario.h"
+#include "CommandLine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace OpenRCT2;
+
+static int32_t _replaySeekTick = 0;
+static bool _replayKeepGoing = false;
+
+static exitcode_t HandleReplay(CommandLineArgEnumerator* argEnumerator);
+static exitcode_t HandleReplayCompare(CommandLineArgEnumerator* argEnumerator);
+
+// clang-format off
+static constexpr const CommandLineOptionDefinition ReplayOptions[]
+{
+    { CMDLINE_TYPE_INTEGER, &_replaySeekTick,  NAC, "seek",       "start playing at the given tick of the replay" },
+    { CMDLINE_TYPE_SWITCH,  &_replayKeepGoing, NAC, "keep-going", "keep playing after the first checksum mismatch" },
+    OptionTableEnd
+};
+// clang-format on
+
+const CommandLineCommand CommandLine::ReplayCommands[]{
+    DefineCommand("compare", "<file> <other_file>", nullptr, HandleReplayCompare),
+    DefineCommand("", "<file>", ReplayOptions, HandleReplay),
+    CommandTableEnd
+};
+
+/**
+ * Plays a replay without drawing or waiting for the frame rate, then reports how fast it went and the first tick at
+ * which the game state no longer matched the recorded checksums.
+ */
+static exitcode_t HandleReplay(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 1 || argv[0][0] == '-')
+    {
+        Console::Error::WriteLine("Missing argument <file>.");
+        return EXITCODE_FAIL;
+    }
+
+    core_init();
+
+    const char* inputPath = argv[0];
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+
+    auto* replayManager = context->GetReplayManager();
+    if (!replayManager->StartPlayback(inputPath))
+    {
+        Console::Error::WriteLine("Unable to start replay '%s'.", inputPath);
+        return EXITCODE_FAIL;
+    }
+
+    ReplayRecordInfo info;
+    replayManager->GetCurrentReplayInfo(info);
+    Console::WriteLine("Replaying %s: %u ticks, %u keyframes", info.FilePath.c_str(), info.Ticks, info.NumKeyframes);
+
+    auto* gameState = context->GetGameState();
+    const auto seekStartTime = std::chrono::high_resolution_clock::now();
+    if (_replaySeekTick > 0)
+    {
+        if (!replayManager->SeekPlayback(_replaySeekTick))
+        {
+            Console::Error::WriteLine("Unable to seek to tick %d.", _replaySeekTick);
+            return EXITCODE_FAIL;
+        }
+        const std::chrono::duration<double> seekTime = std::chrono::high_resolution_clock::now() - seekStartTime;
+        Console::WriteLine("Moved to tick %d in %.3f s", _replaySeekTick, seekTime.count());
+    }
+
+    const uint32_t startTick = gCurrentTicks;
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    while (replayManager->IsReplaying())
+    {
+        gameState->UpdateLogic();
+        if (!_replayKeepGoing && replayManager->IsPlaybackStateMismatching())
+        {
+            break;
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+
+    const uint32_t ticks = gCurrentTicks - startTick;
+    Console::WriteLine(
+        "Replayed %u ticks in %.3f s (%.0f ticks/s)", ticks, elapsed.count(),
+        elapsed.count() > 0 ? ticks / elapsed.count() : 0.0);
+
+    auto mismatch = replayManager->GetFirstChecksumMismatch();
+    if (mismatch.has_value())
+    {
+        Console::WriteLine(
+            "First checksum mismatch at tick %u; Saved: %s, Current: %s", mismatch->Tick, mismatch->SavedChecksum.c_str(),
+            mismatch->CurrentChecksum.c_str());
+        return EXITCODE_FAIL;
+    }
+
+    Console::WriteLine("No checksum mismatch");
+    return EXITCODE_OK;
+}
+
+#ifndef DISABLE_NETWORK
+
+struct ReplayTickChecksum
+{
+    uint32_t Tick;
+    EntitiesChecksum Checksum;
+};
+
+// Plays the whole replay and keeps the entity checksum of every tick.
+static bool ReadReplayChecksums(IContext& context, const char* path, std::vector<ReplayTickChecksum>& checksums)
+{
+    auto* replayManager = context.GetReplayManager();
+    if (!replayManager->StartPlayback(path))
+    {
+        Console::Error::WriteLine("Unable to start replay '%s'.", path);
+        return false;
+    }
+
+    auto* gameState = context.GetGameState();
+    while (replayManager->IsReplaying())
+    {
+        checksums.push_back({ gCurrentTicks, GetAllEntitiesChecksum() });
+        gameState->UpdateLogic();
+    }
+    return !checksums.empty();
+}
+
+// Seeks the replay to the given tick and serialises a snapshot of the entities there.
+static bool CaptureReplaySnapshot(IContext& context, const char* path, uint32_t tick, MemoryStream& snapshotData)
+{
+    auto* replayManager = context.GetReplayManager();
+    if (!replayManager->StartPlayback(path))
+    {
+        Console::Error::WriteLine("Unable to start replay '%s'.", path);
+        return false;
+    }
+
+    const uint32_t startTick = gCurrentTicks;
+    if (tick > startTick && !replayManager->SeekPlayback(tick - startTick))
+    {
+        Console::Error::WriteLine("Unable to seek '%s' to tick %u.", path, tick);
+        return false;
+    }
+
+    auto* snapshots = context.GetGameStateSnapshots();
+    auto& snapshot = snapshots->CreateSnapshot();
+    snapshots->Capture(snapshot);
+    snapshots->LinkSnapshot(snapshot, gCurrentTicks, scenario_rand_state().s0);
+
+    // The snapshot buffer only holds a few snapshots, keep a copy of this one.
+    DataSerialiser ds(true, snapshotData);
+    snapshots->SerialiseSnapshot(snapshot, ds);
+
+    if (replayManager->IsReplaying())
+    {
+        replayManager->StopPlayback();
+    }
+    return true;
+}
+
+/**
+ * Plays two replays of the same park, bisects their per tick entity checksums for the first tick at which they
+ * differ and prints which entities and fields differ at that tick.
+ */
+static exitcode_t HandleReplayCompare(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 2 || argv[0][0] == '-' || argv[1][0] == '-')
+    {
+        Console::Error::WriteLine("Missing arguments <file> <other_file>.");
+        return EXITCODE_FAIL;
+    }
+
+    core_init();
+
+    const char* paths[] = { argv[0], argv[1] };
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+
+    std::vector<ReplayTickChecksum> checksums[2];
+    for (size_t i = 0; i < 2; i++)
+    {
+        if (!ReadReplayChecksums(*context, paths[i], checksums[i]))
+        {
+            return EXITCODE_FAIL;
+        }
+    }
+
+    const uint32_t firstTick = std::max(checksums[0].front().Tick, checksums[1].front().Tick);
+    const uint32_t lastTick = std::min(checksums[0].back().Tick, checksums[1].back().Tick);
+    if (firstTick > lastTick)
+    {
+        Console::Error::WriteLine("The replays have no ticks in common.");
+        return EXITCODE_FAIL;
+    }
+
+    const auto isEqual = [&](uint32_t tick) {
+        const auto& a = checksums[0][tick - checksums[0].front().Tick].Checksum;
+        const auto& b = checksums[1][tick - checksums[1].front().Tick].Checksum;
+        return std::memcmp(a.raw.data(), b.raw.data(), a.raw.size()) == 0;
+    };
+
+    // Once the replays diverge they stay diverged, so the first tick that differs can be bisected.
+    uint32_t low = firstTick;
+    uint32_t high = lastTick + 1;
+    while (low < high)
+    {
+        const uint32_t mid = low + (high - low) / 2;
+        if (isEqual(mid))
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low > lastTick)
+    {
+        Console::WriteLine("The replays agree from tick %u to %u", firstTick, lastTick);
+        return EXITCODE_OK;
+    }
+
+    const uint32_t divergedTick = low;
+    if (divergedTick == firstTick)
+    {
+        Console::WriteLine("The replays already differ at their first common tick %u", divergedTick);
+    }
+    else
+    {
+        Console::WriteLine("First divergent tick %u, last equal tick %u", divergedTick, divergedTick - 1);
+    }
+
+    MemoryStream snapshotData[2];
+    for (size_t i = 0; i < 2; i++)
+    {
+        if (!CaptureReplaySnapshot(*context, paths[i], divergedTick, snapshotData[i]))
+        {
+            return EXITCODE_FAIL;
+        }
+    }
+
+    auto* snapshots = context->GetGameStateSnapshots();
+    GameStateSnapshot_t* snapshot[2];
+    for (size_t i = 0; i < 2; i++)
+    {
+        snapshotData[i].SetPosition(0);
+        DataSerialiser ds(false, snapshotData[i]);
+        snapshot[i] = &snapshots->CreateSnapshot();
+        snapshots->SerialiseSnapshot(*snapshot[i], ds);
+    }
+
+    auto cmpData = snapshots->Compare(*snapshot[0], *snapshot[1]);
+    Console::WriteLine("%s", snapshots->GetCompareDataText(cmpData).c_str());
+    return EXITCODE_FAIL;
+}
+
+#else
+static exitcode_t HandleReplayCompare(CommandLineArgEnumerator* argEnumerator)
+{
+    Console::Error::WriteLine("Sorry, entity checksums are not available without networking in this build.");
+    return EXITCODE_FAIL;
+}
+#endif // DISABLE_NETWORK
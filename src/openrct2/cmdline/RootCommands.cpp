@@ -140,7 +140,14 @@ const CommandLineCommand CommandLine::RootCommands[]
     DefineSubCommand("benchgfx",        CommandLine::BenchGfxCommands         ),
     DefineSubCommand("benchspritesort", CommandLine::BenchSpriteSortCommands  ),
     DefineSubCommand("benchsimulate",   CommandLine::BenchUpdateCommands      ),
+    DefineSubCommand("benchjobpool",    CommandLine::BenchJobPoolCommands     ),
+    DefineSubCommand("benchrideratings", CommandLine::BenchRideRatingsCommands ),
+    DefineSubCommand("benchparkfile",   CommandLine::BenchParkFileCommands    ),
+    DefineSubCommand("benchnetwork",    CommandLine::BenchNetworkCommands     ),
+    DefineSubCommand("benchpathfinding", CommandLine::BenchPathfindingCommands ),
     DefineSubCommand("simulate",        CommandLine::SimulateCommands         ),
+    DefineSubCommand("simulate-batch",  CommandLine::SimulateBatchCommands    ),
+    DefineSubCommand("replay",          CommandLine::ReplayCommands           ),
     CommandTableEnd
 };
 
@@ -7,27 +7,90 @@
  * OpenRCT2 is licensed under the GNU General Public License version 3.
  *****************************************************************************/
 
+#ifndef _WIN32
+#    include <poll.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
 #include "../Context.h"
 #include "../Game.h"
 #include "../GameState.h"
 #include "../OpenRCT2.h"
+#include "../config/Config.h"
 #include "../core/Console.hpp"
+#include "../core/Json.hpp"
 #include "../entity/EntityRegistry.h"
+#include "../entity/Guest.h"
+#include "../management/Finance.h"
 #include "../network/network.h"
 #include "../platform/platform.h"
+#include "../util/Util.h"
+#include "../world/Park.h"
 #include "CommandLine.hpp"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdlib>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace OpenRCT2;
 
+static int32_t _batchJobs = 0;
+static utf8* _batchOutputPath = nullptr;
+
 static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator);
+static exitcode_t HandleSimulateBatch(CommandLineArgEnumerator* argEnumerator);
+
+// clang-format off
+static constexpr const CommandLineOptionDefinition SimulateBatchOptions[]
+{
+    { CMDLINE_TYPE_INTEGER, &_batchJobs,       'j', "jobs",   "number of parks to simulate at the same time (default: one per core)" },
+    { CMDLINE_TYPE_STRING,  &_batchOutputPath, 'o', "output", "file to write the JSON results to (default: standard output)"         },
+    OptionTableEnd
+};
+// clang-format on
 
 const CommandLineCommand CommandLine::SimulateCommands[]{ // Main commands
                                                           DefineCommand("", "<ticks>", nullptr, HandleSimulate), CommandTableEnd
 };
 
+const CommandLineCommand CommandLine::SimulateBatchCommands[]{
+    DefineCommand("", "<ticks> <file> [<file>...]", SimulateBatchOptions, HandleSimulateBatch), CommandTableEnd
+};
+
+static constexpr const char* LogicTimePartNames[] = {
+    "NetworkUpdate",
+    "Date",
+    "Scenario",
+    "Climate",
+    "MapTiles",
+    "MapStashProvisionalElements",
+    "MapPathWideFlags",
+    "Peep",
+    "MapRestoreProvisionalElements",
+    "Vehicle",
+    "Misc",
+    "Ride",
+    "Park",
+    "Research",
+    "RideRatings",
+    "RideMeasurments",
+    "News",
+    "MapAnimation",
+    "Sounds",
+    "GameActions",
+    "NetworkFlush",
+    "Scripts",
+};
+static_assert(std::size(LogicTimePartNames) == EnumValue(LogicTimePart::Scripts) + 1);
+
+using LogicTimePartDurations = std::array<std::chrono::duration<double>, std::size(LogicTimePartNames)>;
+
 static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator)
 {
     const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
@@ -73,3 +136,265 @@ static exitcode_t HandleSimulate(CommandLineArgEnumerator* argEnumerator)
 
     return EXITCODE_OK;
 }
+
+/**
+ * Adds up the first numSamples ticks of the recorded timings. A tick only records when each part finished, parts are
+ * credited with the time since the part that finished before them, so the parts of a tick add up to the whole tick.
+ */
+static void AccumulateLogicTimings(const LogicTimings& timings, size_t numSamples, LogicTimePartDurations& durations)
+{
+    std::vector<std::pair<std::chrono::duration<double>, LogicTimePart>> finished;
+    for (size_t i = 0; i < numSamples; i++)
+    {
+        finished.clear();
+        for (const auto& [part, samples] : timings.TimingInfo)
+        {
+            finished.emplace_back(samples[i], part);
+        }
+        std::sort(finished.begin(), finished.end());
+
+        std::chrono::duration<double> previous{};
+        for (const auto& [time, part] : finished)
+        {
+            durations[EnumValue(part)] += time - previous;
+            previous = time;
+        }
+    }
+}
+
+static json_t SimulatePark(IContext& context, const std::string& path, uint32_t ticks)
+{
+    json_t result = {
+        { "file", path },
+    };
+    if (!context.LoadParkFromFile(path))
+    {
+        result["error"] = "Unable to load park.";
+        return result;
+    }
+
+    LogicTimings timings;
+    LogicTimePartDurations durations{};
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        context.GetGameState()->UpdateLogic(&timings);
+        if (timings.CurrentIdx == 0)
+        {
+            AccumulateLogicTimings(timings, LOGIC_UPDATE_MEASUREMENTS_COUNT, durations);
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+    AccumulateLogicTimings(timings, timings.CurrentIdx, durations);
+
+    json_t timingsMs = json_t::object();
+    for (const auto& [part, samples] : timings.TimingInfo)
+    {
+        const std::chrono::duration<double, std::milli> duration = durations[EnumValue(part)];
+        timingsMs[LogicTimePartNames[EnumValue(part)]] = duration.count();
+    }
+
+    result["ticks"] = ticks;
+    result["seconds"] = elapsed.count();
+    result["ticks_per_second"] = elapsed.count() > 0 ? ticks / elapsed.count() : 0.0;
+    result["checksum"] = GetAllEntitiesChecksum().ToString();
+    result["timings_ms"] = timingsMs;
+    result["guests"] = gNumGuestsInPark;
+    result["park_rating"] = gParkRating;
+    result["finances"] = {
+        { "cash", gCash },
+        { "bank_loan", gBankLoan },
+        { "park_value", gParkValue },
+        { "company_value", gCompanyValue },
+    };
+    return result;
+}
+
+#ifndef _WIN32
+struct SimulateBatchWorker
+{
+    pid_t Pid;
+    int Pipe;
+    size_t ParkIndex;
+    std::string Output;
+};
+
+/**
+ * Every park is simulated in a child process forked from the initialised context, so the children share the loaded
+ * graphics and object repository with the parent and a park that crashes does not take the others down with it.
+ */
+static void SimulateParksInWorkers(
+    IContext& context, const std::vector<std::string>& paths, uint32_t ticks, size_t numJobs, std::vector<json_t>& results)
+{
+    std::vector<SimulateBatchWorker> workers;
+    std::vector<pollfd> pollFds;
+    size_t nextPark = 0;
+    while (nextPark < paths.size() || !workers.empty())
+    {
+        while (workers.size() < numJobs && nextPark < paths.size())
+        {
+            const auto parkIndex = nextPark++;
+            int fds[2];
+            if (pipe(fds) != 0)
+            {
+                results[parkIndex] = { { "file", paths[parkIndex] }, { "error", "Unable to create pipe." } };
+                continue;
+            }
+
+            std::fflush(stdout);
+            std::fflush(stderr);
+            const auto pid = fork();
+            if (pid == 0)
+            {
+                close(fds[0]);
+                const auto output = SimulatePark(context, paths[parkIndex], ticks).dump();
+                size_t written = 0;
+                while (written < output.size())
+                {
+                    const auto count = write(fds[1], output.data() + written, output.size() - written);
+                    if (count <= 0)
+                    {
+                        break;
+                    }
+                    written += count;
+                }
+                close(fds[1]);
+                _exit(0);
+            }
+
+            close(fds[1]);
+            if (pid < 0)
+            {
+                close(fds[0]);
+                results[parkIndex] = { { "file", paths[parkIndex] }, { "error", "Unable to start simulation process." } };
+                continue;
+            }
+            workers.push_back({ pid, fds[0], parkIndex, {} });
+        }
+        if (workers.empty())
+        {
+            continue;
+        }
+
+        // Drain every pipe while waiting, a child can not finish while its pipe is full.
+        pollFds.clear();
+        for (const auto& worker : workers)
+        {
+            pollFds.push_back({ worker.Pipe, POLLIN, 0 });
+        }
+        if (poll(pollFds.data(), pollFds.size(), -1) < 0)
+        {
+            continue;
+        }
+
+        for (size_t i = workers.size(); i-- > 0;)
+        {
+            if (pollFds[i].revents == 0)
+            {
+                continue;
+            }
+
+            auto& worker = workers[i];
+            char buffer[4096];
+            const auto count = read(worker.Pipe, buffer, sizeof(buffer));
+            if (count > 0)
+            {
+                worker.Output.append(buffer, count);
+                continue;
+            }
+
+            close(worker.Pipe);
+            int status = 0;
+            waitpid(worker.Pid, &status, 0);
+            auto& result = results[worker.ParkIndex];
+            try
+            {
+                result = Json::FromString(worker.Output);
+            }
+            catch (const std::exception&)
+            {
+                result = { { "file", paths[worker.ParkIndex] }, { "error", "Simulation process did not report a result." } };
+                if (WIFSIGNALED(status))
+                {
+                    result["error"] = "Simulation process terminated by signal " + std::to_string(WTERMSIG(status)) + ".";
+                }
+            }
+            Console::Error::WriteLine("Finished %s", paths[worker.ParkIndex].c_str());
+            workers.erase(workers.begin() + i);
+        }
+    }
+}
+#endif
+
+static exitcode_t HandleSimulateBatch(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    // Options are parsed separately and always come last.
+    std::vector<std::string> paths;
+    for (int32_t i = 1; i < argc && argv[i][0] != '-'; i++)
+    {
+        paths.emplace_back(argv[i]);
+    }
+    if (argc < 1 || argv[0][0] == '-' || paths.empty())
+    {
+        Console::Error::WriteLine("Missing arguments <ticks> <file> [<file>...].");
+        return EXITCODE_FAIL;
+    }
+
+    core_init();
+
+    uint32_t ticks = atol(argv[0]);
+    size_t numJobs = _batchJobs > 0 ? _batchJobs : std::max(std::thread::hardware_concurrency(), 1u);
+
+    gOpenRCT2Headless = true;
+
+    // Parks running side by side already keep every core busy.
+    if (numJobs > 1)
+    {
+        gConfigGeneral.multithreading = false;
+    }
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+
+    Console::Error::WriteLine("Running %d ticks of %zu parks, %zu at a time...", ticks, paths.size(), numJobs);
+    std::vector<json_t> results(paths.size());
+#ifndef _WIN32
+    SimulateParksInWorkers(*context, paths, ticks, numJobs, results);
+#else
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        results[i] = SimulatePark(*context, paths[i], ticks);
+        Console::Error::WriteLine("Finished %s", paths[i].c_str());
+    }
+#endif
+
+    auto numFailed = std::count_if(results.begin(), results.end(), [](const json_t& result) {
+        return result.contains("error");
+    });
+    json_t output = {
+        { "ticks", ticks },
+        { "parks", results },
+    };
+    if (_batchOutputPath != nullptr)
+    {
+        Json::WriteToFile(_batchOutputPath, output);
+    }
+    else
+    {
+        Console::WriteLine("%s", output.dump(4).c_str());
+    }
+
+    if (numFailed != 0)
+    {
+        Console::Error::WriteLine("%zu of %zu parks failed.", static_cast<size_t>(numFailed), paths.size());
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
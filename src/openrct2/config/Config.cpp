@@ -207,6 +207,7 @@ namespace Config
                 "scale_quality", ScaleQuality::SmoothNearestNeighbour, Enum_ScaleQuality);
             model->show_fps = reader->GetBoolean("show_fps", false);
             model->multithreading = reader->GetBoolean("multi_threading", false);
+            model->multithreading_workers = reader->GetInt32("multi_threading_workers", 0);
             model->trap_cursor = reader->GetBoolean("trap_cursor", false);
             model->auto_open_shops = reader->GetBoolean("auto_open_shops", false);
             model->scenario_select_mode = reader->GetInt32("scenario_select_mode", SCENARIO_SELECT_MODE_ORIGIN);
@@ -226,6 +227,8 @@ namespace Config
             model->allow_early_completion = reader->GetBoolean("allow_early_completion", false);
             model->transparent_screenshot = reader->GetBoolean("transparent_screenshot", true);
             model->transparent_water = reader->GetBoolean("transparent_water", true);
+            model->retain_viewport_paint = reader->GetBoolean("retain_viewport_paint", true);
+            model->adaptive_paint_columns = reader->GetBoolean("adaptive_paint_columns", true);
             model->last_version_check_time = reader->GetInt64("last_version_check_time", 0);
         }
     }
@@ -284,6 +287,7 @@ namespace Config
         writer->WriteEnum<ScaleQuality>("scale_quality", model->scale_quality, Enum_ScaleQuality);
         writer->WriteBoolean("show_fps", model->show_fps);
         writer->WriteBoolean("multi_threading", model->multithreading);
+        writer->WriteInt32("multi_threading_workers", model->multithreading_workers);
         writer->WriteBoolean("trap_cursor", model->trap_cursor);
         writer->WriteBoolean("auto_open_shops", model->auto_open_shops);
         writer->WriteInt32("scenario_select_mode", model->scenario_select_mode);
@@ -304,6 +308,8 @@ namespace Config
         writer->WriteEnum<VirtualFloorStyles>("virtual_floor_style", model->virtual_floor_style, Enum_VirtualFloorStyle);
         writer->WriteBoolean("transparent_screenshot", model->transparent_screenshot);
         writer->WriteBoolean("transparent_water", model->transparent_water);
+        writer->WriteBoolean("retain_viewport_paint", model->retain_viewport_paint);
+        writer->WriteBoolean("adaptive_paint_columns", model->adaptive_paint_columns);
         writer->WriteInt64("last_version_check_time", model->last_version_check_time);
     }
 
@@ -420,6 +426,7 @@ namespace Config
             model->log_server_actions = reader->GetBoolean("log_server_actions", false);
             model->pause_server_if_no_clients = reader->GetBoolean("pause_server_if_no_clients", false);
             model->desync_debugging = reader->GetBoolean("desync_debugging", false);
+            model->packet_frames = reader->GetBoolean("packet_frames", true);
         }
     }
 
@@ -447,6 +454,7 @@ namespace Config
         writer->WriteBoolean("log_server_actions", model->log_server_actions);
         writer->WriteBoolean("pause_server_if_no_clients", model->pause_server_if_no_clients);
         writer->WriteBoolean("desync_debugging", model->desync_debugging);
+        writer->WriteBoolean("packet_frames", model->packet_frames);
     }
 
     static void ReadNotifications(IIniReader* reader)
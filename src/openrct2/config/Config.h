@@ -42,6 +42,7 @@ struct GeneralConfiguration
     bool use_vsync;
     bool show_fps;
     bool multithreading;
+    int32_t multithreading_workers;
     bool minimize_fullscreen_focus_loss;
     bool disable_screensaver;
 
@@ -59,6 +60,8 @@ struct GeneralConfiguration
     bool show_guest_purchases;
     bool transparent_screenshot;
     bool transparent_water;
+    bool retain_viewport_paint;
+    bool adaptive_paint_columns;
 
     // Localisation
     int32_t language;
@@ -162,6 +165,7 @@ struct NetworkConfiguration
     bool log_server_actions;
     bool pause_server_if_no_clients;
     bool desync_debugging;
+    bool packet_frames;
 };
 
 struct NotificationConfiguration
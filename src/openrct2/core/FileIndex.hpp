@@ -16,36 +16,34 @@
 #include "FileScanner.h"
 #include "FileStream.h"
 #include "JobPool.h"
-#include "Numerics.hpp"
 #include "Path.hpp"
 
 #include <chrono>
-#include <list>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 template<typename TItem> class FileIndex
 {
 private:
-    struct DirectoryStats
+    struct FileRecord
     {
-        uint32_t TotalFiles = 0;
-        uint64_t TotalFileSize = 0;
-        uint32_t FileDateModifiedChecksum = 0;
-        uint32_t PathChecksum = 0;
+        std::string Path;
+        uint64_t Size = 0;
+        uint64_t LastModified = 0;
     };
 
-    struct ScanResult
+    /**
+     * A file as it was when it was last indexed and the item created from it, files which did not produce an item are
+     * kept as well so that they are not parsed again on every start.
+     */
+    struct IndexEntry
     {
-        DirectoryStats const Stats;
-        std::vector<std::string> const Files;
-
-        ScanResult(DirectoryStats stats, std::vector<std::string> files)
-            : Stats(stats)
-            , Files(files)
-        {
-        }
+        FileRecord File;
+        bool HasItem = false;
+        TItem Item{};
     };
 
     struct FileIndexHeader
@@ -55,12 +53,11 @@ private:
         uint8_t VersionA = 0;
         uint8_t VersionB = 0;
         uint16_t LanguageId = 0;
-        DirectoryStats Stats;
-        uint32_t NumItems = 0;
+        uint32_t NumEntries = 0;
     };
 
     // Index file format version which when incremented forces a rebuild
-    static constexpr uint8_t FILE_INDEX_VERSION = 4;
+    static constexpr uint8_t FILE_INDEX_VERSION = 5;
 
     std::string const _name;
     uint32_t const _magicNumber;
@@ -96,32 +93,21 @@ public:
     virtual ~FileIndex() = default;
 
     /**
-     * Queries and directories and loads the index header. If the index is up to date,
-     * the items are loaded from the index and returned, otherwise the index is rebuilt.
+     * Queries the directories and loads the index. Files which have not changed since they were last indexed (same
+     * size and last modified time) keep their stored item, only added or changed files are loaded again and removed
+     * files are dropped. The index is written back if anything changed.
      */
     std::vector<TItem> LoadOrBuild(int32_t language) const
     {
-        std::vector<TItem> items;
-        auto scanResult = Scan();
-        auto readIndexResult = ReadIndexFile(language, scanResult.Stats);
-        if (std::get<0>(readIndexResult))
-        {
-            // Index was loaded
-            items = std::get<1>(readIndexResult);
-        }
-        else
-        {
-            // Index was not loaded
-            items = Build(language, scanResult);
-        }
-        return items;
+        auto files = Scan();
+        auto readIndexResult = ReadIndexFile(language);
+        return Build(language, files, std::get<1>(readIndexResult), !std::get<0>(readIndexResult));
     }
 
     std::vector<TItem> Rebuild(int32_t language) const
     {
-        auto scanResult = Scan();
-        auto items = Build(language, scanResult);
-        return items;
+        auto files = Scan();
+        return Build(language, files, {}, true);
     }
 
 protected:
@@ -137,10 +123,9 @@ protected:
     virtual void Serialise(DataSerialiser& ds, TItem& item) const abstract;
 
 private:
-    ScanResult Scan() const
+    std::vector<FileRecord> Scan() const
     {
-        DirectoryStats stats{};
-        std::vector<std::string> files;
+        std::vector<FileRecord> files;
         for (const auto& directory : SearchPaths)
         {
             auto absoluteDirectory = Path::GetAbsolute(directory);
@@ -151,29 +136,25 @@ private:
             while (scanner->Next())
             {
                 auto fileInfo = scanner->GetFileInfo();
-                auto path = std::string(scanner->GetPath());
 
-                stats.TotalFiles++;
-                stats.TotalFileSize += fileInfo->Size;
-                stats.FileDateModifiedChecksum ^= static_cast<uint32_t>(fileInfo->LastModified >> 32)
-                    ^ static_cast<uint32_t>(fileInfo->LastModified & 0xFFFFFFFF);
-                stats.FileDateModifiedChecksum = Numerics::ror32(stats.FileDateModifiedChecksum, 5);
-                stats.PathChecksum += GetPathChecksum(path);
-
-                files.push_back(std::move(path));
+                FileRecord file;
+                file.Path = std::string(scanner->GetPath());
+                file.Size = fileInfo->Size;
+                file.LastModified = fileInfo->LastModified;
+                files.push_back(std::move(file));
             }
         }
-        return ScanResult(stats, files);
+        return files;
     }
 
     void BuildRange(
-        int32_t language, const ScanResult& scanResult, size_t rangeStart, size_t rangeEnd, std::vector<TItem>& items,
-        std::atomic<size_t>& processed, std::mutex& printLock) const
+        int32_t language, const std::vector<size_t>& indices, size_t rangeStart, size_t rangeEnd,
+        std::vector<IndexEntry>& entries, std::atomic<size_t>& processed, std::mutex& printLock) const
     {
-        items.reserve(rangeEnd - rangeStart);
         for (size_t i = rangeStart; i < rangeEnd; i++)
         {
-            const auto& filePath = scanResult.Files.at(i);
+            auto& entry = entries[indices[i]];
+            const auto& filePath = entry.File.Path;
 
             if (_log_levels[static_cast<uint8_t>(DiagnosticLevel::Verbose)])
             {
@@ -182,76 +163,133 @@ private:
             }
 
             auto item = Create(language, filePath);
-            if (std::get<0>(item))
+            entry.HasItem = std::get<0>(item);
+            if (entry.HasItem)
             {
-                items.push_back(std::get<1>(item));
+                entry.Item = std::move(std::get<1>(item));
             }
 
             processed++;
         }
     }
 
-    std::vector<TItem> Build(int32_t language, const ScanResult& scanResult) const
+    std::vector<TItem> Build(
+        int32_t language, const std::vector<FileRecord>& files, const std::vector<IndexEntry>& indexedEntries,
+        bool writeIndex) const
     {
-        std::vector<TItem> allItems;
-        Console::WriteLine("Building %s (%zu items)", _name.c_str(), scanResult.Files.size());
-
-        auto startTime = std::chrono::high_resolution_clock::now();
-
-        const size_t totalCount = scanResult.Files.size();
-        if (totalCount > 0)
+        std::unordered_map<std::string_view, const IndexEntry*> indexedFiles;
+        indexedFiles.reserve(indexedEntries.size());
+        for (const auto& indexedEntry : indexedEntries)
         {
-            JobPool jobPool;
-            std::mutex printLock; // For verbose prints.
+            indexedFiles.emplace(indexedEntry.File.Path, &indexedEntry);
+        }
 
-            std::list<std::vector<TItem>> containers;
+        // Carry over every file that is unchanged, remember which ones need to be loaded.
+        std::vector<IndexEntry> entries(files.size());
+        std::vector<size_t> changedFiles;
+        size_t numReused = 0;
+        size_t numModified = 0;
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            const auto& file = files[i];
+            auto it = indexedFiles.find(file.Path);
+            if (it != indexedFiles.end() && it->second->File.Size == file.Size
+                && it->second->File.LastModified == file.LastModified)
+            {
+                entries[i] = *it->second;
+                numReused++;
+            }
+            else
+            {
+                if (it != indexedFiles.end())
+                {
+                    numModified++;
+                }
+                entries[i].File = file;
+                changedFiles.push_back(i);
+            }
+        }
 
-            size_t stepSize = 100; // Handpicked, seems to work well with 4/8 cores.
+        const size_t numRemoved = indexedEntries.size() - numReused - numModified;
+        const bool fullBuild = numReused == 0;
+        if (writeIndex || !changedFiles.empty() || numRemoved != 0)
+        {
+            if (fullBuild)
+            {
+                Console::WriteLine("Building %s (%zu items)", _name.c_str(), files.size());
+            }
+            else
+            {
+                Console::WriteLine(
+                    "Updating %s (%zu added, %zu changed, %zu removed)", _name.c_str(), changedFiles.size() - numModified,
+                    numModified, numRemoved);
+            }
 
-            std::atomic<size_t> processed = ATOMIC_VAR_INIT(0);
+            auto startTime = std::chrono::high_resolution_clock::now();
+            BuildEntries(language, changedFiles, entries);
+            WriteIndexFile(language, entries);
 
-            auto reportProgress = [&]() {
-                const size_t completed = processed;
-                Console::WriteFormat("File %5zu of %zu, done %3d%%\r", completed, totalCount, completed * 100 / totalCount);
-            };
+            auto endTime = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration<float>(endTime - startTime);
+            Console::WriteLine(
+                "Finished %s %s in %.2f seconds.", fullBuild ? "building" : "updating", _name.c_str(), duration.count());
+        }
 
-            for (size_t rangeStart = 0; rangeStart < totalCount; rangeStart += stepSize)
+        std::vector<TItem> items;
+        items.reserve(entries.size());
+        for (auto& entry : entries)
+        {
+            if (entry.HasItem)
             {
-                if (rangeStart + stepSize > totalCount)
-                {
-                    stepSize = totalCount - rangeStart;
-                }
+                items.push_back(std::move(entry.Item));
+            }
+        }
+        return items;
+    }
 
-                auto& items = containers.emplace_back();
+    void BuildEntries(int32_t language, const std::vector<size_t>& indices, std::vector<IndexEntry>& entries) const
+    {
+        const size_t totalCount = indices.size();
+        if (totalCount == 0)
+        {
+            return;
+        }
 
-                jobPool.AddTask(std::bind(
-                    &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), rangeStart, rangeStart + stepSize,
-                    std::ref(items), std::ref(processed), std::ref(printLock)));
+        JobPool jobPool;
+        std::mutex printLock; // For verbose prints.
 
-                reportProgress();
-            }
+        size_t stepSize = 100; // Handpicked, seems to work well with 4/8 cores.
 
-            jobPool.Join(reportProgress);
+        std::atomic<size_t> processed = ATOMIC_VAR_INIT(0);
 
-            for (const auto& itr : containers)
+        auto reportProgress = [&]() {
+            const size_t completed = processed;
+            Console::WriteFormat("File %5zu of %zu, done %3d%%\r", completed, totalCount, completed * 100 / totalCount);
+        };
+
+        for (size_t rangeStart = 0; rangeStart < totalCount; rangeStart += stepSize)
+        {
+            if (rangeStart + stepSize > totalCount)
             {
-                allItems.insert(allItems.end(), itr.begin(), itr.end());
+                stepSize = totalCount - rangeStart;
             }
-        }
 
-        WriteIndexFile(language, scanResult.Stats, allItems);
+            // Every range writes to its own entries, no locking needed.
+            const size_t rangeEnd = rangeStart + stepSize;
+            jobPool.AddTask([this, language, &indices, rangeStart, rangeEnd, &entries, &processed, &printLock]() {
+                BuildRange(language, indices, rangeStart, rangeEnd, entries, processed, printLock);
+            });
 
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration<float>(endTime - startTime);
-        Console::WriteLine("Finished building %s in %.2f seconds.", _name.c_str(), duration.count());
+            reportProgress();
+        }
 
-        return allItems;
+        jobPool.Join(reportProgress);
     }
 
-    std::tuple<bool, std::vector<TItem>> ReadIndexFile(int32_t language, const DirectoryStats& stats) const
+    std::tuple<bool, std::vector<IndexEntry>> ReadIndexFile(int32_t language) const
     {
         bool loadedItems = false;
-        std::vector<TItem> items;
+        std::vector<IndexEntry> entries;
         if (File::Exists(_indexPath))
         {
             try
@@ -259,22 +297,18 @@ private:
                 log_verbose("FileIndex:Loading index: '%s'", _indexPath.c_str());
                 auto fs = OpenRCT2::FileStream(_indexPath, OpenRCT2::FILE_MODE_OPEN);
 
-                // Read header, check if we need to re-scan
+                // Read header, an index of a different version or language can not be reused at all
                 auto header = fs.ReadValue<FileIndexHeader>();
                 if (header.HeaderSize == sizeof(FileIndexHeader) && header.MagicNumber == _magicNumber
-                    && header.VersionA == FILE_INDEX_VERSION && header.VersionB == _version && header.LanguageId == language
-                    && header.Stats.TotalFiles == stats.TotalFiles && header.Stats.TotalFileSize == stats.TotalFileSize
-                    && header.Stats.FileDateModifiedChecksum == stats.FileDateModifiedChecksum
-                    && header.Stats.PathChecksum == stats.PathChecksum)
+                    && header.VersionA == FILE_INDEX_VERSION && header.VersionB == _version && header.LanguageId == language)
                 {
-                    items.reserve(header.NumItems);
+                    entries.reserve(header.NumEntries);
                     DataSerialiser ds(false, fs);
-                    // Directory is the same, just read the saved items
-                    for (uint32_t i = 0; i < header.NumItems; i++)
+                    for (uint32_t i = 0; i < header.NumEntries; i++)
                     {
-                        TItem item;
-                        Serialise(ds, item);
-                        items.emplace_back(std::move(item));
+                        IndexEntry entry;
+                        SerialiseEntry(ds, entry);
+                        entries.emplace_back(std::move(entry));
                     }
                     loadedItems = true;
                 }
@@ -287,12 +321,13 @@ private:
             {
                 Console::Error::WriteLine("Unable to load index: '%s'.", _indexPath.c_str());
                 Console::Error::WriteLine("%s", e.what());
+                entries.clear();
             }
         }
-        return std::make_tuple(loadedItems, std::move(items));
+        return std::make_tuple(loadedItems, std::move(entries));
     }
 
-    void WriteIndexFile(int32_t language, const DirectoryStats& stats, std::vector<TItem>& items) const
+    void WriteIndexFile(int32_t language, std::vector<IndexEntry>& entries) const
     {
         try
         {
@@ -306,15 +341,14 @@ private:
             header.VersionA = FILE_INDEX_VERSION;
             header.VersionB = _version;
             header.LanguageId = language;
-            header.Stats = stats;
-            header.NumItems = static_cast<uint32_t>(items.size());
+            header.NumEntries = static_cast<uint32_t>(entries.size());
             fs.WriteValue(header);
 
             DataSerialiser ds(true, fs);
-            // Write items
-            for (auto& item : items)
+            // Write entries
+            for (auto& entry : entries)
             {
-                Serialise(ds, item);
+                SerialiseEntry(ds, entry);
             }
         }
         catch (const std::exception& e)
@@ -324,18 +358,15 @@ private:
         }
     }
 
-    static uint32_t GetPathChecksum(const std::string& path)
+    void SerialiseEntry(DataSerialiser& ds, IndexEntry& entry) const
     {
-        uint32_t hash = 0xD8430DED;
-        for (const utf8* ch = path.c_str(); *ch != '\0'; ch++)
+        ds << entry.File.Path;
+        ds << entry.File.Size;
+        ds << entry.File.LastModified;
+        ds << entry.HasItem;
+        if (entry.HasItem)
         {
-            hash += (*ch);
-            hash += (hash << 10);
-            hash ^= (hash >> 6);
+            Serialise(ds, entry.Item);
         }
-        hash += (hash << 3);
-        hash ^= (hash >> 11);
-        hash += (hash << 15);
-        return hash;
     }
 };
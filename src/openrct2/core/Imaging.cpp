@@ -162,7 +162,7 @@ namespace Imaging
         }
     }
 
-    static void WritePng(std::ostream& ostream, const Image& image)
+    static void WritePng(std::ostream& ostream, const Image& image, const ImageRowFunc& getRow)
     {
         png_structp png_ptr = nullptr;
         png_colorp png_palette = nullptr;
@@ -231,11 +231,9 @@ namespace Imaging
             png_write_info(png_ptr, info_ptr);
 
             // Write pixels
-            auto pixels = image.Pixels.data();
             for (uint32_t y = 0; y < image.Height; y++)
             {
-                png_write_row(png_ptr, const_cast<png_byte*>(pixels));
-                pixels += image.Stride;
+                png_write_row(png_ptr, const_cast<png_byte*>(getRow(y)));
             }
 
             png_write_end(png_ptr, nullptr);
@@ -251,6 +249,12 @@ namespace Imaging
         }
     }
 
+    static void WritePng(std::ostream& ostream, const Image& image)
+    {
+        auto pixels = image.Pixels.data();
+        WritePng(ostream, image, [pixels, &image](uint32_t y) { return pixels + static_cast<size_t>(y) * image.Stride; });
+    }
+
     IMAGE_FORMAT GetImageFormatFromPath(std::string_view path)
     {
         if (String::EndsWith(path, ".png", true))
@@ -350,4 +354,15 @@ namespace Imaging
                 throw std::runtime_error(EXCEPTION_IMAGE_FORMAT_UNKNOWN);
         }
     }
+
+    void WriteToFile(std::string_view path, const Image& image, const ImageRowFunc& getRow)
+    {
+#if defined(_WIN32) && !defined(__MINGW32__)
+        auto pathW = String::ToWideChar(path);
+        std::ofstream fs(pathW, std::ios::binary);
+#else
+        std::ofstream fs(std::string(path), std::ios::binary);
+#endif
+        WritePng(fs, image, getRow);
+    }
 } // namespace Imaging
@@ -43,6 +43,7 @@ struct Image
 };
 
 using ImageReaderFunc = std::function<Image(std::istream&, IMAGE_FORMAT)>;
+using ImageRowFunc = std::function<const uint8_t*(uint32_t row)>;
 
 namespace Imaging
 {
@@ -50,6 +51,11 @@ namespace Imaging
     Image ReadFromFile(std::string_view path, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
     Image ReadFromBuffer(const std::vector<uint8_t>& buffer, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
     void WriteToFile(std::string_view path, const Image& image, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
+    /**
+     * Writes a PNG of which only the meta data and palette are given, the rows are requested in order from getRow so
+     * that the whole image never has to be held in memory.
+     */
+    void WriteToFile(std::string_view path, const Image& image, const ImageRowFunc& getRow);
 
     void SetReader(IMAGE_FORMAT format, ImageReaderFunc impl);
 } // namespace Imaging
@@ -9,28 +9,182 @@
 
 #include "JobPool.h"
 
-#include <algorithm>
 #include <cassert>
+#include <chrono>
 
-JobPool::TaskData::TaskData(std::function<void()> workFn, std::function<void()> completionFn)
-    : WorkFn(workFn)
-    , CompletionFn(completionFn)
+// Amount of failed steal attempts before an idle worker goes to sleep.
+static constexpr int32_t IdleSpinCount = 64;
+static constexpr size_t ArenaChunkSize = 64;
+static constexpr auto JoinReportInterval = std::chrono::milliseconds(10);
+
+std::atomic<size_t> JobPool::_workerCountOverride = { 0 };
+
+/**
+ * Recycles task slots. Only the owning thread allocates, any thread may return a slot after
+ * executing it. Returned slots are collected with a lock-free stack that the owner takes over
+ * as a whole, which avoids the ABA problem of popping single entries.
+ */
+class JobPool::Arena
+{
+private:
+    std::vector<std::unique_ptr<Task[]>> _chunks;
+    Task* _free = nullptr;
+    std::atomic<Task*> _returned = { nullptr };
+
+public:
+    Task* Allocate()
+    {
+        if (_free == nullptr)
+        {
+            _free = _returned.exchange(nullptr, std::memory_order_acquire);
+        }
+        if (_free == nullptr)
+        {
+            auto& chunk = _chunks.emplace_back(std::make_unique<Task[]>(ArenaChunkSize));
+            for (size_t i = 0; i < ArenaChunkSize; i++)
+            {
+                chunk[i].Owner = this;
+                chunk[i].NextFree = _free;
+                _free = &chunk[i];
+            }
+        }
+        Task* task = _free;
+        _free = task->NextFree;
+        return task;
+    }
+
+    void Return(Task* task)
+    {
+        Task* head = _returned.load(std::memory_order_relaxed);
+        do
+        {
+            task->NextFree = head;
+        } while (!_returned.compare_exchange_weak(head, task, std::memory_order_release, std::memory_order_relaxed));
+    }
+};
+
+/**
+ * Bounded Chase-Lev deque. The owner pushes and pops at the bottom, thieves take from the top.
+ * See "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al. 2013).
+ */
+class JobPool::WorkStealingQueue
+{
+private:
+    static constexpr int64_t Capacity = 4096;
+    static constexpr int64_t Mask = Capacity - 1;
+
+    alignas(64) std::atomic<int64_t> _top = { 0 };
+    alignas(64) std::atomic<int64_t> _bottom = { 0 };
+    std::atomic<Task*> _buffer[Capacity] = {};
+
+public:
+    bool Push(Task* task)
+    {
+        const int64_t b = _bottom.load(std::memory_order_relaxed);
+        const int64_t t = _top.load(std::memory_order_acquire);
+        if (b - t >= Capacity)
+        {
+            return false;
+        }
+        _buffer[b & Mask].store(task, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    Task* Pop()
+    {
+        const int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = _top.load(std::memory_order_relaxed);
+        if (t > b)
+        {
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Task* task = _buffer[b & Mask].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            // Last item, race against thieves.
+            if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                task = nullptr;
+            }
+            _bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    Task* Steal()
+    {
+        int64_t t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = _bottom.load(std::memory_order_acquire);
+        if (t >= b)
+        {
+            return nullptr;
+        }
+
+        Task* task = _buffer[t & Mask].load(std::memory_order_relaxed);
+        if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+        return task;
+    }
+};
+
+struct JobPool::Worker
+{
+    JobPool* Pool = nullptr;
+    size_t Index = 0;
+    WorkStealingQueue Queue;
+    Arena TaskArena;
+};
+
+thread_local JobPool::Worker* JobPool::_currentWorker = nullptr;
+
+JobPool::TaskGroup::TaskGroup(JobPool& pool)
+    : _pool(pool)
+{
+}
+
+JobPool::TaskGroup::~TaskGroup()
+{
+    Wait();
+}
+
+void JobPool::TaskGroup::Wait()
 {
+    _pool.WaitForCounter(_pending, nullptr);
 }
 
 JobPool::JobPool(size_t maxThreads)
+    : _injectionQueue(std::make_unique<WorkStealingQueue>())
+    , _injectionArena(std::make_unique<Arena>())
 {
-    maxThreads = std::min<size_t>(maxThreads, std::thread::hardware_concurrency());
+    maxThreads = std::min<size_t>(maxThreads, GetDefaultWorkerCount());
     for (size_t n = 0; n < maxThreads; n++)
     {
-        _threads.emplace_back(&JobPool::ProcessQueue, this);
+        auto& worker = _workers.emplace_back(std::make_unique<Worker>());
+        worker->Pool = this;
+        worker->Index = n;
+    }
+    for (auto& worker : _workers)
+    {
+        _threads.emplace_back(&JobPool::ProcessQueue, this, worker.get());
     }
 }
 
 JobPool::~JobPool()
 {
+    // Queued tasks own their captured state, run them rather than leaking it.
+    Join();
+
     {
-        unique_lock lock(_mutex);
+        unique_lock lock(_sleepMutex);
         _shouldStop = true;
         _condPending.notify_all();
     }
@@ -42,84 +196,224 @@ JobPool::~JobPool()
     }
 }
 
+void JobPool::SetWorkerCountOverride(size_t count)
+{
+    _workerCountOverride = count;
+}
+
+size_t JobPool::GetDefaultWorkerCount()
+{
+    const size_t count = _workerCountOverride;
+    if (count != 0)
+    {
+        return count;
+    }
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
 void JobPool::AddTask(std::function<void()> workFn, std::function<void()> completionFn)
 {
-    unique_lock lock(_mutex);
-    _pending.emplace_back(workFn, completionFn);
-    _condPending.notify_one();
+    if (completionFn == nullptr)
+    {
+        AddTask(std::move(workFn));
+        return;
+    }
+
+    // Both functions together exceed the task storage, this is the only path that allocates.
+    auto data = std::make_unique<CompletionData>();
+    data->WorkFn = std::move(workFn);
+    data->CompletionFn = std::move(completionFn);
+    AddTask([this, data = std::move(data)]() {
+        data->WorkFn();
+
+        unique_lock lock(_completeMutex);
+        _completed.push_back(std::move(*data));
+        _condComplete.notify_all();
+    });
 }
 
 void JobPool::Join(std::function<void()> reportFn)
 {
-    unique_lock lock(_mutex);
-    while (true)
-    {
-        // Wait for the queue to become empty or having completed tasks.
-        _condComplete.wait(lock, [this]() { return (_pending.empty() && _processing == 0) || !_completed.empty(); });
+    WaitForCounter(_pending, reportFn);
 
-        // Dispatch all completion callbacks if there are any.
-        while (!_completed.empty())
-        {
-            auto taskData = _completed.front();
-            _completed.pop_front();
+    unique_lock lock(_completeMutex);
+    DispatchCompletions(lock);
+}
 
-            if (taskData.CompletionFn)
-            {
-                lock.unlock();
+size_t JobPool::CountPending()
+{
+    return _queued;
+}
 
-                taskData.CompletionFn();
+size_t JobPool::CountWorkers() const
+{
+    return _workers.size();
+}
 
-                lock.lock();
-            }
-        }
+JobPool::Task* JobPool::AllocateTask()
+{
+    Worker* self = _currentWorker;
+    if (self != nullptr && self->Pool == this)
+    {
+        return self->TaskArena.Allocate();
+    }
 
-        if (reportFn)
-        {
-            lock.unlock();
+    std::lock_guard<std::mutex> lock(_injectionMutex);
+    return _injectionArena->Allocate();
+}
 
-            reportFn();
+void JobPool::Submit(Task* task)
+{
+    Worker* self = _currentWorker;
+    bool queued;
+    _queued++;
+    if (self != nullptr && self->Pool == this)
+    {
+        queued = self->Queue.Push(task);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(_injectionMutex);
+        queued = _injectionQueue->Push(task);
+    }
 
-            lock.lock();
-        }
+    if (!queued)
+    {
+        // Queue is full, run the task inline instead of blocking the submitter.
+        RunTask(task);
+        return;
+    }
 
-        // If everything is empty and no more work has to be done we can stop waiting.
-        if (_completed.empty() && _pending.empty() && _processing == 0)
+    if (_sleeping > 0)
+    {
+        unique_lock lock(_sleepMutex);
+        _condPending.notify_one();
+    }
+}
+
+JobPool::Task* JobPool::AcquireTask(Worker* self)
+{
+    Task* task = nullptr;
+    if (self != nullptr)
+    {
+        task = self->Queue.Pop();
+    }
+    if (task == nullptr)
+    {
+        task = _injectionQueue->Steal();
+    }
+    if (task == nullptr && !_workers.empty())
+    {
+        // Start at a different victim per worker to spread contention.
+        const size_t numWorkers = _workers.size();
+        const size_t start = self != nullptr ? self->Index + 1 : 0;
+        for (size_t i = 0; i < numWorkers && task == nullptr; i++)
         {
-            break;
+            auto& victim = _workers[(start + i) % numWorkers];
+            if (victim.get() != self)
+            {
+                task = victim->Queue.Steal();
+            }
         }
     }
+    return task;
 }
 
-size_t JobPool::CountPending()
+void JobPool::RunTask(Task* task)
 {
-    return _pending.size();
+    _queued--;
+
+    std::atomic<size_t>* counter = task->Counter;
+    task->Execute(task->Storage);
+    task->Owner->Return(task);
+
+    if (counter->fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        unique_lock lock(_completeMutex);
+        _condComplete.notify_all();
+    }
 }
 
-void JobPool::ProcessQueue()
+void JobPool::WaitForCounter(std::atomic<size_t>& counter, const std::function<void()>& reportFn)
 {
-    unique_lock lock(_mutex);
-    do
+    Worker* self = _currentWorker;
+    if (self != nullptr && self->Pool != this)
     {
-        // Wait for work or cancellation.
-        _condPending.wait(lock, [this]() { return _shouldStop || !_pending.empty(); });
+        self = nullptr;
+    }
 
-        if (!_pending.empty())
+    while (counter.load(std::memory_order_acquire) != 0)
+    {
+        // Help out instead of blocking, this is what makes nested fork/join safe.
+        Task* task = AcquireTask(self);
+        if (task != nullptr)
+        {
+            RunTask(task);
+            continue;
+        }
+
+        // Completion callbacks belong to Join, task groups leave them alone.
+        const bool isJoin = &counter == &_pending;
+        unique_lock lock(_completeMutex);
+        _condComplete.wait_for(lock, JoinReportInterval, [&counter, isJoin, this]() {
+            return counter.load(std::memory_order_acquire) == 0 || (isJoin && !_completed.empty());
+        });
+        if (isJoin)
+        {
+            DispatchCompletions(lock);
+        }
+        lock.unlock();
+
+        if (reportFn)
         {
-            _processing++;
+            reportFn();
+        }
+    }
+}
 
-            auto taskData = _pending.front();
-            _pending.pop_front();
+void JobPool::DispatchCompletions(unique_lock& lock)
+{
+    while (!_completed.empty())
+    {
+        auto completion = std::move(_completed.front());
+        _completed.pop_front();
 
-            lock.unlock();
+        lock.unlock();
 
-            taskData.WorkFn();
+        completion.CompletionFn();
 
-            lock.lock();
+        lock.lock();
+    }
+}
 
-            _completed.push_back(std::move(taskData));
+void JobPool::ProcessQueue(Worker* worker)
+{
+    _currentWorker = worker;
 
-            _processing--;
-            _condComplete.notify_one();
+    int32_t idleSpins = 0;
+    while (!_shouldStop)
+    {
+        Task* task = AcquireTask(worker);
+        if (task != nullptr)
+        {
+            RunTask(task);
+            idleSpins = 0;
+            continue;
+        }
+
+        if (++idleSpins < IdleSpinCount)
+        {
+            std::this_thread::yield();
+            continue;
         }
-    } while (!_shouldStop);
+
+        // Nothing to do, sleep until work is submitted.
+        unique_lock lock(_sleepMutex);
+        _sleeping++;
+        _condPending.wait(lock, [this]() { return _shouldStop || _queued > 0; });
+        _sleeping--;
+        idleSpins = 0;
+    }
+
+    _currentWorker = nullptr;
 }
@@ -9,44 +9,165 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+/**
+ * Work-stealing task scheduler. Every worker owns a lock-free deque it pushes to and pops from,
+ * idle workers steal from the other end of their siblings' deques. Tasks submitted from outside
+ * the pool go into a shared injection queue. Task callables are stored inline in fixed-size task
+ * slots which are recycled, so scheduling does not allocate once the pool has warmed up.
+ */
 class JobPool
 {
+public:
+    // Maximum size of a task callable, anything bigger must be captured by reference.
+    static constexpr size_t TaskStorageSize = 64;
+
 private:
-    struct TaskData
+    class Arena;
+    class WorkStealingQueue;
+    struct Worker;
+
+    struct Task
+    {
+        void (*Execute)(void* storage) = nullptr;
+        std::atomic<size_t>* Counter = nullptr;
+        Arena* Owner = nullptr;
+        Task* NextFree = nullptr;
+        alignas(std::max_align_t) unsigned char Storage[TaskStorageSize];
+    };
+
+public:
+    /**
+     * Fork/join primitive, tasks run through a group can be waited on independently of
+     * any other work that is scheduled on the same pool. The waiting thread helps executing
+     * pending tasks instead of blocking.
+     */
+    class TaskGroup
     {
-        const std::function<void()> WorkFn;
-        const std::function<void()> CompletionFn;
+    private:
+        JobPool& _pool;
+        std::atomic<size_t> _pending = { 0 };
+
+    public:
+        explicit TaskGroup(JobPool& pool);
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+        ~TaskGroup();
+
+        template<typename TFn> void Run(TFn&& fn)
+        {
+            _pool.Submit(_pool.CreateTask(std::forward<TFn>(fn), &_pending));
+        }
 
-        TaskData(std::function<void()> workFn, std::function<void()> completionFn);
+        void Wait();
+    };
+
+private:
+    struct CompletionData
+    {
+        std::function<void()> WorkFn;
+        std::function<void()> CompletionFn;
     };
 
     std::atomic_bool _shouldStop = { false };
-    std::atomic<size_t> _processing = { 0 };
+    std::atomic<size_t> _queued = { 0 };
+    std::atomic<size_t> _pending = { 0 };
+    std::atomic<size_t> _sleeping = { 0 };
+    std::vector<std::unique_ptr<Worker>> _workers;
     std::vector<std::thread> _threads;
-    std::deque<TaskData> _pending;
-    std::deque<TaskData> _completed;
+
+    // Submissions from threads that are not workers of this pool.
+    std::unique_ptr<WorkStealingQueue> _injectionQueue;
+    std::unique_ptr<Arena> _injectionArena;
+    std::mutex _injectionMutex;
+
     std::condition_variable _condPending;
+    std::mutex _sleepMutex;
     std::condition_variable _condComplete;
-    std::mutex _mutex;
+    std::mutex _completeMutex;
+    std::deque<CompletionData> _completed;
 
     using unique_lock = std::unique_lock<std::mutex>;
 
+    static std::atomic<size_t> _workerCountOverride;
+    static thread_local Worker* _currentWorker;
+
 public:
     JobPool(size_t maxThreads = 255);
     ~JobPool();
 
-    void AddTask(std::function<void()> workFn, std::function<void()> completionFn = nullptr);
+    /**
+     * Pins the number of workers for every pool created afterwards, 0 restores the default
+     * of one worker per hardware thread.
+     */
+    static void SetWorkerCountOverride(size_t count);
+    static size_t GetDefaultWorkerCount();
+
+    template<typename TFn> void AddTask(TFn&& workFn)
+    {
+        Submit(CreateTask(std::forward<TFn>(workFn), &_pending));
+    }
+
+    // Completion callbacks are invoked on the thread calling Join.
+    void AddTask(std::function<void()> workFn, std::function<void()> completionFn);
     void Join(std::function<void()> reportFn = nullptr);
     size_t CountPending();
+    size_t CountWorkers() const;
+
+    /**
+     * Splits [0, count) into chunks of at most grainSize items and invokes fn(begin, end) for each
+     * chunk on the pool, returns once all chunks have been processed.
+     */
+    template<typename TFn> void ParallelFor(size_t count, size_t grainSize, const TFn& fn)
+    {
+        grainSize = std::max<size_t>(grainSize, 1);
+        TaskGroup group(*this);
+        for (size_t begin = 0; begin < count; begin += grainSize)
+        {
+            const size_t end = std::min(count, begin + grainSize);
+            group.Run([&fn, begin, end]() { fn(begin, end); });
+        }
+        group.Wait();
+    }
 
 private:
-    void ProcessQueue();
+    template<typename TFn> Task* CreateTask(TFn&& fn, std::atomic<size_t>* counter)
+    {
+        using TCallable = std::decay_t<TFn>;
+        static_assert(sizeof(TCallable) <= TaskStorageSize, "Task callable is too large, capture by reference instead.");
+        static_assert(alignof(TCallable) <= alignof(std::max_align_t), "Task callable is over-aligned.");
+
+        Task* task = AllocateTask();
+        new (task->Storage) TCallable(std::forward<TFn>(fn));
+        task->Execute = [](void* storage) {
+            auto* callable = std::launder(reinterpret_cast<TCallable*>(storage));
+            (*callable)();
+            callable->~TCallable();
+        };
+        task->Counter = counter;
+        counter->fetch_add(1, std::memory_order_relaxed);
+        return task;
+    }
+
+    Task* AllocateTask();
+    void Submit(Task* task);
+    Task* AcquireTask(Worker* self);
+    void RunTask(Task* task);
+    void WaitForCounter(std::atomic<size_t>& counter, const std::function<void()>& reportFn);
+    void DispatchCompletions(unique_lock& lock);
+    void ProcessQueue(Worker* worker);
 };
@@ -0,0 +1,48 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <string>
+
+namespace OpenRCT2
+{
+    /**
+     * A file mapped read-only into memory. Pages are only read from disk when they are first touched and are shared with
+     * every other process that maps the same file.
+     */
+    class MemoryMappedFile final
+    {
+    private:
+        const uint8_t* _data = nullptr;
+        uint64_t _length = 0;
+#ifdef _WIN32
+        void* _mapping = nullptr;
+#endif
+
+    public:
+        explicit MemoryMappedFile(const std::string& path);
+        ~MemoryMappedFile();
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        const uint8_t* GetData() const
+        {
+            return _data;
+        }
+
+        uint64_t GetLength() const
+        {
+            return _length;
+        }
+    };
+} // namespace OpenRCT2
@@ -13,11 +13,15 @@
 #include "Crypt.h"
 #include "FileStream.h"
 #include "Identifier.hpp"
+#include "JobPool.h"
+#include "Memory.hpp"
 #include "MemoryStream.h"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <exception>
 #include <fstream>
 #include <sstream>
 #include <stack>
@@ -37,8 +41,31 @@ namespace OpenRCT2
 
         static constexpr uint32_t COMPRESSION_NONE = 0;
         static constexpr uint32_t COMPRESSION_GZIP = 1;
+        // The uncompressed data is split into blocks that are gzipped independently, so they can be compressed and
+        // decompressed in parallel and a chunk can be read without decompressing the blocks around it.
+        static constexpr uint32_t COMPRESSION_GZIP_BLOCKS = 2;
+
+        static constexpr uint32_t DEFAULT_BLOCK_SIZE = 256 * 1024;
 
     private:
+        // Shared by every stream, starting a worker per hardware thread for each block table costs more than small saves.
+        static JobPool& GetBlockJobPool()
+        {
+            static JobPool pool;
+            return pool;
+        }
+
+        static void RethrowFirstError(const std::vector<std::exception_ptr>& errors)
+        {
+            for (const auto& error : errors)
+            {
+                if (error != nullptr)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+
 #pragma pack(push, 1)
         struct Header
         {
@@ -50,7 +77,9 @@ namespace OpenRCT2
             uint32_t Compression{};
             uint64_t CompressedSize{};
             std::array<uint8_t, 8> FNV1a{};
-            uint8_t padding[20];
+            uint32_t NumBlocks{};
+            uint32_t BlockSize{};
+            uint8_t padding[12];
         };
         static_assert(sizeof(Header) == 64, "Header should be 64 bytes");
 
@@ -60,20 +89,161 @@ namespace OpenRCT2
             uint64_t Offset{};
             uint64_t Length{};
         };
+
+        struct BlockEntry
+        {
+            // Offset of the compressed block from the start of the compressed data.
+            uint64_t Offset{};
+            uint32_t CompressedLength{};
+            uint32_t UncompressedLength{};
+        };
 #pragma pack(pop)
 
+    public:
+        /**
+         * The serialised chunks of a stream being written. They no longer refer to any game state, so they can be
+         * compressed and written out on another thread.
+         */
+        class PendingWrite
+        {
+        private:
+            friend class OrcaStream;
+
+            Header _header{};
+            std::vector<ChunkEntry> _chunks;
+            std::vector<BlockEntry> _blocks;
+            MemoryStream _buffer;
+
+        public:
+            void WriteTo(IStream& stream)
+            {
+                const void* uncompressedData = _buffer.GetData();
+                const uint64_t uncompressedSize = _buffer.GetLength();
+
+                _header.NumChunks = static_cast<uint32_t>(_chunks.size());
+                _header.UncompressedSize = uncompressedSize;
+                _header.CompressedSize = uncompressedSize;
+                _header.FNV1a = Crypt::FNV1a(uncompressedData, uncompressedSize);
+
+                // Compress data
+                std::optional<std::vector<uint8_t>> compressedBytes;
+                _blocks.clear();
+                _header.NumBlocks = 0;
+                _header.BlockSize = 0;
+                if (_header.Compression == COMPRESSION_GZIP_BLOCKS)
+                {
+                    _header.BlockSize = DEFAULT_BLOCK_SIZE;
+                    compressedBytes = GzipBlocks(uncompressedData, uncompressedSize);
+                    _header.NumBlocks = static_cast<uint32_t>(_blocks.size());
+                    _header.CompressedSize = compressedBytes->size();
+                }
+                else if (_header.Compression == COMPRESSION_GZIP)
+                {
+                    compressedBytes = Gzip(uncompressedData, uncompressedSize);
+                    if (compressedBytes)
+                    {
+                        _header.CompressedSize = compressedBytes->size();
+                    }
+                    else
+                    {
+                        // Compression failed
+                        _header.Compression = COMPRESSION_NONE;
+                    }
+                }
+
+                // Write header, chunk and block tables
+                stream.WriteValue(_header);
+                for (const auto& chunk : _chunks)
+                {
+                    stream.WriteValue(chunk);
+                }
+                for (const auto& block : _blocks)
+                {
+                    stream.WriteValue(block);
+                }
+
+                // Write chunk data
+                if (compressedBytes)
+                {
+                    stream.Write(compressedBytes->data(), compressedBytes->size());
+                }
+                else
+                {
+                    stream.Write(uncompressedData, uncompressedSize);
+                }
+            }
+
+        private:
+            std::vector<uint8_t> GzipBlocks(const void* data, const uint64_t dataLen)
+            {
+                const auto numBlocks = static_cast<size_t>((dataLen + _header.BlockSize - 1) / _header.BlockSize);
+                std::vector<std::vector<uint8_t>> compressedBlocks(numBlocks);
+                // Exceptions must not leave a worker, they are rethrown once all blocks are done.
+                std::vector<std::exception_ptr> errors(numBlocks);
+                auto compressBlocks = [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++)
+                    {
+                        const uint64_t offset = static_cast<uint64_t>(i) * _header.BlockSize;
+                        const auto length = static_cast<size_t>(std::min<uint64_t>(_header.BlockSize, dataLen - offset));
+                        try
+                        {
+                            compressedBlocks[i] = Gzip(static_cast<const uint8_t*>(data) + offset, length);
+                        }
+                        catch (...)
+                        {
+                            errors[i] = std::current_exception();
+                        }
+                    }
+                };
+                if (numBlocks > 1)
+                {
+                    GetBlockJobPool().ParallelFor(numBlocks, 1, compressBlocks);
+                }
+                else
+                {
+                    compressBlocks(0, numBlocks);
+                }
+                RethrowFirstError(errors);
+
+                std::vector<uint8_t> result;
+                for (size_t i = 0; i < numBlocks; i++)
+                {
+                    BlockEntry entry;
+                    entry.Offset = result.size();
+                    entry.CompressedLength = static_cast<uint32_t>(compressedBlocks[i].size());
+                    entry.UncompressedLength = static_cast<uint32_t>(
+                        std::min<uint64_t>(_header.BlockSize, dataLen - static_cast<uint64_t>(i) * _header.BlockSize));
+                    _blocks.push_back(entry);
+                    result.insert(result.end(), compressedBlocks[i].begin(), compressedBlocks[i].end());
+                }
+                return result;
+            }
+        };
+
+    private:
         IStream* _stream;
         Mode _mode;
         Header _header;
         std::vector<ChunkEntry> _chunks;
+        std::vector<BlockEntry> _blocks;
         MemoryStream _buffer;
         ChunkEntry _currentChunk;
 
+        // Only used when reading block compressed data on demand.
+        bool _onDemand{};
+        std::vector<uint8_t> _compressedData;
+        std::vector<uint8_t> _blocksInflated;
+
     public:
-        OrcaStream(IStream& stream, const Mode mode)
+        /**
+         * When onDemand is set, a stream being read only inflates the blocks of the chunks that are read. This only
+         * makes a difference for block compressed data, everything else is still inflated up front.
+         */
+        OrcaStream(IStream& stream, const Mode mode, bool onDemand = false)
         {
             _stream = &stream;
             _mode = mode;
+            _onDemand = onDemand && mode == Mode::READING;
             if (mode == Mode::READING)
             {
                 _header = _stream->ReadValue<Header>();
@@ -85,29 +255,40 @@ namespace OpenRCT2
                     _chunks.push_back(entry);
                 }
 
-                // Read compressed data into buffer (read in blocks)
-                _buffer = MemoryStream{};
-                uint8_t temp[2048];
-                uint64_t bytesLeft = _header.CompressedSize;
-                do
+                _blocks.clear();
+                if (_header.Compression == COMPRESSION_GZIP_BLOCKS)
                 {
-                    auto readLen = std::min(size_t(bytesLeft), sizeof(temp));
-                    _stream->Read(temp, readLen);
-                    _buffer.Write(temp, readLen);
-                    bytesLeft -= readLen;
-                } while (bytesLeft > 0);
+                    for (uint32_t i = 0; i < _header.NumBlocks; i++)
+                    {
+                        auto entry = _stream->ReadValue<BlockEntry>();
+                        _blocks.push_back(entry);
+                    }
+                }
+
+                std::vector<uint8_t> compressedData(static_cast<size_t>(_header.CompressedSize));
+                _stream->Read(compressedData.data(), compressedData.size());
 
                 // Uncompress
                 if (_header.Compression == COMPRESSION_GZIP)
                 {
-                    auto uncompressedData = Ungzip(_buffer.GetData(), _buffer.GetLength());
+                    auto uncompressedData = Ungzip(compressedData.data(), compressedData.size());
                     if (_header.UncompressedSize != uncompressedData.size())
                     {
                         // Warning?
                     }
-                    _buffer.Clear();
+                    _buffer = MemoryStream{};
                     _buffer.Write(uncompressedData.data(), uncompressedData.size());
                 }
+                else if (_header.Compression == COMPRESSION_GZIP_BLOCKS)
+                {
+                    _compressedData = std::move(compressedData);
+                    UngzipBlocks();
+                }
+                else
+                {
+                    _buffer = MemoryStream{};
+                    _buffer.Write(compressedData.data(), compressedData.size());
+                }
             }
             else
             {
@@ -118,55 +299,44 @@ namespace OpenRCT2
             }
         }
 
+        /**
+         * Creates a stream for writing that is not attached to any output, its chunks are taken with Detach.
+         */
+        OrcaStream()
+        {
+            _stream = nullptr;
+            _mode = Mode::WRITING;
+            _header = {};
+            _header.Compression = COMPRESSION_GZIP;
+        }
+
         OrcaStream(const OrcaStream&) = delete;
 
         ~OrcaStream()
         {
-            if (_mode == Mode::WRITING)
+            if (_mode == Mode::WRITING && _stream != nullptr)
             {
-                const void* uncompressedData = _buffer.GetData();
-                const uint64_t uncompressedSize = _buffer.GetLength();
-
-                _header.NumChunks = static_cast<uint32_t>(_chunks.size());
-                _header.UncompressedSize = uncompressedSize;
-                _header.CompressedSize = uncompressedSize;
-                _header.FNV1a = Crypt::FNV1a(uncompressedData, uncompressedSize);
-
-                // Compress data
-                std::optional<std::vector<uint8_t>> compressedBytes;
-                if (_header.Compression == COMPRESSION_GZIP)
-                {
-                    compressedBytes = Gzip(uncompressedData, uncompressedSize);
-                    if (compressedBytes)
-                    {
-                        _header.CompressedSize = compressedBytes->size();
-                    }
-                    else
-                    {
-                        // Compression failed
-                        _header.Compression = COMPRESSION_NONE;
-                    }
-                }
-
-                // Write header and chunk table
-                _stream->WriteValue(_header);
-                for (const auto& chunk : _chunks)
-                {
-                    _stream->WriteValue(chunk);
-                }
-
-                // Write chunk data
-                if (compressedBytes)
-                {
-                    _stream->Write(compressedBytes->data(), compressedBytes->size());
-                }
-                else
-                {
-                    _stream->Write(uncompressedData, uncompressedSize);
-                }
+                // Detach forgets the stream, so it has to be taken first.
+                auto* stream = _stream;
+                Detach().WriteTo(*stream);
             }
         }
 
+        /**
+         * Takes the chunks written so far, nothing is written to the stream when this stream is destroyed.
+         */
+        PendingWrite Detach()
+        {
+            PendingWrite result;
+            result._header = _header;
+            result._chunks = std::move(_chunks);
+            result._buffer = std::move(_buffer);
+            _chunks = {};
+            _buffer = MemoryStream{};
+            _stream = nullptr;
+            return result;
+        }
+
         Mode GetMode() const
         {
             return _mode;
@@ -207,12 +377,114 @@ namespace OpenRCT2
         }
 
     private:
+        void UngzipBlocks()
+        {
+            const auto uncompressedSize = static_cast<size_t>(_header.UncompressedSize);
+            uint64_t expectedSize = 0;
+            for (size_t i = 0; i < _blocks.size(); i++)
+            {
+                // Every block but the last one holds exactly BlockSize bytes.
+                const auto& block = _blocks[i];
+                const bool isLast = i == _blocks.size() - 1;
+                const bool validLength = isLast ? block.UncompressedLength <= _header.BlockSize
+                                                : block.UncompressedLength == _header.BlockSize;
+                // Compared by subtraction so a corrupt offset cannot wrap the sum around.
+                const bool validExtent = block.Offset <= _compressedData.size()
+                    && block.CompressedLength <= _compressedData.size() - block.Offset;
+                if (!validExtent || block.UncompressedLength == 0 || !validLength)
+                {
+                    throw IOException("Invalid block table.");
+                }
+                expectedSize += block.UncompressedLength;
+            }
+            if (expectedSize != _header.UncompressedSize)
+            {
+                throw IOException("Invalid block table.");
+            }
+
+            auto* uncompressedData = Memory::Allocate<uint8_t>(uncompressedSize);
+            _buffer = MemoryStream(
+                uncompressedData, uncompressedSize, MEMORY_ACCESS::READ | MEMORY_ACCESS::WRITE | MEMORY_ACCESS::OWNER);
+            _blocksInflated.assign(_blocks.size(), 0);
+            if (_onDemand)
+            {
+                return;
+            }
+
+            std::atomic<bool> failed = false;
+            // Exceptions must not leave a worker, they are rethrown once all blocks are done.
+            std::vector<std::exception_ptr> errors(_blocks.size());
+            auto decompressBlocks = [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                {
+                    try
+                    {
+                        if (!UngzipBlock(i))
+                        {
+                            failed = true;
+                        }
+                    }
+                    catch (...)
+                    {
+                        errors[i] = std::current_exception();
+                    }
+                }
+            };
+            if (_blocks.size() > 1)
+            {
+                GetBlockJobPool().ParallelFor(_blocks.size(), 1, decompressBlocks);
+            }
+            else
+            {
+                decompressBlocks(0, _blocks.size());
+            }
+            RethrowFirstError(errors);
+            if (failed)
+            {
+                throw IOException("Block decompressed to an unexpected size.");
+            }
+            _compressedData = {};
+        }
+
+        bool UngzipBlock(size_t index)
+        {
+            const auto& block = _blocks[index];
+            // Stops inflating as soon as the block grows past its size instead of after the whole block.
+            auto blockData = Ungzip(_compressedData.data() + block.Offset, block.CompressedLength, block.UncompressedLength);
+            if (blockData.size() != block.UncompressedLength)
+            {
+                return false;
+            }
+
+            auto* dst = static_cast<uint8_t*>(const_cast<void*>(_buffer.GetData())) + index * size_t{ _header.BlockSize };
+            std::copy(blockData.begin(), blockData.end(), dst);
+            _blocksInflated[index] = 1;
+            return true;
+        }
+
+        void UngzipRange(uint64_t offset, uint64_t length)
+        {
+            if (!_onDemand || _blocksInflated.empty() || length == 0)
+                return;
+
+            const auto first = static_cast<size_t>(offset / _header.BlockSize);
+            const auto last = std::min(static_cast<size_t>((offset + length - 1) / _header.BlockSize), _blocks.size() - 1);
+            for (size_t i = first; i <= last; i++)
+            {
+                if (!_blocksInflated[i] && !UngzipBlock(i))
+                {
+                    throw IOException("Block decompressed to an unexpected size.");
+                }
+            }
+        }
+
         bool SeekChunk(const uint32_t id)
         {
             const auto result = std::find_if(_chunks.begin(), _chunks.end(), [id](const ChunkEntry& e) { return e.Id == id; });
             if (result != _chunks.end())
             {
                 const auto offset = result->Offset;
+                UngzipRange(offset, result->Length);
                 _buffer.SetPosition(offset);
                 return true;
             }
@@ -14,6 +14,7 @@
 #include "../PlatformEnvironment.h"
 #include "../config/Config.h"
 #include "../core/FileStream.h"
+#include "../core/MemoryMappedFile.h"
 #include "../core/Path.hpp"
 #include "../platform/platform.h"
 #include "../sprites.h"
@@ -22,6 +23,7 @@
 #include "ScrollingText.h"
 
 #include <algorithm>
+#include <cstring>
 #include <memory>
 #include <stdexcept>
 #include <vector>
@@ -69,10 +71,8 @@ static inline uint32_t rctc_to_rct2_index(uint32_t image)
 }
 // clang-format on
 
-static void read_and_convert_gxdat(IStream* stream, size_t count, bool is_rctc, rct_g1_element* elements)
+static void convert_gxdat(const rct_g1_element_32bit* g1Elements32, size_t count, bool is_rctc, rct_g1_element* elements)
 {
-    auto g1Elements32 = std::make_unique<rct_g1_element_32bit[]>(count);
-    stream->Read(g1Elements32.get(), count * sizeof(rct_g1_element_32bit));
     if (is_rctc)
     {
         // Process RCTC's g1.dat file
@@ -189,6 +189,77 @@ static rct_g1_element _g1Temp = {};
 static std::vector<rct_g1_element> _imageListElements;
 bool gTinyFontAntiAliased = false;
 
+/**
+ * Maps a graphics file read-only, so sprite pixels are only read from disk once they are drawn and the page cache is
+ * shared by every instance running on the machine. Falls back to reading the whole file into memory.
+ */
+static std::shared_ptr<const uint8_t> open_gx_file(const std::string& path, uint64_t& length)
+{
+    try
+    {
+        auto file = std::make_shared<MemoryMappedFile>(path);
+        length = file->GetLength();
+        return std::shared_ptr<const uint8_t>(file, file->GetData());
+    }
+    catch (const std::exception& e)
+    {
+        log_verbose("Unable to map %s, reading it instead: %s", path.c_str(), e.what());
+    }
+
+    auto fs = FileStream(path, FILE_MODE_OPEN);
+    length = fs.GetLength();
+    auto data = fs.ReadArray<uint8_t>(length);
+    return std::shared_ptr<const uint8_t>(data.release(), std::default_delete<uint8_t[]>());
+}
+
+/**
+ * Converts the element table of a graphics file and points the elements at their pixels, the pixel data itself is
+ * neither copied nor touched.
+ */
+static void load_gx(
+    rct_gx& gx, const std::shared_ptr<const uint8_t>& elementFile, uint64_t elementsOffset, bool is_rctc,
+    const std::shared_ptr<const uint8_t>& dataFile, uint64_t dataOffset)
+{
+    const auto* g1Elements32 = reinterpret_cast<const rct_g1_element_32bit*>(elementFile.get() + elementsOffset);
+    gx.elements.resize(gx.header.num_entries);
+    convert_gxdat(g1Elements32, gx.header.num_entries, is_rctc, gx.elements.data());
+
+    gx.data = std::shared_ptr<const uint8_t>(dataFile, dataFile.get() + dataOffset);
+
+    // Fix entry data offsets
+    for (uint32_t i = 0; i < gx.header.num_entries; i++)
+    {
+        gx.elements[i].offset += reinterpret_cast<uintptr_t>(gx.data.get());
+    }
+}
+
+// Reads a g1.dat style file, the header is followed by the element table and the pixel data.
+static void load_gx_file(rct_gx& gx, const std::string& path, bool allowRctc, bool* is_rctc = nullptr)
+{
+    uint64_t length = 0;
+    auto file = open_gx_file(path, length);
+    if (length < sizeof(rct_g1_header))
+    {
+        throw std::runtime_error("Graphics file is truncated");
+    }
+    std::memcpy(&gx.header, file.get(), sizeof(rct_g1_header));
+
+    log_verbose("%s, number of entries: %u", path.c_str(), gx.header.num_entries);
+
+    const uint64_t elementsSize = static_cast<uint64_t>(gx.header.num_entries) * sizeof(rct_g1_element_32bit);
+    if (sizeof(rct_g1_header) + elementsSize + gx.header.total_size > length)
+    {
+        throw std::runtime_error("Graphics file is truncated");
+    }
+
+    const bool rctc = allowRctc && gx.header.num_entries == SPR_RCTC_G1_END;
+    if (is_rctc != nullptr)
+    {
+        *is_rctc = rctc;
+    }
+    load_gx(gx, file, sizeof(rct_g1_header), rctc, file, sizeof(rct_g1_header) + elementsSize);
+}
+
 /**
  *
  *  rct2: 0x00678998
@@ -199,34 +270,18 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
     try
     {
         auto path = Path::Combine(env.GetDirectoryPath(DIRBASE::RCT2, DIRID::DATA), "g1.dat");
-        auto fs = FileStream(path, FILE_MODE_OPEN);
-        _g1.header = fs.ReadValue<rct_g1_header>();
-
-        log_verbose("g1.dat, number of entries: %u", _g1.header.num_entries);
-
+        bool is_rctc = false;
+        load_gx_file(_g1, path, true, &is_rctc);
         if (_g1.header.num_entries < SPR_G1_END)
         {
             throw std::runtime_error("Not enough elements in g1.dat");
         }
-
-        // Read element headers
-        bool is_rctc = _g1.header.num_entries == SPR_RCTC_G1_END;
-        _g1.elements.resize(_g1.header.num_entries);
-        read_and_convert_gxdat(&fs, _g1.header.num_entries, is_rctc, _g1.elements.data());
         gTinyFontAntiAliased = is_rctc;
-
-        // Read element data
-        _g1.data = fs.ReadArray<uint8_t>(_g1.header.total_size);
-
-        // Fix entry data offsets
-        for (uint32_t i = 0; i < _g1.header.num_entries; i++)
-        {
-            _g1.elements[i].offset += reinterpret_cast<uintptr_t>(_g1.data.get());
-        }
         return true;
     }
     catch (const std::exception&)
     {
+        _g1.data.reset();
         _g1.elements.clear();
         _g1.elements.shrink_to_fit();
 
@@ -271,25 +326,12 @@ bool gfx_load_g2()
     safe_strcat_path(path, "g2.dat", MAX_PATH);
     try
     {
-        auto fs = FileStream(path, FILE_MODE_OPEN);
-        _g2.header = fs.ReadValue<rct_g1_header>();
-
-        // Read element headers
-        _g2.elements.resize(_g2.header.num_entries);
-        read_and_convert_gxdat(&fs, _g2.header.num_entries, false, _g2.elements.data());
-
-        // Read element data
-        _g2.data = fs.ReadArray<uint8_t>(_g2.header.total_size);
-
-        // Fix entry data offsets
-        for (uint32_t i = 0; i < _g2.header.num_entries; i++)
-        {
-            _g2.elements[i].offset += reinterpret_cast<uintptr_t>(_g2.data.get());
-        }
+        load_gx_file(_g2, path, false);
         return true;
     }
     catch (const std::exception&)
     {
+        _g2.data.reset();
         _g2.elements.clear();
         _g2.elements.shrink_to_fit();
 
@@ -317,10 +359,10 @@ bool gfx_load_csg()
     auto pathDataPath = FindCsg1datAtLocation(gConfigGeneral.rct1_path);
     try
     {
-        auto fileHeader = FileStream(pathHeaderPath, FILE_MODE_OPEN);
-        auto fileData = FileStream(pathDataPath, FILE_MODE_OPEN);
-        size_t fileHeaderSize = fileHeader.GetLength();
-        size_t fileDataSize = fileData.GetLength();
+        uint64_t fileHeaderSize = 0;
+        uint64_t fileDataSize = 0;
+        auto fileHeader = open_gx_file(pathHeaderPath, fileHeaderSize);
+        auto fileData = open_gx_file(pathDataPath, fileDataSize);
 
         _csg.header.num_entries = static_cast<uint32_t>(fileHeaderSize / sizeof(rct_g1_element_32bit));
         _csg.header.total_size = static_cast<uint32_t>(fileDataSize);
@@ -331,17 +373,10 @@ bool gfx_load_csg()
             return false;
         }
 
-        // Read element headers
-        _csg.elements.resize(_csg.header.num_entries);
-        read_and_convert_gxdat(&fileHeader, _csg.header.num_entries, false, _csg.elements.data());
-
-        // Read element data
-        _csg.data = fileData.ReadArray<uint8_t>(_csg.header.total_size);
-
-        // Fix entry data offsets
+        // The element table is only needed while converting, the pixel data stays mapped.
+        load_gx(_csg, fileHeader, 0, false, fileData, 0);
         for (uint32_t i = 0; i < _csg.header.num_entries; i++)
         {
-            _csg.elements[i].offset += reinterpret_cast<uintptr_t>(_csg.data.get());
             // RCT1 used zoomed offsets that counted from the beginning of the file, rather than from the current sprite.
             if (_csg.elements[i].flags & G1_FLAG_HAS_ZOOM_SPRITE)
             {
@@ -353,6 +388,7 @@ bool gfx_load_csg()
     }
     catch (const std::exception&)
     {
+        _csg.data.reset();
         _csg.elements.clear();
         _csg.elements.shrink_to_fit();
 
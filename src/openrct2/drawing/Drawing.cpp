@@ -13,6 +13,7 @@
 #include "../OpenRCT2.h"
 #include "../common.h"
 #include "../core/Guard.hpp"
+#include "../interface/Viewport.h"
 #include "../object/Object.h"
 #include "../platform/platform.h"
 #include "../sprites.h"
@@ -651,6 +652,7 @@ void load_palette()
  */
 void gfx_invalidate_screen()
 {
+    viewport_paint_cache_invalidate_all();
     gfx_set_dirty_blocks({ { 0, 0 }, { context_get_width(), context_get_height() } });
 }
 
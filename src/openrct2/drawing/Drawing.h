@@ -99,7 +99,8 @@ struct rct_gx
 {
     rct_g1_header header;
     std::vector<rct_g1_element> elements;
-    std::unique_ptr<uint8_t[]> data;
+    // Pixel data, usually a read-only view into the memory-mapped file.
+    std::shared_ptr<const uint8_t> data;
 };
 
 struct rct_drawpixelinfo
@@ -491,6 +492,8 @@ extern bool gTinyFontAntiAliased;
 bool clip_drawpixelinfo(
     rct_drawpixelinfo* dst, rct_drawpixelinfo* src, const ScreenCoordsXY& coords, int32_t width, int32_t height);
 void gfx_set_dirty_blocks(const ScreenRect& rect);
+// Collects dirty blocks set on the calling thread into rects, nullptr forwards them to the drawing engine again.
+void gfx_defer_dirty_blocks(std::vector<ScreenRect>* rects);
 void gfx_invalidate_screen();
 
 // palette
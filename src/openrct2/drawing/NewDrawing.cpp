@@ -151,8 +151,17 @@ void drawing_engine_set_vsync(bool vsync)
     }
 }
 
+// Drawing engines are not thread safe, logic running on worker threads hands its invalidations back this way.
+static thread_local std::vector<ScreenRect>* _deferredDirtyBlocks;
+
 void gfx_set_dirty_blocks(const ScreenRect& rect)
 {
+    if (_deferredDirtyBlocks != nullptr)
+    {
+        _deferredDirtyBlocks->push_back(rect);
+        return;
+    }
+
     auto drawingEngine = GetDrawingEngine();
     if (drawingEngine != nullptr)
     {
@@ -160,6 +169,11 @@ void gfx_set_dirty_blocks(const ScreenRect& rect)
     }
 }
 
+void gfx_defer_dirty_blocks(std::vector<ScreenRect>* rects)
+{
+    _deferredDirtyBlocks = rects;
+}
+
 void gfx_clear(rct_drawpixelinfo* dpi, uint8_t paletteIndex)
 {
     auto drawingEngine = dpi->DrawingEngine;
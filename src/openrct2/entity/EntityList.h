@@ -15,27 +15,26 @@
 #include "EntityBase.h"
 #include "EntityRegistry.h"
 
-#include <list>
+#include <algorithm>
 #include <vector>
 
-const std::list<uint16_t>& GetEntityList(const EntityType id);
+const std::vector<uint16_t>& GetEntityList(const EntityType id);
 
 uint16_t GetEntityListCount(EntityType list);
 uint16_t GetMiscEntityCount();
 uint16_t GetNumFreeEntities();
-const std::vector<uint16_t>& GetEntityTileList(const CoordsXY& spritePos);
+uint16_t GetFirstEntityOnTile(const CoordsXY& spritePos);
+uint16_t GetNextEntityOnTile(uint16_t entityIndex);
 
 template<typename T> class EntityTileIterator
 {
 private:
-    std::vector<uint16_t>::const_iterator iter;
-    std::vector<uint16_t>::const_iterator end;
+    uint16_t nextIndex;
     T* Entity = nullptr;
 
 public:
-    EntityTileIterator(std::vector<uint16_t>::const_iterator _iter, std::vector<uint16_t>::const_iterator _end)
-        : iter(_iter)
-        , end(_end)
+    EntityTileIterator(uint16_t firstIndex)
+        : nextIndex(firstIndex)
     {
         ++(*this);
     }
@@ -43,9 +42,11 @@ public:
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        while (nextIndex != SPRITE_INDEX_NULL && Entity == nullptr)
         {
-            Entity = GetEntity<T>(*iter++);
+            const uint16_t index = nextIndex;
+            nextIndex = GetNextEntityOnTile(index);
+            Entity = GetEntity<T>(index);
         }
         return *this;
     }
@@ -54,7 +55,7 @@ public:
     {
         EntityTileIterator retval = *this;
         ++(*this);
-        return *iter;
+        return retval;
     }
     bool operator==(EntityTileIterator other) const
     {
@@ -79,35 +80,83 @@ public:
 template<typename T = EntityBase> class EntityTileList
 {
 private:
-    const std::vector<uint16_t>& vec;
+    uint16_t firstIndex;
 
 public:
     EntityTileList(const CoordsXY& loc)
-        : vec(GetEntityTileList(loc))
+        : firstIndex(GetFirstEntityOnTile(loc))
     {
     }
 
     EntityTileIterator<T> begin()
     {
-        return EntityTileIterator<T>(std::begin(vec), std::end(vec));
+        return EntityTileIterator<T>(firstIndex);
     }
     EntityTileIterator<T> end()
     {
-        return EntityTileIterator<T>(std::end(vec), std::end(vec));
+        return EntityTileIterator<T>(SPRITE_INDEX_NULL);
+    }
+};
+
+/**
+ * Walks a per type entity list, which is a vector sorted by sprite index. Entities are created and removed
+ * while the lists are being walked, so the cursor behaves like an iterator of a linked list would: the
+ * entity to visit next is picked when the current one is handed out and is found again by its index.
+ * Entities added or removed while the current one is processed never change the order of the walk.
+ */
+class EntityListCursor
+{
+private:
+    const std::vector<uint16_t>* _list;
+    size_t _nextPos = 0;
+    uint16_t _nextIndex = SPRITE_INDEX_NULL;
+
+public:
+    EntityListCursor(const std::vector<uint16_t>& list, bool atEnd)
+        : _list(&list)
+    {
+        if (!atEnd && !list.empty())
+        {
+            _nextIndex = list.front();
+        }
+    }
+
+    bool AtEnd() const
+    {
+        return _nextIndex == SPRITE_INDEX_NULL;
+    }
+
+    uint16_t Next()
+    {
+        const uint16_t current = _nextIndex;
+        const auto& list = *_list;
+
+        // The entity is usually where it was, unless entities before it came or went in the meantime.
+        size_t pos = _nextPos;
+        if (pos >= list.size() || list[pos] != current)
+        {
+            pos = std::lower_bound(std::begin(list), std::end(list), current) - std::begin(list);
+        }
+        if (pos < list.size() && list[pos] == current)
+        {
+            pos++;
+        }
+
+        _nextPos = pos;
+        _nextIndex = pos < list.size() ? list[pos] : SPRITE_INDEX_NULL;
+        return current;
     }
 };
 
 template<typename T> class EntityListIterator
 {
 private:
-    std::list<uint16_t>::const_iterator iter;
-    std::list<uint16_t>::const_iterator end;
+    EntityListCursor cursor;
     T* Entity = nullptr;
 
 public:
-    EntityListIterator(std::list<uint16_t>::const_iterator _iter, std::list<uint16_t>::const_iterator _end)
-        : iter(_iter)
-        , end(_end)
+    EntityListIterator(const std::vector<uint16_t>& list, bool atEnd)
+        : cursor(list, atEnd)
     {
         ++(*this);
     }
@@ -115,9 +164,9 @@ public:
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        while (!cursor.AtEnd() && Entity == nullptr)
         {
-            Entity = GetEntity<T>(*iter++);
+            Entity = GetEntity<T>(cursor.Next());
         }
         return *this;
     }
@@ -126,7 +175,7 @@ public:
     {
         EntityListIterator retval = *this;
         ++(*this);
-        return *iter;
+        return retval;
     }
     bool operator==(EntityListIterator other) const
     {
@@ -152,7 +201,7 @@ template<typename T = EntityBase> class EntityList
 {
 private:
     using EntityListIterator_t = EntityListIterator<T>;
-    const std::list<uint16_t>& vec;
+    const std::vector<uint16_t>& vec;
 
 public:
     EntityList()
@@ -162,10 +211,10 @@ public:
 
     EntityListIterator_t begin() const
     {
-        return EntityListIterator_t(std::cbegin(vec), std::cend(vec));
+        return EntityListIterator_t(vec, false);
     }
     EntityListIterator_t end() const
     {
-        return EntityListIterator_t(std::cend(vec), std::cend(vec));
+        return EntityListIterator_t(vec, true);
     }
 };
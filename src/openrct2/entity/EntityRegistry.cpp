@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iterator>
 #include <numeric>
 #include <vector>
@@ -45,7 +46,7 @@ union Entity
 };
 
 static Entity _entities[MAX_ENTITIES]{};
-static std::array<std::list<uint16_t>, EnumValue(EntityType::Count)> gEntityLists;
+static std::array<std::vector<uint16_t>, EnumValue(EntityType::Count)> gEntityLists;
 static std::vector<uint16_t> _freeIdList;
 
 static bool _entityFlashingList[MAX_ENTITIES];
@@ -53,7 +54,14 @@ static bool _entityFlashingList[MAX_ENTITIES];
 constexpr const uint32_t SPATIAL_INDEX_SIZE = (MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL) + 1;
 constexpr const uint32_t SPATIAL_INDEX_LOCATION_NULL = SPATIAL_INDEX_SIZE - 1;
 
-static std::array<std::vector<uint16_t>, SPATIAL_INDEX_SIZE> gEntitySpatialIndex;
+// The spatial index is made of intrusive lists, one per tile plus one for the entities without a location. Each
+// entity links to the next entity on its tile, lists are kept in sprite index order. Only the list heads depend
+// on the size of the map, they grow with it as entities are placed further out.
+static std::vector<uint16_t> _entitySpatialHeads;
+static int32_t _entitySpatialSize;
+static uint16_t _entitySpatialNullHead = SPRITE_INDEX_NULL;
+static uint16_t _entitySpatialNext[MAX_ENTITIES];
+static uint32_t _entitySpatialOffset[MAX_ENTITIES];
 
 static void FreeEntity(EntityBase& entity);
 
@@ -116,6 +124,62 @@ std::string EntitiesChecksum::ToString() const
     return result;
 }
 
+static constexpr EntityType EntityChecksumTypes[ENTITY_CHECKSUM_TYPE_COUNT] = {
+    EntityType::Guest,
+    EntityType::Staff,
+    EntityType::Vehicle,
+    EntityType::Litter,
+};
+static constexpr const char* EntityChecksumTypeNames[ENTITY_CHECKSUM_TYPE_COUNT] = {
+    "Guest",
+    "Staff",
+    "Vehicle",
+    "Litter",
+};
+
+static constexpr size_t EntityChecksumBlockSize = (MAX_ENTITIES + ENTITY_CHECKSUM_BLOCK_COUNT - 1)
+    / ENTITY_CHECKSUM_BLOCK_COUNT;
+
+bool EntitiesSliceChecksum::operator==(const EntitiesSliceChecksum& other) const
+{
+    return Slice == other.Slice && Types == other.Types && Blocks == other.Blocks;
+}
+
+bool EntitiesSliceChecksum::operator!=(const EntitiesSliceChecksum& other) const
+{
+    return !(*this == other);
+}
+
+std::string EntitiesSliceChecksum::DescribeMismatch(const EntitiesSliceChecksum& other) const
+{
+    std::string result = "types:";
+    for (size_t i = 0; i < ENTITY_CHECKSUM_TYPE_COUNT; i++)
+    {
+        if (Types[i] != other.Types[i])
+        {
+            result += ' ';
+            result += EntityChecksumTypeNames[i];
+        }
+    }
+
+    char buf[64];
+    snprintf(
+        buf, sizeof(buf), ", indices %% %u == %u in:", static_cast<uint32_t>(ENTITY_CHECKSUM_SLICE_COUNT),
+        static_cast<uint32_t>(Slice));
+    result += buf;
+    for (size_t i = 0; i < ENTITY_CHECKSUM_BLOCK_COUNT; i++)
+    {
+        if (Blocks[i] != other.Blocks[i])
+        {
+            const auto last = std::min<size_t>((i + 1) * EntityChecksumBlockSize, MAX_ENTITIES) - 1;
+            const auto first = i * EntityChecksumBlockSize;
+            snprintf(buf, sizeof(buf), " %u-%u", static_cast<uint32_t>(first), static_cast<uint32_t>(last));
+            result += buf;
+        }
+    }
+    return result;
+}
+
 EntityBase* TryGetEntity(size_t entityIndex)
 {
     return entityIndex >= MAX_ENTITIES ? nullptr : &_entities[entityIndex].base;
@@ -131,9 +195,44 @@ EntityBase* GetEntity(size_t entityIndex)
     return TryGetEntity(entityIndex);
 }
 
-const std::vector<uint16_t>& GetEntityTileList(const CoordsXY& spritePos)
+static void ResizeEntitySpatialHeads(int32_t size)
+{
+    std::vector<uint16_t> heads(static_cast<size_t>(size) * size, SPRITE_INDEX_NULL);
+    for (int32_t tileX = 0; tileX < std::min(size, _entitySpatialSize); tileX++)
+    {
+        std::copy_n(
+            _entitySpatialHeads.begin() + tileX * _entitySpatialSize, std::min(size, _entitySpatialSize),
+            heads.begin() + tileX * size);
+    }
+    _entitySpatialHeads = std::move(heads);
+    _entitySpatialSize = size;
+}
+
+static uint16_t* GetSpatialHead(size_t offset, bool grow)
+{
+    if (offset == SPATIAL_INDEX_LOCATION_NULL)
+        return &_entitySpatialNullHead;
+
+    const auto tileX = static_cast<int32_t>(offset / MAXIMUM_MAP_SIZE_TECHNICAL);
+    const auto tileY = static_cast<int32_t>(offset % MAXIMUM_MAP_SIZE_TECHNICAL);
+    if (tileX >= _entitySpatialSize || tileY >= _entitySpatialSize)
+    {
+        if (!grow)
+            return nullptr;
+        ResizeEntitySpatialHeads(std::max(tileX, tileY) + 1);
+    }
+    return &_entitySpatialHeads[tileX * _entitySpatialSize + tileY];
+}
+
+uint16_t GetFirstEntityOnTile(const CoordsXY& spritePos)
+{
+    const auto* head = GetSpatialHead(GetSpatialIndexOffset(spritePos), false);
+    return head != nullptr ? *head : SPRITE_INDEX_NULL;
+}
+
+uint16_t GetNextEntityOnTile(uint16_t entityIndex)
 {
-    return gEntitySpatialIndex[GetSpatialIndexOffset(spritePos)];
+    return _entitySpatialNext[entityIndex];
 }
 
 static void ResetEntityLists()
@@ -153,7 +252,7 @@ static void ResetFreeIds()
     std::iota(std::rbegin(_freeIdList), std::rend(_freeIdList), 0);
 }
 
-const std::list<uint16_t>& GetEntityList(const EntityType id)
+const std::vector<uint16_t>& GetEntityList(const EntityType id)
 {
     return gEntityLists[EnumValue(id)];
 }
@@ -198,6 +297,7 @@ void ResetAllEntities()
 }
 
 static void EntitySpatialInsert(EntityBase* entity, const CoordsXY& newLoc);
+static void EntitySpatialRemove(EntityBase* entity);
 
 /**
  *
@@ -207,10 +307,12 @@ static void EntitySpatialInsert(EntityBase* entity, const CoordsXY& newLoc);
  */
 void ResetEntitySpatialIndices()
 {
-    for (auto& vec : gEntitySpatialIndex)
-    {
-        vec.clear();
-    }
+    _entitySpatialHeads.clear();
+    _entitySpatialSize = 0;
+    ResizeEntitySpatialHeads(std::clamp(gMapSize, 0, MAXIMUM_MAP_SIZE_TECHNICAL));
+    _entitySpatialNullHead = SPRITE_INDEX_NULL;
+    std::fill(std::begin(_entitySpatialNext), std::end(_entitySpatialNext), SPRITE_INDEX_NULL);
+    std::fill(std::begin(_entitySpatialOffset), std::end(_entitySpatialOffset), SPATIAL_INDEX_SIZE);
     for (size_t i = 0; i < MAX_ENTITIES; i++)
     {
         auto* spr = GetEntity(i);
@@ -246,6 +348,74 @@ EntitiesChecksum GetAllEntitiesChecksum()
 
     return checksum;
 }
+
+template<typename T> static uint64_t GetEntityHash(uint16_t index)
+{
+    auto* entity = GetEntity<T>(index);
+    if (entity == nullptr)
+        return 0;
+
+    std::array<std::byte, 20> raw{};
+    OpenRCT2::ChecksumStream ms(raw);
+    DataSerialiser ds(true, ms);
+    entity->Serialise(ds);
+
+    uint64_t hash;
+    std::memcpy(&hash, raw.data(), sizeof(hash));
+    return hash;
+}
+
+static uint64_t CombineEntityHash(uint64_t combined, uint64_t hash)
+{
+    return (combined ^ hash) * 0x00000100000001B3ULL;
+}
+
+static uint32_t FoldEntityHash(uint64_t hash)
+{
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+EntitiesSliceChecksum GetEntitiesSliceChecksum(uint16_t slice)
+{
+    std::array<uint64_t, ENTITY_CHECKSUM_TYPE_COUNT> types{};
+    std::array<uint64_t, ENTITY_CHECKSUM_BLOCK_COUNT> blocks{};
+    for (size_t typeIndex = 0; typeIndex < ENTITY_CHECKSUM_TYPE_COUNT; typeIndex++)
+    {
+        const EntityType type = EntityChecksumTypes[typeIndex];
+        for (auto index : GetEntityList(type))
+        {
+            if (index % ENTITY_CHECKSUM_SLICE_COUNT != slice)
+                continue;
+
+            uint64_t hash = 0;
+            switch (type)
+            {
+                case EntityType::Guest:
+                    hash = GetEntityHash<Guest>(index);
+                    break;
+                case EntityType::Staff:
+                    hash = GetEntityHash<Staff>(index);
+                    break;
+                case EntityType::Vehicle:
+                    hash = GetEntityHash<Vehicle>(index);
+                    break;
+                default:
+                    hash = GetEntityHash<Litter>(index);
+                    break;
+            }
+            types[typeIndex] = CombineEntityHash(types[typeIndex], hash);
+            auto& block = blocks[index / EntityChecksumBlockSize];
+            block = CombineEntityHash(block, hash);
+        }
+    }
+
+    EntitiesSliceChecksum checksum{};
+    checksum.Slice = slice;
+    std::transform(types.begin(), types.end(), checksum.Types.begin(), FoldEntityHash);
+    std::transform(blocks.begin(), blocks.end(), checksum.Blocks.begin(), FoldEntityHash);
+    return checksum;
+}
+
 #else
 
 EntitiesChecksum GetAllEntitiesChecksum()
@@ -253,6 +423,13 @@ EntitiesChecksum GetAllEntitiesChecksum()
     return EntitiesChecksum{};
 }
 
+EntitiesSliceChecksum GetEntitiesSliceChecksum(uint16_t slice)
+{
+    EntitiesSliceChecksum checksum{};
+    checksum.Slice = slice;
+    return checksum;
+}
+
 #endif // DISABLE_NETWORK
 
 static void EntityReset(EntityBase* entity)
@@ -403,20 +580,36 @@ void UpdateAllMiscEntities()
 // Performs a search to ensure that insert keeps next_in_quadrant in sprite_index order
 static void EntitySpatialInsert(EntityBase* entity, const CoordsXY& newLoc)
 {
-    size_t newIndex = GetSpatialIndexOffset(newLoc);
-    auto& spatialVector = gEntitySpatialIndex[newIndex];
-    auto index = std::lower_bound(std::begin(spatialVector), std::end(spatialVector), entity->sprite_index);
-    spatialVector.insert(index, entity->sprite_index);
+    // An entity is only ever on one list. A failed removal rebuilds the index with the entity at its old position.
+    while (_entitySpatialOffset[entity->sprite_index] < SPATIAL_INDEX_SIZE)
+    {
+        EntitySpatialRemove(entity);
+    }
+
+    const size_t newIndex = GetSpatialIndexOffset(newLoc);
+    uint16_t* link = GetSpatialHead(newIndex, true);
+    while (*link != SPRITE_INDEX_NULL && *link < entity->sprite_index)
+    {
+        link = &_entitySpatialNext[*link];
+    }
+    _entitySpatialNext[entity->sprite_index] = *link;
+    *link = entity->sprite_index;
+    _entitySpatialOffset[entity->sprite_index] = static_cast<uint32_t>(newIndex);
 }
 
 static void EntitySpatialRemove(EntityBase* entity)
 {
-    size_t currentIndex = GetSpatialIndexOffset({ entity->x, entity->y });
-    auto& spatialVector = gEntitySpatialIndex[currentIndex];
-    auto index = std::lower_bound(std::begin(spatialVector), std::end(spatialVector), entity->sprite_index);
-    if (index != std::end(spatialVector) && *index == entity->sprite_index)
+    const size_t currentIndex = _entitySpatialOffset[entity->sprite_index];
+    uint16_t* link = currentIndex < SPATIAL_INDEX_SIZE ? GetSpatialHead(currentIndex, false) : nullptr;
+    while (link != nullptr && *link != SPRITE_INDEX_NULL && *link < entity->sprite_index)
+    {
+        link = &_entitySpatialNext[*link];
+    }
+    if (link != nullptr && *link == entity->sprite_index)
     {
-        spatialVector.erase(index, index + 1);
+        *link = _entitySpatialNext[entity->sprite_index];
+        _entitySpatialNext[entity->sprite_index] = SPRITE_INDEX_NULL;
+        _entitySpatialOffset[entity->sprite_index] = SPATIAL_INDEX_SIZE;
     }
     else
     {
@@ -428,7 +621,7 @@ static void EntitySpatialRemove(EntityBase* entity)
 static void EntitySpatialMove(EntityBase* entity, const CoordsXY& newLoc)
 {
     size_t newIndex = GetSpatialIndexOffset(newLoc);
-    size_t currentIndex = GetSpatialIndexOffset({ entity->x, entity->y });
+    size_t currentIndex = _entitySpatialOffset[entity->sprite_index];
     if (newIndex == currentIndex)
         return;
 
@@ -64,5 +64,25 @@ struct EntitiesChecksum
 #pragma pack(pop)
 EntitiesChecksum GetAllEntitiesChecksum();
 
+// Entities checked by the per tick network checksum, in the order they are hashed.
+constexpr size_t ENTITY_CHECKSUM_TYPE_COUNT = 4;
+// Entities are split into slices by their index modulo the slice count, one slice is checksummed per tick.
+constexpr uint16_t ENTITY_CHECKSUM_SLICE_COUNT = 16;
+// Each slice is split further by index range to narrow down the entities that diverged.
+constexpr size_t ENTITY_CHECKSUM_BLOCK_COUNT = 8;
+
+struct EntitiesSliceChecksum
+{
+    uint16_t Slice;
+    std::array<uint32_t, ENTITY_CHECKSUM_TYPE_COUNT> Types;
+    std::array<uint32_t, ENTITY_CHECKSUM_BLOCK_COUNT> Blocks;
+
+    bool operator==(const EntitiesSliceChecksum& other) const;
+    bool operator!=(const EntitiesSliceChecksum& other) const;
+    // Describes the entity types and index ranges that differ between the two checksums.
+    std::string DescribeMismatch(const EntitiesSliceChecksum& other) const;
+};
+EntitiesSliceChecksum GetEntitiesSliceChecksum(uint16_t slice);
+
 void EntitySetFlashing(EntityBase* entity, bool flashing);
 bool EntityGetFlashing(EntityBase* entity);
@@ -1289,6 +1289,38 @@ static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] cons
     return 0;
 }
 
+static int32_t cc_paint_cache(InteractiveConsole& console, const arguments_t& argv)
+{
+    const auto stats = viewport_paint_cache_get_stats();
+    const auto numBlocks = stats.BlocksReused + stats.BlocksRegenerated;
+    const auto reusedPercentage = numBlocks == 0 ? 0.0 : 100.0 * stats.BlocksReused / numBlocks;
+    console.WriteFormatLine(
+        "Blocks reused: %llu (%.1f%%)", static_cast<unsigned long long>(stats.BlocksReused), reusedPercentage);
+    console.WriteFormatLine("Blocks regenerated: %llu", static_cast<unsigned long long>(stats.BlocksRegenerated));
+    if (!argv.empty() && argv[0] == "reset")
+    {
+        viewport_paint_cache_reset_stats();
+    }
+    return 0;
+}
+
+static int32_t cc_paint_timings(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+    const auto timings = viewport_paint_get_timings();
+    console.WriteFormatLine("Paint sessions: %u, column width: %d", timings.NumSessions, timings.ColumnWidth);
+    if (timings.NumRetainedSessions != 0)
+    {
+        console.WriteFormatLine(
+            "Retained blocks: %u, reused: %u, regenerated: %u", timings.NumRetainedSessions, timings.NumReusedSessions,
+            timings.NumRetainedSessions - timings.NumReusedSessions);
+    }
+    console.WriteFormatLine("Generate: %.3f ms", timings.GenerateTime);
+    console.WriteFormatLine("Arrange: %.3f ms", timings.ArrangeTime);
+    console.WriteFormatLine("Draw: %.3f ms", timings.DrawTime);
+    console.WriteFormatLine("Slowest session: %.3f ms", timings.SlowestSessionTime);
+    return 0;
+}
+
 static int32_t cc_for_date([[maybe_unused]] InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
 {
     int32_t year = 0;
@@ -1525,10 +1557,13 @@ static int32_t cc_replay_start(InteractiveConsole& console, const arguments_t& a
                              "  Date Recorded: %s\n"
                              "  Ticks: %u\n"
                              "  Commands: %u\n"
-                             "  Checksums: %u";
+                             "  Checksums: %u\n"
+                             "  Keyframes: %u";
 
-        console.WriteFormatLine(logFmt, info.FilePath.c_str(), recordingDate, info.Ticks, info.NumCommands, info.NumChecksums);
-        Console::WriteLine(logFmt, info.FilePath.c_str(), recordingDate, info.Ticks, info.NumCommands, info.NumChecksums);
+        console.WriteFormatLine(
+            logFmt, info.FilePath.c_str(), recordingDate, info.Ticks, info.NumCommands, info.NumChecksums, info.NumKeyframes);
+        Console::WriteLine(
+            logFmt, info.FilePath.c_str(), recordingDate, info.Ticks, info.NumCommands, info.NumChecksums, info.NumKeyframes);
 
         return 1;
     }
@@ -1554,6 +1589,38 @@ static int32_t cc_replay_stop(InteractiveConsole& console, const arguments_t& ar
     return 0;
 }
 
+static int32_t cc_replay_seek(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (network_get_mode() != NETWORK_MODE_NONE)
+    {
+        console.WriteFormatLine("This command is currently not supported in multiplayer mode.");
+        return 0;
+    }
+
+    if (argv.size() < 1)
+    {
+        console.WriteFormatLine("Parameters required <tick>");
+        return 0;
+    }
+
+    auto* replayManager = OpenRCT2::GetContext()->GetReplayManager();
+    if (!replayManager->IsReplaying())
+    {
+        console.WriteFormatLine("Replay currently not playing");
+        return 0;
+    }
+
+    uint32_t tick = atol(argv[0].c_str());
+    if (replayManager->SeekPlayback(tick))
+    {
+        console.WriteFormatLine("Replay at tick %u", tick);
+        return 1;
+    }
+
+    console.WriteFormatLine("Unable to seek to tick %u", tick);
+    return 0;
+}
+
 static int32_t cc_replay_normalise(InteractiveConsole& console, const arguments_t& argv)
 {
     if (network_get_mode() != NETWORK_MODE_NONE)
@@ -1805,6 +1872,11 @@ static constexpr const console_command console_command_table[] = {
     { "load_park", cc_load_park, "Load park from save directory or by absolute path", "load_park <filename>" },
     { "object_count", cc_object_count, "Shows the number of objects of each type in the scenario.", "object_count" },
     { "open", cc_open, "Opens the window with the give name.", "open <window>." },
+    { "paint_cache", cc_paint_cache,
+      "Shows how many viewport blocks were drawn from retained paint sessions and how many were regenerated.",
+      "paint_cache [reset]" },
+    { "paint_timings", cc_paint_timings, "Shows where the paint sessions of the last frame spent their time.",
+      "paint_timings" },
     { "quit", cc_close, "Closes the console.", "quit" },
     { "remove_park_fences", cc_remove_park_fences, "Removes all park fences from the surface", "remove_park_fences" },
     { "remove_unused_objects", cc_remove_unused_objects, "Removes all the unused objects from the object selection.",
@@ -1824,6 +1896,7 @@ static constexpr const console_command console_command_table[] = {
     { "replay_stoprecord", cc_replay_stoprecord, "Stops recording a new replay.", "replay_stoprecord" },
     { "replay_start", cc_replay_start, "Starts a replay", "replay_start <name>" },
     { "replay_stop", cc_replay_stop, "Stops the replay", "replay_stop" },
+    { "replay_seek", cc_replay_seek, "Moves the replay to the given number of ticks since its start", "replay_seek <tick>" },
     { "replay_normalise", cc_replay_normalise, "Normalises the replay to remove all gaps",
       "replay_normalise <input file> <output file>" },
     { "mp_desync", cc_mp_desync, "Forces a multiplayer desync",
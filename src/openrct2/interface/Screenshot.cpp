@@ -18,6 +18,7 @@
 #include "../audio/audio.h"
 #include "../core/Console.hpp"
 #include "../core/Imaging.h"
+#include "../core/JobPool.h"
 #include "../drawing/Drawing.h"
 #include "../drawing/X8DrawingEngine.h"
 #include "../localisation/Localisation.h"
@@ -35,6 +36,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 using namespace std::literals::string_literals;
 using namespace OpenRCT2;
@@ -42,6 +44,9 @@ using namespace OpenRCT2::Drawing;
 
 uint8_t gScreenshotCountdown = 0;
 
+// Number of rows rendered at a time when writing a viewport straight to a file.
+static constexpr int32_t SCREENSHOT_BAND_HEIGHT = 256;
+
 static bool WriteDpiToFile(std::string_view path, const rct_drawpixelinfo* dpi, const GamePalette& palette)
 {
     auto const pixels8 = dpi->bits;
@@ -376,9 +381,109 @@ static void RenderViewport(IDrawingEngine* drawingEngine, const rct_viewport& vi
     viewport_render(&dpi, &viewport, { { 0, 0 }, { viewport.width, viewport.height } });
 }
 
-void screenshot_giant()
+struct ScreenshotBand
 {
+    std::vector<uint8_t> Pixels;
+    int32_t Top = 0;
+    int32_t Height = 0;
+};
+
+static void RenderViewportBand(
+    IDrawingEngine* drawingEngine, const rct_viewport& viewport, ScreenshotBand& band, int32_t top)
+{
+    band.Top = top;
+    band.Height = std::min(SCREENSHOT_BAND_HEIGHT, viewport.height - top);
+
+    // Anything not painted over stays transparent (and black if the background is not transparent).
+    std::fill(band.Pixels.begin(), band.Pixels.end(), PALETTE_INDEX_0);
+
     rct_drawpixelinfo dpi{};
+    dpi.bits = band.Pixels.data();
+    dpi.y = top;
+    dpi.width = viewport.width;
+    dpi.height = band.Height;
+    dpi.DrawingEngine = drawingEngine;
+    viewport_render(&dpi, &viewport, { { 0, top }, { viewport.width, top + band.Height } });
+}
+
+/**
+ * Renders the viewport band by band straight into a PNG, so the memory used no longer grows with the size of the
+ * image. The next band is painted while the previous one is being compressed.
+ */
+static void RenderViewportToFile(std::string_view path, const rct_viewport& viewport)
+{
+    if (viewport.width <= 0 || viewport.height <= 0)
+    {
+        throw std::runtime_error("Screenshot failed, the image is empty.");
+    }
+
+    // Ensure sprites appear regardless of rotation
+    reset_all_sprite_quadrant_placements();
+    X8DrawingEngine drawingEngine(GetContext()->GetUiContext());
+
+    ScreenshotBand bands[2];
+    const auto bandSize = static_cast<size_t>(viewport.width) * std::min(SCREENSHOT_BAND_HEIGHT, viewport.height);
+    try
+    {
+        for (auto& band : bands)
+        {
+            band.Pixels.resize(bandSize);
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        throw std::runtime_error("Screenshot failed, unable to allocate memory for image.");
+    }
+
+    JobPool renderJobs(1);
+    auto renderBand = [&drawingEngine, &viewport](ScreenshotBand& band, int32_t top) {
+        RenderViewportBand(&drawingEngine, viewport, band, top);
+    };
+
+    RenderViewportBand(&drawingEngine, viewport, bands[0], 0);
+    if (bands[0].Height < viewport.height)
+    {
+        renderJobs.AddTask([&renderBand, &bands]() { renderBand(bands[1], bands[0].Height); });
+    }
+
+    size_t current = 0;
+    auto getRow = [&](uint32_t row) -> const uint8_t* {
+        auto y = static_cast<int32_t>(row);
+        if (y >= bands[current].Top + bands[current].Height)
+        {
+            // Wait for the band painted in the background and start on the one after it.
+            renderJobs.Join();
+            current ^= 1;
+            auto nextTop = bands[current].Top + bands[current].Height;
+            if (nextTop < viewport.height)
+            {
+                auto& nextBand = bands[current ^ 1];
+                renderJobs.AddTask([&renderBand, &nextBand, nextTop]() { renderBand(nextBand, nextTop); });
+            }
+        }
+        return bands[current].Pixels.data() + static_cast<size_t>(y - bands[current].Top) * viewport.width;
+    };
+
+    try
+    {
+        Image image;
+        image.Width = viewport.width;
+        image.Height = viewport.height;
+        image.Depth = 8;
+        image.Stride = viewport.width;
+        image.Palette = std::make_unique<GamePalette>(gPalette);
+        Imaging::WriteToFile(path, image, getRow);
+    }
+    catch (const std::exception&)
+    {
+        renderJobs.Join();
+        throw;
+    }
+    renderJobs.Join();
+}
+
+void screenshot_giant()
+{
     try
     {
         auto path = screenshot_get_next_path();
@@ -406,10 +511,7 @@ void screenshot_giant()
             viewport.flags |= VIEWPORT_FLAG_TRANSPARENT_BACKGROUND;
         }
 
-        dpi = CreateDPI(viewport);
-
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(path.value(), &dpi, gPalette);
+        RenderViewportToFile(path.value(), viewport);
 
         // Show user that screenshot saved successfully
         Formatter ft;
@@ -422,8 +524,6 @@ void screenshot_giant()
         log_error("%s", e.what());
         context_show_error(STR_SCREENSHOT_FAILED, STR_NONE, {});
     }
-
-    ReleaseDPI(dpi);
 }
 
 // TODO: Move this at some point into a more appropriate place.
@@ -620,7 +720,6 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
     }
 
     int32_t exitCode = 1;
-    rct_drawpixelinfo dpi;
     try
     {
         core_init();
@@ -723,17 +822,13 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
 
         ApplyOptions(options, viewport);
 
-        dpi = CreateDPI(viewport);
-
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(outputPath, &dpi, gPalette);
+        RenderViewportToFile(outputPath, viewport);
     }
     catch (const std::exception& e)
     {
         std::printf("%s\n", e.what());
         exitCode = -1;
     }
-    ReleaseDPI(dpi);
 
     drawing_engine_dispose();
 
@@ -820,10 +915,7 @@ void CaptureImage(const CaptureOptions& options)
     }
 
     auto outputPath = ResolveFilenameForCapture(options.Filename);
-    auto dpi = CreateDPI(viewport);
-    RenderViewport(nullptr, viewport, dpi);
-    WriteDpiToFile(outputPath, &dpi, gPalette);
-    ReleaseDPI(dpi);
+    RenderViewportToFile(outputPath, viewport);
 
     gCurrentRotation = backupRotation;
 }
@@ -18,6 +18,7 @@
 #include "../core/JobPool.h"
 #include "../drawing/Drawing.h"
 #include "../drawing/IDrawingEngine.h"
+#include "../drawing/LightFX.h"
 #include "../entity/EntityList.h"
 #include "../entity/Guest.h"
 #include "../entity/Staff.h"
@@ -35,9 +36,14 @@
 #include "Window_internal.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstring>
+#include <limits>
 #include <list>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 using namespace OpenRCT2;
 
@@ -52,6 +58,62 @@ rct_viewport* g_music_tracking_viewport;
 static std::unique_ptr<JobPool> _paintJobs;
 static std::vector<paint_session*> _paintColumns;
 
+struct ViewportPaintSessionTiming
+{
+    std::chrono::duration<double, std::milli> Generate{};
+    std::chrono::duration<double, std::milli> Arrange{};
+    std::chrono::duration<double, std::milli> Draw{};
+};
+
+// One entry per session of the current viewport_paint call, written by whichever thread handles the session.
+static std::vector<ViewportPaintSessionTiming> _paintSessionTimings;
+static ViewportPaintTimings _paintTimings;
+static ViewportPaintTimings _paintTimingsLastFrame;
+static uint32_t _paintTimingsDrawCount;
+
+// Height of a retained paint block in screen pixels, blocks are as wide as the columns viewport_paint would use for
+// the whole viewport.
+static constexpr int32_t PaintCacheBlockHeight = 256;
+static constexpr size_t PaintCacheMaxBlocks = 1024;
+
+struct ViewportPaintCacheBlock
+{
+    paint_session* Session{};
+    ScreenCoordsXY ViewPos;
+    uint32_t LastUsed{};
+};
+
+/**
+ * Sorted paint sessions of a viewport kept between frames. Blocks are keyed by their position in view coordinates so
+ * they stay valid while the viewport scrolls, and are regenerated once anything drawn in them is invalidated.
+ */
+struct ViewportPaintCache
+{
+    ZoomLevel Zoom{};
+    uint32_t ViewFlags{};
+    uint8_t Rotation{};
+    int32_t BlockWidth{ 32 };
+    uint32_t CurrentPaint{};
+    std::unordered_map<uint64_t, ViewportPaintCacheBlock> Blocks;
+
+    // Keys of the blocks invalidated since the last paint, only blocks the view touches are recorded.
+    std::unordered_set<uint64_t> DirtyBlocks;
+    // Area in view coordinates retained blocks have to lie within, narrowed down to the view whenever an invalidation
+    // falls outside of it.
+    std::atomic<int32_t> RetainLeft{ std::numeric_limits<int32_t>::min() };
+    std::atomic<int32_t> RetainTop{ std::numeric_limits<int32_t>::min() };
+    std::atomic<int32_t> RetainRight{ std::numeric_limits<int32_t>::max() };
+    std::atomic<int32_t> RetainBottom{ std::numeric_limits<int32_t>::max() };
+};
+
+static std::unordered_map<const rct_viewport*, ViewportPaintCache> _paintCaches;
+static std::vector<ViewportPaintCacheBlock*> _paintBlocks;
+static ViewportPaintCacheStats _paintCacheStats;
+
+// Invalidations can come from entities updated on worker threads, they are applied once the next paint starts.
+static std::mutex _paintCacheInvalidationsMutex;
+static bool _paintCacheInvalidateAll;
+
 ScreenCoordsXY gSavedView;
 ZoomLevel gSavedViewZoom;
 uint8_t gSavedViewRotation;
@@ -91,6 +153,7 @@ void viewport_init_all()
     gMapSelectFlags = 0;
     gStaffDrawPatrolAreas = 0xFFFF;
     textinput_cancel();
+    viewport_paint_cache_invalidate_all();
 }
 
 /**
@@ -172,6 +235,7 @@ void viewport_create(rct_window* w, const ScreenCoordsXY& screenCoords, int32_t
     auto itViewport = _viewports.insert(_viewports.end(), rct_viewport{});
 
     viewport = &*itViewport;
+    _paintCaches.try_emplace(viewport);
     viewport->pos = screenCoords;
     viewport->width = width;
     viewport->height = height;
@@ -215,6 +279,16 @@ void viewport_remove(rct_viewport* viewport)
         log_error("Unable to remove viewport: %p", viewport);
         return;
     }
+
+    auto itCache = _paintCaches.find(viewport);
+    if (itCache != _paintCaches.end())
+    {
+        for (auto& [key, block] : itCache->second.Blocks)
+        {
+            PaintSessionFree(block.Session);
+        }
+        _paintCaches.erase(itCache);
+    }
     _viewports.erase(it);
 }
 
@@ -848,16 +922,16 @@ static void record_session(
     std::unordered_map<paint_struct*, paint_struct*> entryRemap;
 
     // Copy all entries
-    auto paintIndex = 0;
+    size_t paintIndex = 0;
     auto chain = session->PaintEntryChain.Head;
     while (chain != nullptr)
     {
         for (size_t i = 0; i < chain->Count; i++)
         {
             auto& src = chain->PaintStructs[i];
+            entryRemap[&src.basic] = reinterpret_cast<paint_struct*>(paintIndex * sizeof(paint_entry));
             auto& dst = recordedSession.Entries[paintIndex++];
             dst = src;
-            entryRemap[&src.basic] = reinterpret_cast<paint_struct*>(i * sizeof(paint_entry));
         }
         chain = chain->Next;
     }
@@ -894,18 +968,25 @@ static void record_session(
 }
 
 static void viewport_fill_column(
-    paint_session* session, std::vector<RecordedPaintSession>* recorded_sessions, size_t record_index)
+    paint_session* session, std::vector<RecordedPaintSession>* recorded_sessions, size_t record_index,
+    ViewportPaintSessionTiming& timing)
 {
+    const auto startTime = std::chrono::high_resolution_clock::now();
     PaintSessionGenerate(session);
+    timing.Generate = std::chrono::high_resolution_clock::now() - startTime;
     if (recorded_sessions != nullptr)
     {
         record_session(session, recorded_sessions, record_index);
     }
+
+    const auto arrangeStartTime = std::chrono::high_resolution_clock::now();
     PaintSessionArrange(session);
+    timing.Arrange = std::chrono::high_resolution_clock::now() - arrangeStartTime;
 }
 
-static void viewport_paint_column(paint_session* session)
+static void viewport_paint_column(paint_session* session, ViewportPaintSessionTiming& timing)
 {
+    const auto startTime = std::chrono::high_resolution_clock::now();
     if (session->ViewFlags
             & (VIEWPORT_FLAG_HIDE_VERTICAL | VIEWPORT_FLAG_HIDE_BASE | VIEWPORT_FLAG_UNDERGROUND_INSIDE
                | VIEWPORT_FLAG_CLIP_VIEW)
@@ -931,6 +1012,364 @@ static void viewport_paint_column(paint_session* session)
     {
         PaintDrawMoneyStructs(&session->DPI, session->PSStringHead);
     }
+    timing.Draw = std::chrono::high_resolution_clock::now() - startTime;
+}
+
+// Starts timing the sessions of a viewport_paint call, the totals are kept per frame.
+static void viewport_paint_timings_begin(size_t numSessions, int32_t columnWidth, bool retained)
+{
+    if (_paintTimingsDrawCount != gCurrentDrawCount)
+    {
+        _paintTimingsLastFrame = _paintTimings;
+        _paintTimings = {};
+        _paintTimingsDrawCount = gCurrentDrawCount;
+    }
+    _paintTimings.ColumnWidth = columnWidth;
+    if (retained)
+    {
+        _paintTimings.NumRetainedSessions += static_cast<uint32_t>(numSessions);
+    }
+    _paintSessionTimings.assign(numSessions, {});
+}
+
+static void viewport_paint_timings_end()
+{
+    for (const auto& timing : _paintSessionTimings)
+    {
+        _paintTimings.NumSessions++;
+        _paintTimings.GenerateTime += timing.Generate.count();
+        _paintTimings.ArrangeTime += timing.Arrange.count();
+        _paintTimings.DrawTime += timing.Draw.count();
+        _paintTimings.SlowestSessionTime = std::max(
+            _paintTimings.SlowestSessionTime, (timing.Generate + timing.Arrange + timing.Draw).count());
+    }
+}
+
+/**
+ * Width of the columns an area of the given width is split into for painting, in view coordinates. Columns are 32
+ * wide unless adaptive columns are enabled: then, when zoomed out, they are widened up to 32 screen pixels while there
+ * are still enough of them for every paint thread. Narrow columns at far zoom mostly repeat the tile iteration of their
+ * neighbours.
+ */
+static int32_t viewport_paint_get_column_width(int32_t width, ZoomLevel zoom, bool useMultithreading)
+{
+    int32_t columnWidth = 32;
+    if (!gConfigGeneral.adaptive_paint_columns || zoom <= ZoomLevel{ 0 })
+    {
+        return columnWidth;
+    }
+
+    const int32_t maxColumnWidth = 32 * zoom;
+    const size_t minColumns = useMultithreading ? _paintJobs->CountWorkers() * 4 : 1;
+    while (columnWidth < maxColumnWidth && static_cast<size_t>(width / (columnWidth * 2)) >= minColumns)
+    {
+        columnWidth *= 2;
+    }
+    return columnWidth;
+}
+
+static void viewport_paint_cache_clear(ViewportPaintCache& cache)
+{
+    for (auto& [key, block] : cache.Blocks)
+    {
+        PaintSessionFree(block.Session);
+    }
+    cache.Blocks.clear();
+}
+
+static ScreenCoordsXY viewport_paint_cache_block_size(const ViewportPaintCache& cache, ZoomLevel zoom)
+{
+    if (zoom > ZoomLevel{ 0 })
+    {
+        return { cache.BlockWidth, PaintCacheBlockHeight * zoom };
+    }
+    return { cache.BlockWidth, PaintCacheBlockHeight };
+}
+
+static uint64_t viewport_paint_cache_block_key(const ScreenCoordsXY& blockPos, const ScreenCoordsXY& blockSize)
+{
+    const auto column = static_cast<uint32_t>(blockPos.x / blockSize.x);
+    const auto row = static_cast<uint32_t>(blockPos.y / blockSize.y);
+    return (static_cast<uint64_t>(column) << 32) | row;
+}
+
+static void viewport_paint_cache_raise(std::atomic<int32_t>& value, int32_t limit)
+{
+    auto current = value.load(std::memory_order_relaxed);
+    while (current < limit && !value.compare_exchange_weak(current, limit, std::memory_order_relaxed))
+    {
+    }
+}
+
+static void viewport_paint_cache_lower(std::atomic<int32_t>& value, int32_t limit)
+{
+    auto current = value.load(std::memory_order_relaxed);
+    while (current > limit && !value.compare_exchange_weak(current, limit, std::memory_order_relaxed))
+    {
+    }
+}
+
+/**
+ * Records an invalidation of the retained blocks of a viewport, screenRect is nullptr when the viewport is hidden. Only
+ * blocks the view touches are recorded, anything else is dropped on the next paint.
+ */
+static void viewport_paint_cache_record_invalidation(const rct_viewport* viewport, const ScreenRect* screenRect)
+{
+    if (!gConfigGeneral.retain_viewport_paint)
+        return;
+
+    // Viewports are only created and removed while nothing invalidates them.
+    auto it = _paintCaches.find(viewport);
+    if (it == _paintCaches.end())
+        return;
+    auto& cache = it->second;
+
+    if (screenRect == nullptr)
+    {
+        viewport_paint_cache_raise(cache.RetainLeft, std::numeric_limits<int32_t>::max());
+        return;
+    }
+
+    // Blocks are generated in full, so the area covers every block that is at least partly visible.
+    const auto blockSize = viewport_paint_cache_block_size(cache, viewport->zoom);
+    const auto areaLeft = floor2(viewport->viewPos.x, blockSize.x);
+    const auto areaTop = floor2(viewport->viewPos.y, blockSize.y);
+    const auto areaRight = ceil2(viewport->viewPos.x + viewport->view_width, blockSize.x);
+    const auto areaBottom = ceil2(viewport->viewPos.y + viewport->view_height, blockSize.y);
+
+    // The bottom right corner of the rect is invalidated as well.
+    const auto left = std::max(screenRect->GetLeft(), areaLeft);
+    const auto top = std::max(screenRect->GetTop(), areaTop);
+    const auto right = std::min(screenRect->GetRight() + 1, areaRight);
+    const auto bottom = std::min(screenRect->GetBottom() + 1, areaBottom);
+    if (left != screenRect->GetLeft() || top != screenRect->GetTop() || right != screenRect->GetRight() + 1
+        || bottom != screenRect->GetBottom() + 1)
+    {
+        viewport_paint_cache_raise(cache.RetainLeft, areaLeft);
+        viewport_paint_cache_raise(cache.RetainTop, areaTop);
+        viewport_paint_cache_lower(cache.RetainRight, areaRight);
+        viewport_paint_cache_lower(cache.RetainBottom, areaBottom);
+    }
+    if (left >= right || top >= bottom)
+        return;
+
+    std::lock_guard<std::mutex> lock(_paintCacheInvalidationsMutex);
+    for (auto blockY = floor2(top, blockSize.y); blockY < bottom; blockY += blockSize.y)
+    {
+        for (auto blockX = floor2(left, blockSize.x); blockX < right; blockX += blockSize.x)
+        {
+            cache.DirtyBlocks.insert(viewport_paint_cache_block_key({ blockX, blockY }, blockSize));
+        }
+    }
+}
+
+static void viewport_paint_cache_apply_invalidations()
+{
+    std::lock_guard<std::mutex> lock(_paintCacheInvalidationsMutex);
+    const bool invalidateAll = std::exchange(_paintCacheInvalidateAll, false);
+    for (auto& [viewport, cache] : _paintCaches)
+    {
+        const auto retainLeft = cache.RetainLeft.exchange(std::numeric_limits<int32_t>::min());
+        const auto retainTop = cache.RetainTop.exchange(std::numeric_limits<int32_t>::min());
+        const auto retainRight = cache.RetainRight.exchange(std::numeric_limits<int32_t>::max());
+        const auto retainBottom = cache.RetainBottom.exchange(std::numeric_limits<int32_t>::max());
+        if (invalidateAll)
+        {
+            viewport_paint_cache_clear(cache);
+            cache.DirtyBlocks.clear();
+            continue;
+        }
+
+        for (auto key : cache.DirtyBlocks)
+        {
+            auto itBlock = cache.Blocks.find(key);
+            if (itBlock != cache.Blocks.end())
+            {
+                PaintSessionFree(itBlock->second.Session);
+                cache.Blocks.erase(itBlock);
+            }
+        }
+        cache.DirtyBlocks.clear();
+
+        const auto blockSize = viewport_paint_cache_block_size(cache, cache.Zoom);
+        for (auto itBlock = cache.Blocks.begin(); itBlock != cache.Blocks.end();)
+        {
+            const auto& blockPos = itBlock->second.ViewPos;
+            if (blockPos.x < retainLeft || blockPos.y < retainTop || blockPos.x + blockSize.x > retainRight
+                || blockPos.y + blockSize.y > retainBottom)
+            {
+                PaintSessionFree(itBlock->second.Session);
+                itBlock = cache.Blocks.erase(itBlock);
+            }
+            else
+            {
+                itBlock++;
+            }
+        }
+    }
+}
+
+/**
+ * Returns the retained blocks of the viewport, or nullptr if the viewport has to be painted from scratch.
+ */
+static ViewportPaintCache* viewport_paint_cache_get(const rct_viewport* viewport, bool useMultithreading)
+{
+    viewport_paint_cache_apply_invalidations();
+
+    auto it = _paintCaches.find(viewport);
+    if (it == _paintCaches.end())
+    {
+        // Temporary viewports, e.g. for screenshots, are not retained.
+        return nullptr;
+    }
+
+    auto& cache = it->second;
+    bool retainPaint = gConfigGeneral.retain_viewport_paint;
+#ifdef __ENABLE_LIGHTFX__
+    // Lights are collected while the map is painted, blocks that are drawn again would lose theirs.
+    if (lightfx_is_available())
+    {
+        retainPaint = false;
+    }
+#endif
+    if (!retainPaint)
+    {
+        viewport_paint_cache_clear(cache);
+        return nullptr;
+    }
+
+    // Blocks take the column width of the whole viewport rather than of the area being painted, so it only changes
+    // along with the viewport size, zoom or thread count.
+    const auto rotation = get_current_rotation();
+    const auto blockWidth = viewport_paint_get_column_width(viewport->view_width, viewport->zoom, useMultithreading);
+    if (cache.Zoom != viewport->zoom || cache.ViewFlags != viewport->flags || cache.Rotation != rotation
+        || cache.BlockWidth != blockWidth)
+    {
+        viewport_paint_cache_clear(cache);
+        cache.Zoom = viewport->zoom;
+        cache.ViewFlags = viewport->flags;
+        cache.Rotation = rotation;
+        cache.BlockWidth = blockWidth;
+    }
+    return &cache;
+}
+
+// Narrows a drawing area in view coordinates down to the part that lies within the given rectangle.
+static rct_drawpixelinfo viewport_paint_cache_clip(const rct_drawpixelinfo& dpi, const ScreenRect& viewRect)
+{
+    const auto left = std::max(dpi.x, viewRect.GetLeft());
+    const auto top = std::max(dpi.y, viewRect.GetTop());
+    const auto right = std::min(dpi.x + dpi.width, viewRect.GetRight());
+    const auto bottom = std::min(dpi.y + dpi.height, viewRect.GetBottom());
+    const auto stride = dpi.width / dpi.zoom_level + dpi.pitch;
+
+    rct_drawpixelinfo clipped = dpi;
+    clipped.bits = dpi.bits + (left - dpi.x) / dpi.zoom_level + ((top - dpi.y) / dpi.zoom_level) * stride;
+    clipped.x = left;
+    clipped.y = top;
+    clipped.width = right - left;
+    clipped.height = bottom - top;
+    clipped.pitch = stride - clipped.width / dpi.zoom_level;
+    return clipped;
+}
+
+/**
+ * Paints the area from retained blocks, generating and sorting only those that are missing or were invalidated.
+ */
+static void viewport_paint_cached(
+    ViewportPaintCache& cache, const rct_drawpixelinfo& dpi, bool useMultithreading, bool useParallelDrawing)
+{
+    const auto blockSize = viewport_paint_cache_block_size(cache, dpi.zoom_level);
+    const auto right = dpi.x + dpi.width;
+    const auto bottom = dpi.y + dpi.height;
+    cache.CurrentPaint++;
+
+    const auto numColumns = (right - floor2(dpi.x, blockSize.x) + blockSize.x - 1) / blockSize.x;
+    const auto numRows = (bottom - floor2(dpi.y, blockSize.y) + blockSize.y - 1) / blockSize.y;
+    viewport_paint_timings_begin(std::max(numColumns * numRows, 0), blockSize.x, true);
+
+    _paintBlocks.clear();
+    for (auto blockY = floor2(dpi.y, blockSize.y); blockY < bottom; blockY += blockSize.y)
+    {
+        for (auto blockX = floor2(dpi.x, blockSize.x); blockX < right; blockX += blockSize.x)
+        {
+            const ScreenCoordsXY blockPos = { blockX, blockY };
+            auto& block = cache.Blocks[viewport_paint_cache_block_key(blockPos, blockSize)];
+            block.LastUsed = cache.CurrentPaint;
+            _paintBlocks.push_back(&block);
+            if (block.Session != nullptr)
+            {
+                _paintCacheStats.BlocksReused++;
+                _paintTimings.NumReusedSessions++;
+                continue;
+            }
+
+            // The whole block is generated so it can be drawn again for any part of it, it is only drawn through
+            // a narrowed copy of the drawing area.
+            rct_drawpixelinfo blockDPI = dpi;
+            blockDPI.bits = nullptr;
+            blockDPI.x = blockX;
+            blockDPI.y = blockY;
+            blockDPI.width = blockSize.x;
+            blockDPI.height = blockSize.y;
+            blockDPI.pitch = 0;
+            block.Session = PaintSessionAlloc(&blockDPI, cache.ViewFlags);
+            block.ViewPos = blockPos;
+            _paintCacheStats.BlocksRegenerated++;
+
+            auto* session = block.Session;
+            auto* timing = &_paintSessionTimings[_paintBlocks.size() - 1];
+            if (useMultithreading)
+            {
+                _paintJobs->AddTask([session, timing]() -> void { viewport_fill_column(session, nullptr, 0, *timing); });
+            }
+            else
+            {
+                viewport_fill_column(session, nullptr, 0, *timing);
+            }
+        }
+    }
+    if (useMultithreading)
+    {
+        _paintJobs->Join();
+    }
+
+    for (size_t i = 0; i < _paintBlocks.size(); i++)
+    {
+        auto* block = _paintBlocks[i];
+        auto* session = block->Session;
+        auto* timing = &_paintSessionTimings[i];
+        session->DPI = viewport_paint_cache_clip(dpi, { block->ViewPos, block->ViewPos + blockSize });
+        if (useParallelDrawing)
+        {
+            _paintJobs->AddTask([session, timing]() -> void { viewport_paint_column(session, *timing); });
+        }
+        else
+        {
+            viewport_paint_column(session, *timing);
+        }
+    }
+    if (useParallelDrawing)
+    {
+        _paintJobs->Join();
+    }
+    viewport_paint_timings_end();
+
+    if (cache.Blocks.size() > PaintCacheMaxBlocks)
+    {
+        for (auto it = cache.Blocks.begin(); it != cache.Blocks.end();)
+        {
+            if (it->second.LastUsed != cache.CurrentPaint)
+            {
+                PaintSessionFree(it->second.Session);
+                it = cache.Blocks.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
 }
 
 /**
@@ -981,7 +1420,6 @@ void viewport_paint(
     // make sure, the compare operation is done in int32_t to avoid the loop becoming an infinite loop.
     // this as well as the [x += 32] in the loop causes signed integer overflow -> undefined behaviour.
     auto rightBorder = dpi1.x + dpi1.width;
-    auto alignedX = floor2(dpi1.x, 32);
 
     _paintColumns.clear();
 
@@ -1001,17 +1439,33 @@ void viewport_paint(
         useParallelDrawing = true;
     }
 
+    if (recorded_sessions == nullptr)
+    {
+        auto* cache = viewport_paint_cache_get(viewport, useMultithreading);
+        if (cache != nullptr)
+        {
+            viewport_paint_cached(*cache, dpi1, useMultithreading, useParallelDrawing);
+            return;
+        }
+    }
+
+    // Recorded sessions keep the fixed column width so they can be compared with each other.
+    const auto columnWidth = recorded_sessions == nullptr
+        ? viewport_paint_get_column_width(dpi1.width, dpi1.zoom_level, useMultithreading)
+        : 32;
+    auto alignedX = floor2(dpi1.x, columnWidth);
+    auto columnCount = (rightBorder - alignedX + columnWidth - 1) / columnWidth;
+    viewport_paint_timings_begin(columnCount, columnWidth, false);
+
     // Create space to record sessions and keep track which index is being drawn
     size_t index = 0;
     if (recorded_sessions != nullptr)
     {
-        auto columnSize = rightBorder - alignedX;
-        auto columnCount = (columnSize + 31) / 32;
         recorded_sessions->resize(columnCount);
     }
 
     // Generate and sort columns.
-    for (x = alignedX; x < rightBorder; x += 32, index++)
+    for (x = alignedX; x < rightBorder; x += columnWidth, index++)
     {
         paint_session* session = PaintSessionAlloc(&dpi1, viewFlags);
         _paintColumns.push_back(session);
@@ -1027,22 +1481,24 @@ void viewport_paint(
         }
 
         auto paintRight = dpi2.x + dpi2.width;
-        if (paintRight >= x + 32)
+        if (paintRight >= x + columnWidth)
         {
-            auto rightPitch = paintRight - x - 32;
+            auto rightPitch = paintRight - x - columnWidth;
             paintRight -= rightPitch;
             dpi2.pitch += rightPitch / dpi2.zoom_level;
         }
         dpi2.width = paintRight - dpi2.x;
 
+        auto* timing = &_paintSessionTimings[index];
         if (useMultithreading)
         {
-            _paintJobs->AddTask(
-                [session, recorded_sessions, index]() -> void { viewport_fill_column(session, recorded_sessions, index); });
+            _paintJobs->AddTask([session, recorded_sessions, index, timing]() -> void {
+                viewport_fill_column(session, recorded_sessions, index, *timing);
+            });
         }
         else
         {
-            viewport_fill_column(session, recorded_sessions, index);
+            viewport_fill_column(session, recorded_sessions, index, *timing);
         }
     }
 
@@ -1052,21 +1508,24 @@ void viewport_paint(
     }
 
     // Paint columns.
-    for (auto* session : _paintColumns)
+    for (size_t i = 0; i < _paintColumns.size(); i++)
     {
+        auto* session = _paintColumns[i];
+        auto* timing = &_paintSessionTimings[i];
         if (useParallelDrawing)
         {
-            _paintJobs->AddTask([session]() -> void { viewport_paint_column(session); });
+            _paintJobs->AddTask([session, timing]() -> void { viewport_paint_column(session, *timing); });
         }
         else
         {
-            viewport_paint_column(session);
+            viewport_paint_column(session, *timing);
         }
     }
     if (useParallelDrawing)
     {
         _paintJobs->Join();
     }
+    viewport_paint_timings_end();
 
     // Release resources.
     for (auto* session : _paintColumns)
@@ -1761,26 +2220,34 @@ void viewport_invalidate(const rct_viewport* viewport, const ScreenRect& screenR
             // note, window_is_visible will update viewport->visibility, so this should have a low hit count
             if (!window_is_visible(owner))
             {
+                // Retained blocks have to be dropped, the viewport may be uncovered before it changes again.
+                viewport_paint_cache_record_invalidation(viewport, nullptr);
                 return;
             }
         }
     }
 
     if (viewport->visibility == VisibilityCache::Covered)
+    {
+        viewport_paint_cache_record_invalidation(viewport, nullptr);
         return;
+    }
+
+    viewport_paint_cache_record_invalidation(viewport, &screenRect);
 
     auto [topLeft, bottomRight] = screenRect;
     const auto [viewportRight, viewportBottom] = viewport->viewPos
         + ScreenCoordsXY{ viewport->view_width, viewport->view_height };
 
-    if (bottomRight.x > viewport->viewPos.x && bottomRight.y > viewport->viewPos.y)
+    if (bottomRight.x > viewport->viewPos.x && bottomRight.y > viewport->viewPos.y && topLeft.x < viewportRight
+        && topLeft.y < viewportBottom)
     {
         topLeft = { std::max(topLeft.x, viewport->viewPos.x), std::max(topLeft.y, viewport->viewPos.y) };
         topLeft -= viewport->viewPos;
         topLeft = { topLeft.x / viewport->zoom, topLeft.y / viewport->zoom };
         topLeft += viewport->pos;
 
-        bottomRight = { std::max(bottomRight.x, viewportRight), std::max(bottomRight.y, viewportBottom) };
+        bottomRight = { std::min(bottomRight.x, viewportRight), std::min(bottomRight.y, viewportBottom) };
         bottomRight -= viewport->viewPos;
         bottomRight = { bottomRight.x / viewport->zoom, bottomRight.y / viewport->zoom };
         bottomRight += viewport->pos;
@@ -1789,6 +2256,30 @@ void viewport_invalidate(const rct_viewport* viewport, const ScreenRect& screenR
     }
 }
 
+/**
+ * Drops every retained block, for changes that are not invalidated by position such as options and colours.
+ */
+void viewport_paint_cache_invalidate_all()
+{
+    std::lock_guard<std::mutex> lock(_paintCacheInvalidationsMutex);
+    _paintCacheInvalidateAll = true;
+}
+
+ViewportPaintCacheStats viewport_paint_cache_get_stats()
+{
+    return _paintCacheStats;
+}
+
+void viewport_paint_cache_reset_stats()
+{
+    _paintCacheStats = {};
+}
+
+ViewportPaintTimings viewport_paint_get_timings()
+{
+    return _paintTimingsLastFrame;
+}
+
 static rct_viewport* viewport_find_from_point(const ScreenCoordsXY& screenCoords)
 {
     rct_window* w = window_find_from_point(screenCoords);
@@ -83,6 +83,34 @@ struct InteractionInfo
     ViewportInteractionItem SpriteType = ViewportInteractionItem::None;
 };
 
+/**
+ * How many blocks of retained paint sessions were drawn again as they were, and how many had to be generated and
+ * sorted from the map.
+ */
+struct ViewportPaintCacheStats
+{
+    uint64_t BlocksReused{};
+    uint64_t BlocksRegenerated{};
+};
+
+/**
+ * Time spent painting the viewports of the last complete frame, summed over all paint sessions. The times are in
+ * milliseconds of thread time, so with multithreading they can add up to more than the frame took.
+ */
+struct ViewportPaintTimings
+{
+    uint32_t NumSessions{};
+    // Sessions drawn from the retained blocks of a viewport, and how many of those were kept from an earlier frame.
+    uint32_t NumRetainedSessions{};
+    uint32_t NumReusedSessions{};
+    // Width of the columns or retained blocks of the last viewport painted, in view coordinates.
+    int32_t ColumnWidth{};
+    double GenerateTime{};
+    double ArrangeTime{};
+    double DrawTime{};
+    double SlowestSessionTime{};
+};
+
 #define MAX_VIEWPORT_COUNT WINDOW_LIMIT_MAX
 
 /**
@@ -147,6 +175,10 @@ bool ViewportInteractionRightClick(const ScreenCoordsXY& screenCoords);
 CoordsXY ViewportInteractionGetTileStartAtCursor(const ScreenCoordsXY& screenCoords);
 
 void viewport_invalidate(const rct_viewport* viewport, const ScreenRect& screenRect);
+void viewport_paint_cache_invalidate_all();
+ViewportPaintCacheStats viewport_paint_cache_get_stats();
+void viewport_paint_cache_reset_stats();
+ViewportPaintTimings viewport_paint_get_timings();
 
 std::optional<CoordsXY> screen_get_map_xy(const ScreenCoordsXY& screenCoords, rct_viewport** viewport);
 std::optional<CoordsXY> screen_get_map_xy_with_z(const ScreenCoordsXY& screenCoords, int32_t z);
@@ -496,6 +496,7 @@ void window_invalidate_by_number(rct_windowclass cls, rct_windownumber number)
  */
 void window_invalidate_all()
 {
+    viewport_paint_cache_invalidate_all();
     window_visit_each([](rct_window* w) { w->Invalidate(); });
 }
 
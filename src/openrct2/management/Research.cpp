@@ -10,6 +10,7 @@
 #include "Research.h"
 
 #include "../Game.h"
+#include "../LogicPhaseGraph.h"
 #include "../OpenRCT2.h"
 #include "../actions/ParkSetResearchFundingAction.h"
 #include "../config/Config.h"
@@ -152,8 +153,15 @@ static void research_calculate_expected_date()
 
 static void research_invalidate_related_windows()
 {
-    window_invalidate_by_class(WC_CONSTRUCT_RIDE);
-    window_invalidate_by_class(WC_RESEARCH);
+    LogicPhaseGraph::Defer([]() {
+        window_invalidate_by_class(WC_CONSTRUCT_RIDE);
+        window_invalidate_by_class(WC_RESEARCH);
+    });
+}
+
+static void research_add_news_item(rct_string_id stringId, uint32_t assoc, const Formatter& ft)
+{
+    LogicPhaseGraph::Defer([stringId, assoc, ft]() { News::AddItemToQueue(News::ItemType::Research, stringId, assoc, ft); });
 }
 
 static void research_mark_as_fully_completed()
@@ -162,8 +170,12 @@ static void research_mark_as_fully_completed()
     gResearchProgressStage = RESEARCH_STAGE_FINISHED_ALL;
     research_invalidate_related_windows();
     // Reset funding to 0 if no more rides.
-    auto gameAction = ParkSetResearchFundingAction(gResearchPriorities, 0);
-    GameActions::Execute(&gameAction);
+    LogicPhaseGraph::Defer([priorities = gResearchPriorities]() {
+        auto gameAction = ParkSetResearchFundingAction(priorities, 0);
+        GameActions::Execute(&gameAction);
+        // The expected date depends on the funding, research_update may have worked it out before this ran.
+        research_calculate_expected_date();
+    });
 }
 
 /**
@@ -302,7 +314,7 @@ void research_finish_item(ResearchItem* researchItem)
             {
                 if (gConfigNotifications.ride_researched)
                 {
-                    News::AddItemToQueue(News::ItemType::Research, availabilityString, researchItem->rawValue, ft);
+                    research_add_news_item(availabilityString, researchItem->rawValue, ft);
                 }
             }
 
@@ -324,13 +336,12 @@ void research_finish_item(ResearchItem* researchItem)
             {
                 if (gConfigNotifications.ride_researched)
                 {
-                    News::AddItemToQueue(
-                        News::ItemType::Research, STR_NEWS_ITEM_RESEARCH_NEW_SCENERY_SET_AVAILABLE, researchItem->rawValue, ft);
+                    research_add_news_item(STR_NEWS_ITEM_RESEARCH_NEW_SCENERY_SET_AVAILABLE, researchItem->rawValue, ft);
                 }
             }
 
             research_invalidate_related_windows();
-            init_scenery();
+            LogicPhaseGraph::Defer(init_scenery);
         }
     }
 }
@@ -40,7 +40,7 @@
 // This string specifies which version of network stream current build uses.
 // It is used for making sure only compatible builds get connected, even within
 // single OpenRCT2 version.
-#define NETWORK_STREAM_VERSION "8"
+#define NETWORK_STREAM_VERSION "11"
 #define NETWORK_STREAM_ID OPENRCT2_VERSION "-" NETWORK_STREAM_VERSION
 
 static Peep* _pickup_peep = nullptr;
@@ -52,6 +52,26 @@ static int32_t _pickup_peep_old_x = LOCATION_NULL;
 // with uint16_t and needs some spare room for other data in the packet.
 static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 
+// Clients joining within this window share one map snapshot and catch up on the game actions since.
+static constexpr uint32_t MAP_SNAPSHOT_MAX_AGE_TICKS = 200;
+static constexpr uint32_t MAP_SNAPSHOT_MAX_AGE_MS = 10000;
+static constexpr size_t MAP_SNAPSHOT_MAX_CATCH_UP = 2048;
+
+// Number of outbound packets at which streaming map chunks to a client pauses until the socket has caught up.
+static constexpr size_t MAP_CHUNKS_IN_FLIGHT = 8;
+// Packets in frames are not limited to 64 KiB.
+static constexpr uint32_t FRAMED_CHUNK_SIZE = 1024 * 512;
+
+static uint32_t GetSupportedFeatures()
+{
+    uint32_t features = 0;
+    if (gConfigNetwork.packet_frames)
+    {
+        features |= NETWORK_FEATURE_FRAMES;
+    }
+    return features;
+}
+
 // If data is sent fast enough it would halt the entire server, process only a maximum amount.
 // This limit is per connection, the current value was determined by tests with fuzzing.
 static constexpr uint32_t MaxPacketsPerUpdate = 100;
@@ -193,6 +213,7 @@ void NetworkBase::Close()
         CloseConnection();
 
         client_connection_list.clear();
+        _mapSnapshot = nullptr;
         GameActions::ClearQueue();
         GameActions::ResumeQueue();
         player_list.clear();
@@ -515,6 +536,17 @@ void NetworkBase::UpdateServer()
         {
             DecayCooldown(connection->Player);
         }
+
+        while (connection->MapTransfer != nullptr && connection->GetQueuedPacketCount() < MAP_CHUNKS_IN_FLIGHT)
+        {
+            Server_Send_MAP_CHUNK(*connection);
+        }
+    }
+
+    if (_mapSnapshot != nullptr && !IsMapSnapshotReusable(*_mapSnapshot))
+    {
+        // Stop recording game actions for it, transfers in progress hold on to the data.
+        _mapSnapshot = nullptr;
     }
 
     uint32_t ticks = platform_get_ticks();
@@ -751,6 +783,17 @@ bool NetworkBase::CheckSRAND(uint32_t tick, uint32_t srand0)
         return false;
     }
 
+    if (storedTick.hasEntitySlice)
+    {
+        EntitiesSliceChecksum checksum = GetEntitiesSliceChecksum(storedTick.entitySlice.Slice);
+        if (checksum != storedTick.entitySlice)
+        {
+            _serverState.desyncEntities = checksum.DescribeMismatch(storedTick.entitySlice);
+            log_info("Entity checksum mismatch, %s", _serverState.desyncEntities.c_str());
+            return false;
+        }
+    }
+
     if (!storedTick.spriteHash.empty())
     {
         EntitiesChecksum checksum = GetAllEntitiesChecksum();
@@ -1201,6 +1244,10 @@ void NetworkBase::Client_Send_TOKEN()
 {
     log_verbose("requesting token");
     NetworkPacket packet(NetworkCommand::Token);
+    // Older servers ignore the features we ask for.
+    packet << GetSupportedFeatures();
+    // The server may answer in frames as soon as it accepted them.
+    _serverConnection->FramesAccepted = (GetSupportedFeatures() & NETWORK_FEATURE_FRAMES) != 0;
     _serverConnection->AuthStatus = NetworkAuth::Requested;
     _serverConnection->QueuePacket(std::move(packet));
 }
@@ -1248,6 +1295,8 @@ void NetworkBase::Server_Send_TOKEN(NetworkConnection& connection)
     NetworkPacket packet(NetworkCommand::Token);
     packet << static_cast<uint32_t>(connection.Challenge.size());
     packet.Write(connection.Challenge.data(), connection.Challenge.size());
+    // Older clients ignore the features we accepted.
+    packet << static_cast<uint32_t>(connection.FramesEnabled ? NETWORK_FEATURE_FRAMES : 0);
     connection.QueuePacket(std::move(packet));
 }
 
@@ -1379,28 +1428,44 @@ void NetworkBase::Server_Send_AUTH(NetworkConnection& connection)
 
 void NetworkBase::Server_Send_MAP(NetworkConnection* connection)
 {
-    std::vector<const ObjectRepositoryItem*> objects;
     if (connection != nullptr)
     {
-        objects = connection->RequestedObjects;
+        auto snapshot = GetMapSnapshot(connection->RequestedObjects);
+        if (snapshot == nullptr)
+        {
+            connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
+            connection->Disconnect();
+            return;
+        }
+
+        // The first chunk makes the client buffer game actions until the map is loaded. The actions broadcast since the
+        // snapshot was taken are queued right behind it, the remaining chunks are streamed by UpdateServer.
+        connection->MapTransfer = snapshot;
+        connection->MapTransferOffset = 0;
+        Server_Send_MAP_CHUNK(*connection);
+        for (const auto& packet : snapshot->CatchUp)
+        {
+            connection->QueuePacket(packet);
+        }
+        return;
     }
-    else
+
+    // This will send all custom objects to connected clients
+    // TODO: fix it so custom objects negotiation is performed even in this case.
+    auto& context = GetContext();
+    auto& objManager = context.GetObjectManager();
+    auto objects = objManager.GetPackableObjects();
+
+    // The map has changed, snapshots of the previous one are of no use anymore.
+    _mapSnapshot = nullptr;
+    for (auto& clientConnection : client_connection_list)
     {
-        // This will send all custom objects to connected clients
-        // TODO: fix it so custom objects negotiation is performed even in this case.
-        auto& context = GetContext();
-        auto& objManager = context.GetObjectManager();
-        objects = objManager.GetPackableObjects();
+        clientConnection->MapTransfer = nullptr;
     }
 
     auto header = save_for_network(objects);
     if (header.empty())
     {
-        if (connection != nullptr)
-        {
-            connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
-            connection->Disconnect();
-        }
         return;
     }
     size_t chunksize = CHUNK_SIZE;
@@ -1410,17 +1475,63 @@ void NetworkBase::Server_Send_MAP(NetworkConnection* connection)
         NetworkPacket packet(NetworkCommand::Map);
         packet << static_cast<uint32_t>(header.size()) << static_cast<uint32_t>(i);
         packet.Write(&header[i], datasize);
-        if (connection != nullptr)
-        {
-            connection->QueuePacket(std::move(packet));
-        }
-        else
-        {
-            SendPacketToClients(packet);
-        }
+        SendPacketToClients(packet);
     }
 }
 
+void NetworkBase::Server_Send_MAP_CHUNK(NetworkConnection& connection)
+{
+    const auto& data = connection.MapTransfer->Data;
+    const uint32_t offset = connection.MapTransferOffset;
+    const uint32_t chunksize = connection.FramesEnabled ? FRAMED_CHUNK_SIZE : CHUNK_SIZE;
+    const uint32_t datasize = std::min<uint32_t>(chunksize, static_cast<uint32_t>(data.size()) - offset);
+
+    NetworkPacket packet(NetworkCommand::Map);
+    packet << static_cast<uint32_t>(data.size()) << offset;
+    packet.Write(&data[offset], datasize);
+    connection.QueuePacket(std::move(packet));
+
+    connection.MapTransferOffset += datasize;
+    if (connection.MapTransferOffset >= data.size())
+    {
+        connection.MapTransfer = nullptr;
+    }
+}
+
+std::shared_ptr<NetworkMapSnapshot> NetworkBase::GetMapSnapshot(const std::vector<const ObjectRepositoryItem*>& objects)
+{
+    auto sortedObjects = objects;
+    std::sort(sortedObjects.begin(), sortedObjects.end());
+
+    if (_mapSnapshot != nullptr && IsMapSnapshotReusable(*_mapSnapshot) && _mapSnapshot->Objects == sortedObjects)
+    {
+        log_verbose(
+            "Reusing map snapshot from tick %u, %zu game actions to catch up.", _mapSnapshot->Tick,
+            _mapSnapshot->CatchUp.size());
+        return _mapSnapshot;
+    }
+
+    auto snapshot = std::make_shared<NetworkMapSnapshot>();
+    snapshot->Tick = gCurrentTicks;
+    snapshot->RealTime = platform_get_ticks();
+    snapshot->Objects = std::move(sortedObjects);
+    snapshot->Data = save_for_network(objects);
+    if (snapshot->Data.empty())
+    {
+        return nullptr;
+    }
+    _mapSnapshot = snapshot;
+    return snapshot;
+}
+
+bool NetworkBase::IsMapSnapshotReusable(const NetworkMapSnapshot& snapshot) const
+{
+    // Clients run at most a few ticks per frame to catch up, the window is kept short so they are not left behind.
+    return gCurrentTicks - snapshot.Tick <= MAP_SNAPSHOT_MAX_AGE_TICKS
+        && platform_get_ticks() - snapshot.RealTime <= MAP_SNAPSHOT_MAX_AGE_MS
+        && snapshot.CatchUp.size() < MAP_SNAPSHOT_MAX_CATCH_UP;
+}
+
 std::vector<uint8_t> NetworkBase::save_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const
 {
     std::vector<uint8_t> result;
@@ -1497,6 +1608,12 @@ void NetworkBase::Server_Send_GAME_ACTION(const GameAction* action)
 
     packet << gCurrentTicks << action->GetType() << stream;
 
+    // Clients that join with the current map snapshot have to replay this action.
+    if (_mapSnapshot != nullptr)
+    {
+        _mapSnapshot->CatchUp.push_back(packet);
+    }
+
     SendPacketToClients(packet);
 }
 
@@ -1515,6 +1632,8 @@ void NetworkBase::Server_Send_TICK()
         checksum_counter = 0;
         flags |= NETWORK_TICK_FLAG_CHECKSUMS;
     }
+    // A slice of the entities is checked every tick, which covers all of them every few ticks.
+    flags |= NETWORK_TICK_FLAG_ENTITY_SLICE;
     // Send flags always, so we can understand packet structure on the other end,
     // and allow for some expansion.
     packet << flags;
@@ -1523,6 +1642,19 @@ void NetworkBase::Server_Send_TICK()
         EntitiesChecksum checksum = GetAllEntitiesChecksum();
         packet.WriteString(checksum.ToString().c_str());
     }
+    if (flags & NETWORK_TICK_FLAG_ENTITY_SLICE)
+    {
+        EntitiesSliceChecksum checksum = GetEntitiesSliceChecksum(gCurrentTicks % ENTITY_CHECKSUM_SLICE_COUNT);
+        packet << checksum.Slice;
+        for (auto hash : checksum.Types)
+        {
+            packet << hash;
+        }
+        for (auto hash : checksum.Blocks)
+        {
+            packet << hash;
+        }
+    }
 
     SendPacketToClients(packet);
 }
@@ -2156,6 +2288,13 @@ void NetworkBase::Client_Handle_TOKEN(NetworkConnection& connection, NetworkPack
     const std::string pubkey = _key.PublicKeyString();
     _challenge.resize(challenge_size);
     std::memcpy(_challenge.data(), challenge, challenge_size);
+
+    // Older servers don't send any features.
+    uint32_t features = 0;
+    packet >> features;
+    features &= GetSupportedFeatures();
+    connection.FramesEnabled = (features & NETWORK_FEATURE_FRAMES) != 0;
+    connection.FramesAccepted = connection.FramesEnabled;
     bool ok = _key.Sign(_challenge.data(), _challenge.size(), signature);
     if (!ok)
     {
@@ -2192,6 +2331,7 @@ void NetworkBase::Server_Handle_REQUEST_GAMESTATE(NetworkConnection& connection,
         DataSerialiser ds(true, snapshotMemory);
 
         snapshots->SerialiseSnapshot(const_cast<GameStateSnapshot_t&>(*snapshot), ds);
+        snapshots->WriteHistory(ds);
 
         uint32_t bytesSent = 0;
         uint32_t length = static_cast<uint32_t>(snapshotMemory.GetLength());
@@ -2295,8 +2435,15 @@ void NetworkBase::Server_Client_Joined(std::string_view name, const std::string&
     }
 }
 
-void NetworkBase::Server_Handle_TOKEN(NetworkConnection& connection, [[maybe_unused]] NetworkPacket& packet)
+void NetworkBase::Server_Handle_TOKEN(NetworkConnection& connection, NetworkPacket& packet)
 {
+    // Older clients don't send any features.
+    uint32_t features = 0;
+    packet >> features;
+    features &= GetSupportedFeatures();
+    connection.FramesEnabled = (features & NETWORK_FEATURE_FRAMES) != 0;
+    connection.FramesAccepted = connection.FramesEnabled;
+
     uint8_t token_size = 10 + (rand() & 0x7f);
     connection.Challenge.resize(token_size);
     for (int32_t i = 0; i < token_size; i++)
@@ -2453,6 +2600,17 @@ void NetworkBase::Client_Handle_GAMESTATE(NetworkConnection& connection, Network
         if (desyncSnapshot != nullptr)
         {
             GameStateCompareData_t cmpData = snapshots->Compare(serverSnapshot, *desyncSnapshot);
+            cmpData.entityChecksumMismatch = _serverState.desyncEntities;
+
+            // The server also sends its recent tick history, bisect it to find where both sides started to differ.
+            if (_serverGameState.GetPosition() < _serverGameState.GetLength())
+            {
+                auto bisectResult = snapshots->BisectHistory(ds);
+                if (bisectResult.has_value())
+                {
+                    cmpData.firstDivergence = snapshots->GetBisectResultText(*bisectResult);
+                }
+            }
 
             std::string outputPath = GetContext().GetPlatformEnvironment()->GetDirectoryPath(DIRBASE::USER, DIRID::LOG_DESYNCS);
 
@@ -2711,6 +2869,7 @@ void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connecti
             _serverState.tick = gCurrentTicks;
             // window_network_status_open("Loaded new map from network");
             _serverState.state = NetworkServerState::Ok;
+            _serverState.desyncEntities.clear();
             _clientMapLoaded = true;
             gFirstTimeSaving = true;
 
@@ -2972,7 +3131,7 @@ void NetworkBase::Client_Handle_TICK([[maybe_unused]] NetworkConnection& connect
 
     packet >> serverTick >> srand0 >> flags;
 
-    ServerTickData_t tickData;
+    ServerTickData_t tickData{};
     tickData.srand0 = srand0;
     tickData.tick = serverTick;
 
@@ -2984,6 +3143,20 @@ void NetworkBase::Client_Handle_TICK([[maybe_unused]] NetworkConnection& connect
             tickData.spriteHash = text;
         }
     }
+    if (flags & NETWORK_TICK_FLAG_ENTITY_SLICE)
+    {
+        auto& checksum = tickData.entitySlice;
+        packet >> checksum.Slice;
+        for (auto& hash : checksum.Types)
+        {
+            packet >> hash;
+        }
+        for (auto& hash : checksum.Blocks)
+        {
+            packet >> hash;
+        }
+        tickData.hasEntitySlice = checksum.Slice < ENTITY_CHECKSUM_SLICE_COUNT;
+    }
 
     // Don't let the history grow too much.
     while (_serverTickData.size() >= 100)
@@ -2,6 +2,7 @@
 
 #include "../System.hpp"
 #include "../actions/GameAction.h"
+#include "../entity/EntityRegistry.h"
 #include "../object/Object.h"
 #include "NetworkConnection.h"
 #include "NetworkGroup.h"
@@ -77,12 +78,15 @@ public: // Server
     void ServerClientDisconnected(std::unique_ptr<NetworkConnection>& connection);
     bool SaveMap(OpenRCT2::IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects) const;
     std::vector<uint8_t> save_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const;
+    std::shared_ptr<NetworkMapSnapshot> GetMapSnapshot(const std::vector<const ObjectRepositoryItem*>& objects);
+    bool IsMapSnapshotReusable(const NetworkMapSnapshot& snapshot) const;
     std::string MakePlayerNameUnique(const std::string& name);
 
     // Packet dispatchers.
     void Server_Send_AUTH(NetworkConnection& connection);
     void Server_Send_TOKEN(NetworkConnection& connection);
     void Server_Send_MAP(NetworkConnection* connection = nullptr);
+    void Server_Send_MAP_CHUNK(NetworkConnection& connection);
     void Server_Send_CHAT(const char* text, const std::vector<uint8_t>& playerIds = {});
     void Server_Send_GAME_ACTION(const GameAction* action);
     void Server_Send_TICK();
@@ -195,6 +199,7 @@ private: // Server Data
     std::unique_ptr<ITcpSocket> _listenSocket;
     std::unique_ptr<INetworkServerAdvertiser> _advertiser;
     std::list<std::unique_ptr<NetworkConnection>> client_connection_list;
+    std::shared_ptr<NetworkMapSnapshot> _mapSnapshot;
     std::string _serverLogPath;
     std::string _serverLogFilenameFormat = "%Y%m%d-%H%M%S.txt";
     std::ofstream _server_log_fs;
@@ -212,6 +217,8 @@ private: // Client Data
         uint32_t srand0;
         uint32_t tick;
         std::string spriteHash;
+        bool hasEntitySlice;
+        EntitiesSliceChecksum entitySlice;
     };
 
     std::unordered_map<NetworkCommand, CommandHandler> client_command_handlers;
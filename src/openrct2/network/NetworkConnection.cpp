@@ -14,12 +14,46 @@
 #    include "../core/String.hpp"
 #    include "../localisation/Localisation.h"
 #    include "../platform/platform.h"
+#    include "../util/Util.h"
 #    include "Socket.h"
 #    include "network.h"
 
+#    include <cstring>
+
 constexpr size_t NETWORK_DISCONNECT_REASON_BUFFER_SIZE = 256;
 constexpr size_t NetworkBufferSize = 1024 * 64; // 64 KiB, maximum packet size.
 
+// Packets queued for a connection are sent together in one frame, the payload is compressed above a threshold.
+constexpr uint16_t FrameMarker = 0;
+constexpr uint8_t FRAME_FLAG_GZIP = 1 << 0;
+constexpr size_t FrameCompressionThreshold = 512;
+constexpr size_t MaxFramePayloadSize = 1024 * 1024 * 4;
+constexpr size_t MaxFrameSize = 1024 * 1024 * 16;
+
+#    pragma pack(push, 1)
+struct UnframedPacketHeader
+{
+    uint16_t Size;
+    NetworkCommand Id;
+};
+static_assert(sizeof(UnframedPacketHeader) == 6);
+
+// The marker takes the place of the size of an unframed packet, which is never 0 as it includes the id.
+struct FrameHeader
+{
+    uint16_t Marker;
+    uint32_t Size;
+    uint8_t Flags;
+};
+static_assert(sizeof(FrameHeader) == 7);
+
+struct FramedPacketHeader
+{
+    uint32_t Size;
+    NetworkCommand Id;
+};
+#    pragma pack(pop)
+
 NetworkConnection::NetworkConnection()
 {
     ResetLastPacketTime();
@@ -31,44 +65,82 @@ NetworkConnection::~NetworkConnection()
 
 NetworkReadPacket NetworkConnection::ReadPacket()
 {
-    size_t bytesRead = 0;
-
-    // Read packet header.
-    auto& header = InboundPacket.Header;
-    if (InboundPacket.BytesTransferred < sizeof(InboundPacket.Header))
+    // Packets unpacked from a frame are handed out one at a time.
+    if (!_inboundPackets.empty())
     {
-        const size_t missingLength = sizeof(header) - InboundPacket.BytesTransferred;
-
-        uint8_t* buffer = reinterpret_cast<uint8_t*>(&InboundPacket.Header);
+        InboundPacket = std::move(_inboundPackets.front());
+        _inboundPackets.pop_front();
+        return NetworkReadPacket::Success;
+    }
 
-        NetworkReadPacket status = Socket->ReceiveData(buffer, missingLength, &bytesRead);
+    // Frames and unframed packets start with the same size field, a size of 0 marks a frame.
+    if (_inboundHeaderLength < sizeof(UnframedPacketHeader))
+    {
+        NetworkReadPacket status = ReadHeader(sizeof(UnframedPacketHeader));
         if (status != NetworkReadPacket::Success)
         {
             return status;
         }
+    }
 
-        InboundPacket.BytesTransferred += bytesRead;
-        if (InboundPacket.BytesTransferred < sizeof(InboundPacket.Header))
+    uint16_t marker;
+    std::memcpy(&marker, _inboundHeader, sizeof(marker));
+    if (marker == FrameMarker)
+    {
+        if (!FramesAccepted)
         {
-            // If still not enough data for header, keep waiting.
-            return NetworkReadPacket::MoreData;
+            log_warning("Received frame on a connection that did not negotiate frames.");
+            return NetworkReadPacket::Disconnected;
         }
+        return ReadFrame();
+    }
+    return ReadUnframedPacket();
+}
+
+NetworkReadPacket NetworkConnection::ReadHeader(size_t length)
+{
+    size_t bytesRead = 0;
+    const size_t missingLength = length - _inboundHeaderLength;
+    NetworkReadPacket status = Socket->ReceiveData(&_inboundHeader[_inboundHeaderLength], missingLength, &bytesRead);
+    if (status != NetworkReadPacket::Success)
+    {
+        return status;
+    }
+
+    _inboundHeaderLength += bytesRead;
+    if (_inboundHeaderLength < length)
+    {
+        // If still not enough data for header, keep waiting.
+        return NetworkReadPacket::MoreData;
+    }
+    return NetworkReadPacket::Success;
+}
+
+NetworkReadPacket NetworkConnection::ReadUnframedPacket()
+{
+    size_t bytesRead = 0;
+
+    auto& header = InboundPacket.Header;
+    if (InboundPacket.BytesTransferred == 0)
+    {
+        UnframedPacketHeader wireHeader;
+        std::memcpy(&wireHeader, _inboundHeader, sizeof(wireHeader));
 
         // Normalise values.
-        header.Size = Convert::NetworkToHost(header.Size);
-        header.Id = ByteSwapBE(header.Id);
+        header.Size = Convert::NetworkToHost(wireHeader.Size);
+        header.Id = ByteSwapBE(wireHeader.Id);
 
         // NOTE: For compatibility reasons for the master server we need to remove sizeof(Header.Id) from the size.
         // Previously the Id field was not part of the header rather part of the body.
-        header.Size -= std::min<uint16_t>(header.Size, sizeof(header.Id));
+        header.Size -= std::min<uint32_t>(header.Size, sizeof(header.Id));
 
-        // Fall-through: Read rest of packet.
+        InboundPacket.BytesTransferred = sizeof(wireHeader);
     }
 
     // Read packet body.
     {
         // NOTE: BytesTransfered includes the header length, this will not underflow.
-        const size_t missingLength = header.Size - (InboundPacket.BytesTransferred - sizeof(header));
+        const size_t missingLength = header.Size - (InboundPacket.BytesTransferred - sizeof(UnframedPacketHeader));
 
         uint8_t buffer[NetworkBufferSize];
 
@@ -87,6 +159,7 @@ NetworkReadPacket NetworkConnection::ReadPacket()
         if (InboundPacket.Data.size() == header.Size)
         {
             // Received complete packet.
+            _inboundHeaderLength = 0;
             _lastPacketTime = platform_get_ticks();
 
             RecordPacketStats(InboundPacket, false);
@@ -98,20 +171,135 @@ NetworkReadPacket NetworkConnection::ReadPacket()
     return NetworkReadPacket::MoreData;
 }
 
-bool NetworkConnection::SendPacket(NetworkPacket& packet)
+NetworkReadPacket NetworkConnection::ReadFrame()
 {
-    auto header = packet.Header;
+    if (_inboundHeaderLength < sizeof(FrameHeader))
+    {
+        NetworkReadPacket status = ReadHeader(sizeof(FrameHeader));
+        if (status != NetworkReadPacket::Success)
+        {
+            return status;
+        }
+    }
 
-    std::vector<uint8_t> buffer;
-    buffer.reserve(sizeof(header) + header.Size);
+    FrameHeader frameHeader;
+    std::memcpy(&frameHeader, _inboundHeader, sizeof(frameHeader));
+    const uint32_t frameSize = ByteSwapBE(frameHeader.Size);
+    if (frameSize > MaxFrameSize)
+    {
+        log_warning("Received frame of %u bytes, exceeding the limit.", frameSize);
+        return NetworkReadPacket::Disconnected;
+    }
+
+    if (_inboundFrame.size() < frameSize)
+    {
+        size_t bytesRead = 0;
+        const size_t offset = _inboundFrame.size();
+        const size_t missingLength = std::min<size_t>(frameSize - offset, NetworkBufferSize);
+        _inboundFrame.resize(offset + missingLength);
+        NetworkReadPacket status = Socket->ReceiveData(&_inboundFrame[offset], missingLength, &bytesRead);
+        _inboundFrame.resize(offset + (status == NetworkReadPacket::Success ? bytesRead : 0));
+        if (status != NetworkReadPacket::Success)
+        {
+            return status;
+        }
+        if (_inboundFrame.size() < frameSize)
+        {
+            return NetworkReadPacket::MoreData;
+        }
+    }
+
+    // Received complete frame.
+    _inboundHeaderLength = 0;
+    _lastPacketTime = platform_get_ticks();
+    bool valid = UnpackFrame(frameHeader.Flags);
+    _inboundFrame.clear();
+    if (!valid)
+    {
+        return NetworkReadPacket::Disconnected;
+    }
+    if (_inboundPackets.empty())
+    {
+        return NetworkReadPacket::MoreData;
+    }
+    return ReadPacket();
+}
+
+bool NetworkConnection::UnpackFrame(uint8_t flags)
+{
+    std::vector<uint8_t> uncompressed;
+    const std::vector<uint8_t>* payload = &_inboundFrame;
+    if (flags & FRAME_FLAG_GZIP)
+    {
+        try
+        {
+            // Stops inflating as soon as the limit is exceeded rather than after the whole frame.
+            uncompressed = Ungzip(_inboundFrame.data(), _inboundFrame.size(), MaxFrameSize);
+        }
+        catch (const std::exception& e)
+        {
+            log_warning("Unable to decompress frame: %s", e.what());
+            return false;
+        }
+        payload = &uncompressed;
+    }
+
+    const size_t frameWireSize = sizeof(FrameHeader) + _inboundFrame.size();
+    size_t offset = 0;
+    while (offset < payload->size())
+    {
+        FramedPacketHeader packetHeader;
+        if (offset + sizeof(packetHeader) > payload->size())
+        {
+            log_warning("Received malformed frame.");
+            return false;
+        }
+        std::memcpy(&packetHeader, &(*payload)[offset], sizeof(packetHeader));
+        offset += sizeof(packetHeader);
+
+        const uint32_t size = ByteSwapBE(packetHeader.Size);
+        if (size > payload->size() - offset)
+        {
+            log_warning("Received malformed frame.");
+            return false;
+        }
+
+        NetworkPacket packet(ByteSwapBE(packetHeader.Id));
+        packet.Header.Size = size;
+        packet.Write(&(*payload)[offset], size);
+        offset += size;
+
+        // Attribute the bytes on the wire to the packets in proportion to their size.
+        packet.BytesTransferred = (sizeof(packetHeader) + size) * frameWireSize / payload->size();
+        RecordPacketStats(packet, false);
+        packet.BytesTransferred = 0;
+
+        _inboundPackets.push_back(std::move(packet));
+    }
+    return true;
+}
+
+bool NetworkConnection::SendPacket(NetworkPacket& packet)
+{
+    const auto& header = packet.Header;
+    if (header.Size > UINT16_MAX - sizeof(header.Id))
+    {
+        // Only frames can carry packets this large, the size would be truncated.
+        log_error("Unable to send packet of %u bytes without frames.", header.Size);
+        Disconnect();
+        return false;
+    }
 
     // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
     // Previously the Id field was not part of the header rather part of the body.
-    header.Size += sizeof(header.Id);
-    header.Size = Convert::HostToNetwork(header.Size);
-    header.Id = ByteSwapBE(header.Id);
+    UnframedPacketHeader wireHeader;
+    wireHeader.Size = Convert::HostToNetwork(static_cast<uint16_t>(header.Size + sizeof(header.Id)));
+    wireHeader.Id = ByteSwapBE(header.Id);
 
-    buffer.insert(buffer.end(), reinterpret_cast<uint8_t*>(&header), reinterpret_cast<uint8_t*>(&header) + sizeof(header));
+    std::vector<uint8_t> buffer;
+    buffer.reserve(sizeof(wireHeader) + header.Size);
+    buffer.insert(
+        buffer.end(), reinterpret_cast<uint8_t*>(&wireHeader), reinterpret_cast<uint8_t*>(&wireHeader) + sizeof(wireHeader));
     buffer.insert(buffer.end(), packet.Data.begin(), packet.Data.end());
 
     size_t bufferSize = buffer.size() - packet.BytesTransferred;
@@ -129,11 +317,101 @@ bool NetworkConnection::SendPacket(NetworkPacket& packet)
     return sendComplete;
 }
 
+void NetworkConnection::BuildFrame()
+{
+    std::vector<uint8_t> payload;
+    size_t numPackets = 0;
+    bool compressible = true;
+    for (const auto& packet : _outboundPackets)
+    {
+        if (numPackets > 0 && payload.size() + sizeof(FramedPacketHeader) + packet.Data.size() > MaxFramePayloadSize)
+        {
+            break;
+        }
+
+        FramedPacketHeader packetHeader;
+        packetHeader.Size = ByteSwapBE(static_cast<uint32_t>(packet.Data.size()));
+        packetHeader.Id = ByteSwapBE(packet.Header.Id);
+        payload.insert(
+            payload.end(), reinterpret_cast<uint8_t*>(&packetHeader),
+            reinterpret_cast<uint8_t*>(&packetHeader) + sizeof(packetHeader));
+        payload.insert(payload.end(), packet.Data.begin(), packet.Data.end());
+
+        // Map data is a compressed park already.
+        if (packet.GetCommand() == NetworkCommand::Map)
+        {
+            compressible = false;
+        }
+        numPackets++;
+    }
+
+    FrameHeader frameHeader;
+    frameHeader.Marker = FrameMarker;
+    frameHeader.Flags = 0;
+    const size_t payloadSize = payload.size();
+    if (compressible && payloadSize >= FrameCompressionThreshold)
+    {
+        auto compressed = Gzip(payload.data(), payload.size());
+        if (compressed.size() < payload.size())
+        {
+            payload = std::move(compressed);
+            frameHeader.Flags |= FRAME_FLAG_GZIP;
+        }
+    }
+    frameHeader.Size = ByteSwapBE(static_cast<uint32_t>(payload.size()));
+
+    _outboundFrame.clear();
+    _outboundFrame.reserve(sizeof(frameHeader) + payload.size());
+    _outboundFrame.insert(
+        _outboundFrame.end(), reinterpret_cast<uint8_t*>(&frameHeader),
+        reinterpret_cast<uint8_t*>(&frameHeader) + sizeof(frameHeader));
+    _outboundFrame.insert(_outboundFrame.end(), payload.begin(), payload.end());
+    _outboundFrameSent = 0;
+
+    for (size_t i = 0; i < numPackets; i++)
+    {
+        auto& packet = _outboundPackets.front();
+        packet.BytesTransferred = (sizeof(FramedPacketHeader) + packet.Data.size()) * _outboundFrame.size() / payloadSize;
+        RecordPacketStats(packet, true);
+        _outboundPackets.pop_front();
+    }
+}
+
+void NetworkConnection::SendQueuedFrames()
+{
+    // A packet that was partially sent before frames were enabled has to be completed first.
+    if (_outboundFrame.empty() && !_outboundPackets.empty() && _outboundPackets.front().BytesTransferred > 0)
+    {
+        if (!SendPacket(_outboundPackets.front()))
+        {
+            return;
+        }
+        _outboundPackets.pop_front();
+    }
+
+    while (!_outboundFrame.empty() || !_outboundPackets.empty())
+    {
+        if (_outboundFrame.empty())
+        {
+            BuildFrame();
+        }
+
+        size_t sent = Socket->SendData(_outboundFrame.data() + _outboundFrameSent, _outboundFrame.size() - _outboundFrameSent);
+        _outboundFrameSent += sent;
+        if (_outboundFrameSent < _outboundFrame.size())
+        {
+            return;
+        }
+        _outboundFrame.clear();
+        _outboundFrameSent = 0;
+    }
+}
+
 void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
 {
     if (AuthStatus == NetworkAuth::Ok || !packet.CommandRequiresAuth())
     {
-        packet.Header.Size = static_cast<uint16_t>(packet.Data.size());
+        packet.Header.Size = static_cast<uint32_t>(packet.Data.size());
         if (front)
         {
             // If the first packet was already partially sent add new packet to second position
@@ -165,8 +443,19 @@ bool NetworkConnection::IsValid() const
     return !ShouldDisconnect && Socket->GetStatus() == SocketStatus::Connected;
 }
 
+size_t NetworkConnection::GetQueuedPacketCount() const
+{
+    return _outboundPackets.size() + (_outboundFrame.empty() ? 0 : 1);
+}
+
 void NetworkConnection::SendQueuedPackets()
 {
+    if (FramesEnabled || !_outboundFrame.empty())
+    {
+        SendQueuedFrames();
+        return;
+    }
+
     while (!_outboundPackets.empty() && SendPacket(_outboundPackets.front()))
     {
         _outboundPackets.pop_front();
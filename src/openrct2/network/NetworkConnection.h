@@ -24,6 +24,19 @@
 class NetworkPlayer;
 struct ObjectRepositoryItem;
 
+/**
+ * A serialised park that the server sends to joining clients. Clients joining shortly after each other share one
+ * snapshot, the game actions broadcast since it was taken are replayed to them after the map so they can catch up.
+ */
+struct NetworkMapSnapshot
+{
+    uint32_t Tick{};
+    uint32_t RealTime{};
+    std::vector<const ObjectRepositoryItem*> Objects;
+    std::vector<uint8_t> Data;
+    std::vector<NetworkPacket> CatchUp;
+};
+
 class NetworkConnection final
 {
 public:
@@ -37,6 +50,13 @@ public:
     std::vector<uint8_t> Challenge;
     std::vector<const ObjectRepositoryItem*> RequestedObjects;
     bool ShouldDisconnect = false;
+    // Map that is still being streamed to the client and the offset of the next chunk.
+    std::shared_ptr<const NetworkMapSnapshot> MapTransfer;
+    uint32_t MapTransferOffset = 0;
+    // Outbound packets are coalesced into compressed frames, only set once the other end announced support for them.
+    bool FramesEnabled = false;
+    // Inbound frames are only read once this end offered or accepted them, anything else disconnects.
+    bool FramesAccepted = false;
 
     NetworkConnection();
     ~NetworkConnection();
@@ -54,6 +74,7 @@ public:
     void Disconnect();
 
     bool IsValid() const;
+    size_t GetQueuedPacketCount() const;
     void SendQueuedPackets();
     void ResetLastPacketTime();
     bool ReceivedPacketRecently();
@@ -64,11 +85,23 @@ public:
 
 private:
     std::deque<NetworkPacket> _outboundPackets;
+    std::vector<uint8_t> _outboundFrame;
+    size_t _outboundFrameSent = 0;
+    std::deque<NetworkPacket> _inboundPackets;
+    std::vector<uint8_t> _inboundFrame;
+    uint8_t _inboundHeader[8]{};
+    size_t _inboundHeaderLength = 0;
     uint32_t _lastPacketTime = 0;
     std::string _lastDisconnectReason;
 
     void RecordPacketStats(const NetworkPacket& packet, bool sending);
+    NetworkReadPacket ReadHeader(size_t length);
+    NetworkReadPacket ReadUnframedPacket();
+    NetworkReadPacket ReadFrame();
+    bool UnpackFrame(uint8_t flags);
     bool SendPacket(NetworkPacket& packet);
+    void BuildFrame();
+    void SendQueuedFrames();
 };
 
 #endif // DISABLE_NETWORK
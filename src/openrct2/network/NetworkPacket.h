@@ -16,14 +16,12 @@
 #include <memory>
 #include <vector>
 
-#pragma pack(push, 1)
 struct PacketHeader
 {
-    uint16_t Size = 0;
+    // Size of the body. Unframed packets are limited to 64 KiB on the wire, packets inside frames are not.
+    uint32_t Size = 0;
     NetworkCommand Id = NetworkCommand::Invalid;
 };
-static_assert(sizeof(PacketHeader) == 6);
-#pragma pack(pop)
 
 struct NetworkPacket final
 {
@@ -14,6 +14,8 @@
 #include "../ride/RideTypes.h"
 #include "../util/Util.h"
 
+#include <string>
+
 enum
 {
     SERVER_EVENT_PLAYER_JOINED,
@@ -23,6 +25,13 @@ enum
 enum
 {
     NETWORK_TICK_FLAG_CHECKSUMS = 1 << 0,
+    NETWORK_TICK_FLAG_ENTITY_SLICE = 1 << 1,
+};
+
+// Optional protocol features, negotiated with the token exchange.
+enum
+{
+    NETWORK_FEATURE_FRAMES = 1 << 0,
 };
 
 enum
@@ -99,6 +108,8 @@ struct NetworkServerState_t
 {
     NetworkServerState state = NetworkServerState::Ok;
     uint32_t desyncTick = 0;
+    // Entity types and indices that diverged, when the desync was caught by the entity checksum.
+    std::string desyncEntities;
     uint32_t tick = 0;
     uint32_t srand0 = 0;
     bool gamestateSnapshotsEnabled = false;
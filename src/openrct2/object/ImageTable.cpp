@@ -16,6 +16,7 @@
 #include "../core/FileScanner.h"
 #include "../core/IStream.hpp"
 #include "../core/Json.hpp"
+#include "../core/MemoryStream.h"
 #include "../core/Path.hpp"
 #include "../core/String.hpp"
 #include "../drawing/ImageImporter.h"
@@ -24,12 +25,76 @@
 #include "ObjectFactory.h"
 
 #include <algorithm>
+#include <functional>
 #include <memory>
 #include <stdexcept>
+#include <thread>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Drawing;
 
+// Layout of the files written by ImageTable::WriteCache, the image data follows the entry table.
+#pragma pack(push, 1)
+struct ImageCacheHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t NumImages;
+    uint32_t DataSize;
+};
+assert_struct_size(ImageCacheHeader, 16);
+
+struct ImageCacheEntry
+{
+    uint32_t Offset;
+    int16_t Width;
+    int16_t Height;
+    int16_t XOffset;
+    int16_t YOffset;
+    uint16_t Flags;
+    int32_t ZoomedOffset;
+};
+assert_struct_size(ImageCacheEntry, 18);
+#pragma pack(pop)
+
+static constexpr uint32_t IMAGE_CACHE_MAGIC = 0x48434949; // IICH
+static constexpr uint32_t IMAGE_CACHE_VERSION = 1;
+static constexpr uint32_t IMAGE_CACHE_NO_DATA = 0xFFFFFFFF;
+
+/**
+ * Whether the data of an image starting at offset lies within the first dataSize bytes of data. Compressed images are
+ * walked to find their end, without reading past dataSize.
+ */
+static bool ImageCacheDataFits(const rct_g1_element& g1, const uint8_t* data, uint32_t offset, uint32_t dataSize)
+{
+    const size_t available = dataSize - offset;
+    if (!(g1.flags & G1_FLAG_RLE_COMPRESSION) || (g1.flags & G1_FLAG_PALETTE))
+    {
+        return g1_calculate_data_size(&g1) <= available;
+    }
+
+    // Same walk as g1_calculate_data_size: the last row starts at the offset stored in the row table.
+    const size_t rowTableLength = static_cast<size_t>(std::max<int16_t>(g1.height, 0)) * 2;
+    if (rowTableLength == 0 || rowTableLength > available)
+    {
+        return false;
+    }
+    const auto* image = data + offset;
+    size_t position = image[rowTableLength - 2] | (image[rowTableLength - 1] << 8);
+    bool endOfLine = false;
+    do
+    {
+        if (position + 2 > available)
+        {
+            return false;
+        }
+        const uint8_t chunk0 = image[position];
+        position += 2 + (chunk0 & 0x7F);
+        endOfLine = (chunk0 & 0x80) != 0;
+    } while (!endOfLine);
+    return position <= available;
+}
+
 struct ImageTable::RequiredImage
 {
     rct_g1_element g1{};
@@ -340,7 +405,7 @@ std::string ImageTable::FindLegacyObject(const std::string& name)
 
 ImageTable::~ImageTable()
 {
-    if (_data == nullptr)
+    if (_data == nullptr && _mappedData == nullptr)
     {
         for (auto& entry : _entries)
         {
@@ -460,6 +525,13 @@ bool ImageTable::ReadJson(IReadObjectContext* context, json_t& root)
             usesFallbackSprites = true;
         }
 
+        // A cached table replaces the whole table, so only use it if this is the first thing read into it
+        auto cachePath = _entries.empty() ? context->GetImageCachePath() : std::string();
+        if (!cachePath.empty() && ReadCache(cachePath))
+        {
+            return usesFallbackSprites;
+        }
+
         auto imageSources = GetImageSources(context, jsonImages);
 
         for (auto& jsonImage : jsonImages)
@@ -513,11 +585,154 @@ bool ImageTable::ReadJson(IReadObjectContext* context, json_t& root)
                 }
             }
         }
+
+        // Asked again as the context refuses to cache images read with problems
+        if (!cachePath.empty() && !context->GetImageCachePath().empty())
+        {
+            WriteCache(cachePath);
+        }
     }
 
     return usesFallbackSprites;
 }
 
+/**
+ * Maps a table written by WriteCache, the image data is only paged in once an image is drawn.
+ */
+bool ImageTable::ReadCache(const std::string& path)
+{
+    if (!File::Exists(path))
+    {
+        return false;
+    }
+
+    try
+    {
+        auto file = std::make_unique<MemoryMappedFile>(path);
+        auto fileData = file->GetData();
+        auto fileLength = file->GetLength();
+
+        ImageCacheHeader header{};
+        if (fileLength < sizeof(header))
+        {
+            return false;
+        }
+        std::memcpy(&header, fileData, sizeof(header));
+        if (header.Magic != IMAGE_CACHE_MAGIC || header.Version != IMAGE_CACHE_VERSION)
+        {
+            return false;
+        }
+
+        const uint64_t entriesLength = static_cast<uint64_t>(header.NumImages) * sizeof(ImageCacheEntry);
+        if (fileLength != sizeof(header) + entriesLength + header.DataSize)
+        {
+            log_warning("Image cache '%s' is truncated.", path.c_str());
+            return false;
+        }
+
+        // The mapping is read-only, image data is never written to once loaded.
+        auto* imageData = const_cast<uint8_t*>(fileData + sizeof(header) + entriesLength);
+        std::vector<rct_g1_element> newEntries;
+        newEntries.reserve(header.NumImages);
+        for (uint32_t i = 0; i < header.NumImages; i++)
+        {
+            ImageCacheEntry entry;
+            std::memcpy(&entry, fileData + sizeof(header) + i * sizeof(ImageCacheEntry), sizeof(entry));
+
+            rct_g1_element g1{};
+            g1.width = entry.Width;
+            g1.height = entry.Height;
+            g1.x_offset = entry.XOffset;
+            g1.y_offset = entry.YOffset;
+            g1.flags = entry.Flags;
+            g1.zoomed_offset = entry.ZoomedOffset;
+            if (entry.Offset != IMAGE_CACHE_NO_DATA)
+            {
+                // Drawing relies on the whole image being there, not just its first byte.
+                if (entry.Offset >= header.DataSize || !ImageCacheDataFits(g1, imageData, entry.Offset, header.DataSize))
+                {
+                    log_warning("Image cache '%s' is corrupt.", path.c_str());
+                    return false;
+                }
+                g1.offset = imageData + entry.Offset;
+            }
+            newEntries.push_back(g1);
+        }
+
+        _mappedData = std::move(file);
+        _entries = std::move(newEntries);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        log_warning("Unable to read image cache '%s': %s", path.c_str(), e.what());
+        return false;
+    }
+}
+
+void ImageTable::WriteCache(const std::string& path) const
+{
+    ImageCacheHeader header{};
+    header.Magic = IMAGE_CACHE_MAGIC;
+    header.Version = IMAGE_CACHE_VERSION;
+    header.NumImages = GetCount();
+
+    std::vector<ImageCacheEntry> entries;
+    std::vector<size_t> lengths;
+    entries.reserve(_entries.size());
+    lengths.reserve(_entries.size());
+    uint64_t dataSize = 0;
+    for (const auto& g1 : _entries)
+    {
+        auto length = g1.offset != nullptr ? g1_calculate_data_size(&g1) : 0;
+        ImageCacheEntry entry{};
+        entry.Offset = length != 0 ? static_cast<uint32_t>(dataSize) : IMAGE_CACHE_NO_DATA;
+        entry.Width = g1.width;
+        entry.Height = g1.height;
+        entry.XOffset = g1.x_offset;
+        entry.YOffset = g1.y_offset;
+        entry.Flags = g1.flags;
+        entry.ZoomedOffset = g1.zoomed_offset;
+        entries.push_back(entry);
+        lengths.push_back(length);
+        dataSize += length;
+    }
+    if (dataSize >= IMAGE_CACHE_NO_DATA)
+    {
+        return;
+    }
+    header.DataSize = static_cast<uint32_t>(dataSize);
+
+    MemoryStream stream;
+    stream.WriteValue(header);
+    stream.Write(entries.data(), entries.size() * sizeof(ImageCacheEntry));
+    for (size_t i = 0; i < _entries.size(); i++)
+    {
+        if (lengths[i] != 0)
+        {
+            stream.Write(_entries[i].offset, lengths[i]);
+        }
+    }
+
+    // Write next to the final name and move it in place, so a concurrent or interrupted load never maps half a file.
+    auto threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+    auto tempPath = path + String::StdFormat(".%zx.tmp", threadId);
+    try
+    {
+        Path::CreateDirectory(Path::GetDirectory(path));
+        File::WriteAllBytes(tempPath, stream.GetData(), static_cast<size_t>(stream.GetLength()));
+        if (!File::Move(tempPath, path))
+        {
+            File::Delete(tempPath);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log_warning("Unable to write image cache '%s': %s", path.c_str(), e.what());
+        File::Delete(tempPath);
+    }
+}
+
 void ImageTable::AddImage(const rct_g1_element* g1)
 {
     rct_g1_element newg1 = *g1;
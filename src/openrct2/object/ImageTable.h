@@ -11,9 +11,11 @@
 
 #include "../common.h"
 #include "../core/JsonFwd.hpp"
+#include "../core/MemoryMappedFile.h"
 #include "../drawing/Drawing.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 struct Image;
@@ -27,6 +29,7 @@ class ImageTable
 {
 private:
     std::unique_ptr<uint8_t[]> _data;
+    std::unique_ptr<OpenRCT2::MemoryMappedFile> _mappedData;
     std::vector<rct_g1_element> _entries;
 
     /**
@@ -45,6 +48,8 @@ private:
         IReadObjectContext* context, const std::string& name, const std::vector<int32_t>& range);
     [[nodiscard]] static std::vector<int32_t> ParseRange(std::string s);
     [[nodiscard]] static std::string FindLegacyObject(const std::string& name);
+    bool ReadCache(const std::string& path);
+    void WriteCache(const std::string& path) const;
 
 public:
     ImageTable() = default;
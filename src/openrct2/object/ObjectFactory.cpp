@@ -9,8 +9,11 @@
 
 #include "ObjectFactory.h"
 
+#include "../Context.h"
 #include "../OpenRCT2.h"
+#include "../PlatformEnvironment.h"
 #include "../core/Console.hpp"
+#include "../core/Crypt.h"
 #include "../core/File.h"
 #include "../core/FileStream.h"
 #include "../core/Json.hpp"
@@ -19,6 +22,7 @@
 #include "../core/Path.hpp"
 #include "../core/String.hpp"
 #include "../core/Zip.h"
+#include "../drawing/Drawing.h"
 #include "../rct12/SawyerChunkReader.h"
 #include "BannerObject.h"
 #include "EntranceObject.h"
@@ -107,6 +111,7 @@ private:
     std::string _identifier;
     bool _loadImages;
     std::string _basePath;
+    std::string _imageCachePath;
     bool _wasVerbose = false;
     bool _wasWarning = false;
     bool _wasError = false;
@@ -168,6 +173,22 @@ public:
         return {};
     }
 
+    void SetImageCachePath(std::string_view path)
+    {
+        _imageCachePath = path;
+    }
+
+    std::string GetImageCachePath() override
+    {
+        // Images read after something went wrong may contain placeholders (e.g. for a missing RCT2 object),
+        // those must not outlive this load.
+        if (_wasWarning || _wasError)
+        {
+            return {};
+        }
+        return _imageCachePath;
+    }
+
     void LogVerbose(ObjectError code, const utf8* text) override
     {
         _wasVerbose = true;
@@ -206,7 +227,8 @@ namespace ObjectFactory
      * @note jRoot is deliberately left non-const: json_t behaviour changes when const
      */
     static std::unique_ptr<Object> CreateObjectFromJson(
-        IObjectRepository& objectRepository, json_t& jRoot, const IFileDataRetriever* fileRetriever);
+        IObjectRepository& objectRepository, json_t& jRoot, const IFileDataRetriever* fileRetriever,
+        std::string_view imageCachePath);
 
     static ObjectSourceGame ParseSourceGame(const std::string& s)
     {
@@ -408,7 +430,36 @@ namespace ObjectFactory
         return ObjectType::None;
     }
 
-    std::unique_ptr<Object> CreateObjectFromZipFile(IObjectRepository& objectRepository, std::string_view path)
+    /**
+     * Images of a .parkobj are cached under a hash of its path, size and modification time, the same properties the
+     * object index uses to tell whether a file changed, so replacing the file with an updated object never picks up
+     * stale images. Images borrowed from the base game depend on whether the CSG files are loaded, which is part of
+     * the name as well.
+     */
+    static std::string GetImageCachePath(std::string_view path)
+    {
+        const auto pathString = std::string(path);
+        const uint64_t size = File::GetSize(path);
+        const uint64_t lastModified = File::GetLastModified(pathString);
+        auto hash = Crypt::CreateFNV1a()
+                        ->Update(pathString.data(), pathString.size())
+                        ->Update(&size, sizeof(size))
+                        ->Update(&lastModified, sizeof(lastModified))
+                        ->Finish();
+
+        std::string fileName;
+        for (auto b : hash)
+        {
+            fileName += String::StdFormat("%02x", b);
+        }
+        fileName += is_csg_loaded() ? ".csg.imgcache" : ".imgcache";
+
+        auto env = OpenRCT2::GetContext()->GetPlatformEnvironment();
+        return Path::Combine(env->GetDirectoryPath(OpenRCT2::DIRBASE::CACHE), "object", fileName);
+    }
+
+    std::unique_ptr<Object> CreateObjectFromZipFile(
+        IObjectRepository& objectRepository, std::string_view path, bool cacheImages)
     {
         try
         {
@@ -424,7 +475,12 @@ namespace ObjectFactory
             if (jRoot.is_object())
             {
                 auto fileDataRetriever = ZipDataRetriever(path, *archive);
-                return CreateObjectFromJson(objectRepository, jRoot, &fileDataRetriever);
+                std::string imageCachePath;
+                if (cacheImages && !gOpenRCT2NoGraphics)
+                {
+                    imageCachePath = GetImageCachePath(path);
+                }
+                return CreateObjectFromJson(objectRepository, jRoot, &fileDataRetriever, imageCachePath);
             }
         }
         catch (const std::exception& e)
@@ -442,7 +498,7 @@ namespace ObjectFactory
         {
             json_t jRoot = Json::ReadFromFile(path.c_str());
             auto fileDataRetriever = FileSystemDataRetriever(Path::GetDirectory(path));
-            return CreateObjectFromJson(objectRepository, jRoot, &fileDataRetriever);
+            return CreateObjectFromJson(objectRepository, jRoot, &fileDataRetriever, {});
         }
         catch (const std::runtime_error& err)
         {
@@ -485,7 +541,8 @@ namespace ObjectFactory
     }
 
     std::unique_ptr<Object> CreateObjectFromJson(
-        IObjectRepository& objectRepository, json_t& jRoot, const IFileDataRetriever* fileRetriever)
+        IObjectRepository& objectRepository, json_t& jRoot, const IFileDataRetriever* fileRetriever,
+        std::string_view imageCachePath)
     {
         Guard::Assert(jRoot.is_object(), "ObjectFactory::CreateObjectFromJson expects parameter jRoot to be object");
 
@@ -522,6 +579,7 @@ namespace ObjectFactory
             result->SetDescriptor(descriptor);
             result->MarkAsJsonObject();
             auto readContext = ReadObjectContext(objectRepository, id, !gOpenRCT2NoGraphics, fileRetriever);
+            readContext.SetImageCachePath(imageCachePath);
             result->ReadJson(&readContext, jRoot);
             if (readContext.WasError())
             {
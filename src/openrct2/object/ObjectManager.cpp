@@ -12,6 +12,7 @@
 #include "../Context.h"
 #include "../ParkImporter.h"
 #include "../core/Console.hpp"
+#include "../core/JobPool.h"
 #include "../core/Memory.hpp"
 #include "../localisation/StringIds.h"
 #include "../ride/Ride.h"
@@ -30,9 +31,11 @@
 #include <array>
 #include <memory>
 #include <mutex>
-#include <thread>
 #include <unordered_set>
 
+// Shared by every object manager, so rotating between parks or contexts does not spawn threads every time.
+static std::unique_ptr<JobPool> _loadJobs;
+
 class ObjectManager final : public IObjectManager
 {
 private:
@@ -504,30 +507,6 @@ private:
         return requiredObjects;
     }
 
-    template<typename T, typename TFunc> static void ParallelFor(const std::vector<T>& items, TFunc func)
-    {
-        auto partitions = std::thread::hardware_concurrency();
-        auto partitionSize = (items.size() + (partitions - 1)) / partitions;
-        std::vector<std::thread> threads;
-        for (size_t n = 0; n < partitions; n++)
-        {
-            auto begin = n * partitionSize;
-            auto end = std::min(items.size(), begin + partitionSize);
-            threads.emplace_back(
-                [func](size_t pbegin, size_t pend) {
-                    for (size_t i = pbegin; i < pend; i++)
-                    {
-                        func(i);
-                    }
-                },
-                begin, end);
-        }
-        for (auto& t : threads)
-        {
-            t.join();
-        }
-    }
-
     void LoadObjects(std::vector<const ObjectRepositoryItem*>& requiredObjects)
     {
         std::vector<Object*> objects;
@@ -537,39 +516,48 @@ private:
         newLoadedObjects.reserve(OBJECT_ENTRY_COUNT);
 
         // Read objects
+        if (_loadJobs == nullptr)
+        {
+            _loadJobs = std::make_unique<JobPool>();
+        }
         std::mutex commonMutex;
-        ParallelFor(requiredObjects, [this, &commonMutex, requiredObjects, &objects, &badObjects, &newLoadedObjects](size_t i) {
-            auto* requiredObject = requiredObjects[i];
-            Object* object = nullptr;
-            if (requiredObject != nullptr)
+        auto readObjects = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
             {
-                auto* loadedObject = requiredObject->LoadedObject.get();
-                if (loadedObject == nullptr)
+                auto* requiredObject = requiredObjects[i];
+                Object* object = nullptr;
+                if (requiredObject != nullptr)
                 {
-                    // Object requires to be loaded, if the object successfully loads it will register it
-                    // as a loaded object otherwise placed into the badObjects list.
-                    auto newObject = _objectRepository.LoadObject(requiredObject);
-                    std::lock_guard<std::mutex> guard(commonMutex);
-                    if (newObject == nullptr)
+                    auto* loadedObject = requiredObject->LoadedObject.get();
+                    if (loadedObject == nullptr)
                     {
-                        badObjects.push_back(ObjectEntryDescriptor(requiredObject->ObjectEntry));
-                        ReportObjectLoadProblem(&requiredObject->ObjectEntry);
+                        // Object requires to be loaded, if the object successfully loads it will register it
+                        // as a loaded object otherwise placed into the badObjects list.
+                        auto newObject = _objectRepository.LoadObject(requiredObject);
+                        std::lock_guard<std::mutex> guard(commonMutex);
+                        if (newObject == nullptr)
+                        {
+                            badObjects.push_back(ObjectEntryDescriptor(requiredObject->ObjectEntry));
+                            ReportObjectLoadProblem(&requiredObject->ObjectEntry);
+                        }
+                        else
+                        {
+                            object = newObject.get();
+                            newLoadedObjects.push_back(object);
+                            // Connect the ori to the registered object
+                            _objectRepository.RegisterLoadedObject(requiredObject, std::move(newObject));
+                        }
                     }
                     else
                     {
-                        object = newObject.get();
-                        newLoadedObjects.push_back(object);
-                        // Connect the ori to the registered object
-                        _objectRepository.RegisterLoadedObject(requiredObject, std::move(newObject));
+                        object = loadedObject;
                     }
                 }
-                else
-                {
-                    object = loadedObject;
-                }
+                objects[i] = object;
             }
-            objects[i] = object;
-        });
+        };
+        // Objects vary wildly in cost, hand them out one by one so a few large ones do not hold up a whole chunk.
+        _loadJobs->ParallelFor(requiredObjects.size(), 1, readObjects);
 
         // Load objects
         for (auto* obj : newLoadedObjects)
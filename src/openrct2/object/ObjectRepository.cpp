@@ -266,7 +266,7 @@ public:
         }
         if (String::Equals(extension, ".parkobj", true))
         {
-            return ObjectFactory::CreateObjectFromZipFile(*this, ori->Path);
+            return ObjectFactory::CreateObjectFromZipFile(*this, ori->Path, true);
         }
 
         return ObjectFactory::CreateObjectFromLegacyFile(*this, ori->Path.c_str());
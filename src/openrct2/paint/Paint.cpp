@@ -24,6 +24,8 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <limits>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -425,7 +427,180 @@ static paint_struct* PaintArrangeStructsHelperRotation(paint_struct* ps_next, ui
     }
 }
 
-template<int TRotation> static void PaintSessionArrange(PaintSessionCore* session, bool)
+/**
+ * The paint structs of the quadrant being arranged and its front neighbour, copied out of the linked list so that
+ * sorting only touches small contiguous arrays. The order is kept as a list of indices into them.
+ */
+struct PaintSortRange
+{
+    static constexpr uint32_t End = std::numeric_limits<uint32_t>::max();
+
+    std::vector<paint_struct*> Nodes;
+    std::vector<int32_t> X;
+    std::vector<int32_t> Y;
+    std::vector<int32_t> Z;
+    std::vector<int32_t> XEnd;
+    std::vector<int32_t> YEnd;
+    std::vector<int32_t> ZEnd;
+    std::vector<uint8_t> Flags;
+    std::vector<uint32_t> Next;
+
+    void Clear()
+    {
+        Nodes.clear();
+        X.clear();
+        Y.clear();
+        Z.clear();
+        XEnd.clear();
+        YEnd.clear();
+        ZEnd.clear();
+        Flags.clear();
+        Next.clear();
+    }
+
+    void Push(paint_struct* ps, uint8_t flags)
+    {
+        Next.push_back(static_cast<uint32_t>(Nodes.size() + 1));
+        Nodes.push_back(ps);
+        X.push_back(ps->bounds.x);
+        Y.push_back(ps->bounds.y);
+        Z.push_back(ps->bounds.z);
+        XEnd.push_back(ps->bounds.x_end);
+        YEnd.push_back(ps->bounds.y_end);
+        ZEnd.push_back(ps->bounds.z_end);
+        Flags.push_back(flags);
+    }
+};
+
+// Same as CheckBoundingBox<TRotation>, the rotations only differ in which of the x and y tests are flipped.
+template<uint8_t TRotation>
+static bool PaintSortCheckBoundingBox(const PaintSortRange& range, uint32_t initialIndex, uint32_t index)
+{
+    constexpr bool FlipX = TRotation == 1 || TRotation == 2;
+    constexpr bool FlipY = TRotation == 2 || TRotation == 3;
+
+    const bool frontX = FlipX ? range.XEnd[initialIndex] < range.X[index] : range.XEnd[initialIndex] >= range.X[index];
+    const bool frontY = FlipY ? range.YEnd[initialIndex] < range.Y[index] : range.YEnd[initialIndex] >= range.Y[index];
+    const bool overlapsX = FlipX ? range.X[initialIndex] >= range.XEnd[index] : range.X[initialIndex] < range.XEnd[index];
+    const bool overlapsY = FlipY ? range.Y[initialIndex] >= range.YEnd[index] : range.Y[initialIndex] < range.YEnd[index];
+    return range.ZEnd[initialIndex] >= range.Z[index] && frontY && frontX
+        && !(range.Z[initialIndex] < range.ZEnd[index] && overlapsY && overlapsX);
+}
+
+/**
+ * Does the same as PaintArrangeStructsHelperRotation on a compact copy of the quadrant and its neighbour, which is
+ * linked back into the list once arranged.
+ */
+template<uint8_t TRotation>
+static paint_struct* PaintArrangeStructsHelperCompact(
+    paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag, PaintSortRange& range)
+{
+    paint_struct* ps;
+
+    // Get the first node in the specified quadrant.
+    do
+    {
+        ps = ps_next;
+        ps_next = ps_next->next_quadrant_ps;
+        if (ps_next == nullptr)
+            return ps;
+    } while (quadrantIndex > ps_next->quadrant_index);
+
+    paint_struct* psQuadrantEntry = ps;
+
+    // Copy out all nodes up to the first one outside of the range along with their current sorting relevancy.
+    range.Clear();
+    paint_struct* psOutside = nullptr;
+    for (ps = psQuadrantEntry->next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+    {
+        if (ps->quadrant_index > quadrantIndex + 1)
+        {
+            ps->SortFlags = PaintSortFlags::OutsideQuadrant;
+            psOutside = ps;
+            break;
+        }
+
+        uint8_t sortFlags = ps->SortFlags;
+        if (ps->quadrant_index == quadrantIndex + 1)
+        {
+            sortFlags = PaintSortFlags::Neighbour | PaintSortFlags::PendingVisit;
+        }
+        else if (ps->quadrant_index == quadrantIndex)
+        {
+            sortFlags = flag | PaintSortFlags::PendingVisit;
+        }
+        range.Push(ps, sortFlags);
+    }
+    if (range.Nodes.empty())
+    {
+        return psQuadrantEntry;
+    }
+    range.Next.back() = PaintSortRange::End;
+
+    uint32_t head = 0;
+    uint32_t* next = range.Next.data();
+    uint8_t* flags = range.Flags.data();
+    uint32_t prevIndex = PaintSortRange::End;
+    while (true)
+    {
+        // Get the first pending node after the previous one.
+        uint32_t initialIndex = prevIndex == PaintSortRange::End ? head : next[prevIndex];
+        while (initialIndex != PaintSortRange::End && !(flags[initialIndex] & PaintSortFlags::PendingVisit))
+        {
+            prevIndex = initialIndex;
+            initialIndex = next[initialIndex];
+        }
+        if (initialIndex == PaintSortRange::End)
+            break;
+
+        // Mark visited.
+        flags[initialIndex] &= ~PaintSortFlags::PendingVisit;
+
+        // Compare current node against the remaining children.
+        uint32_t index = initialIndex;
+        uint32_t nextIndex = next[index];
+        while (nextIndex != PaintSortRange::End)
+        {
+            if ((flags[nextIndex] & PaintSortFlags::Neighbour)
+                && PaintSortCheckBoundingBox<TRotation>(range, initialIndex, nextIndex))
+            {
+                // Child node intersects with current node, move behind.
+                next[index] = next[nextIndex];
+                if (prevIndex == PaintSortRange::End)
+                {
+                    next[nextIndex] = head;
+                    head = nextIndex;
+                }
+                else
+                {
+                    next[nextIndex] = next[prevIndex];
+                    next[prevIndex] = nextIndex;
+                }
+            }
+            else
+            {
+                index = nextIndex;
+            }
+            nextIndex = next[index];
+        }
+    }
+
+    // Link the arranged nodes back into the list.
+    ps = psQuadrantEntry;
+    for (uint32_t index = head; index != PaintSortRange::End; index = next[index])
+    {
+        ps->next_quadrant_ps = range.Nodes[index];
+        ps = range.Nodes[index];
+        ps->SortFlags = flags[index];
+    }
+    ps->next_quadrant_ps = psOutside;
+    return psQuadrantEntry;
+}
+
+// Average number of paint structs per quadrant from which copying them out for sorting pays off.
+static constexpr uint32_t PaintSortCompactMinStructsPerQuadrant = 64;
+
+template<int TRotation> static void PaintSessionArrange(PaintSessionCore* session, PaintSortMethod method)
 {
     paint_struct* psHead = &session->PaintHead;
 
@@ -435,6 +610,7 @@ template<int TRotation> static void PaintSessionArrange(PaintSessionCore* sessio
     uint32_t quadrantIndex = session->QuadrantBackIndex;
     if (quadrantIndex != UINT32_MAX)
     {
+        uint32_t numStructs = 0;
         do
         {
             paint_struct* ps_next = session->Quadrants[quadrantIndex];
@@ -445,11 +621,34 @@ template<int TRotation> static void PaintSessionArrange(PaintSessionCore* sessio
                 {
                     ps = ps_next;
                     ps_next = ps_next->next_quadrant_ps;
-
+                    numStructs++;
                 } while (ps_next != nullptr);
             }
         } while (++quadrantIndex <= session->QuadrantFrontIndex);
 
+        if (method == PaintSortMethod::Auto)
+        {
+            const auto numQuadrants = session->QuadrantFrontIndex - session->QuadrantBackIndex + 1;
+            method = numStructs >= numQuadrants * PaintSortCompactMinStructsPerQuadrant ? PaintSortMethod::Compact
+                                                                                         : PaintSortMethod::Linked;
+        }
+
+        if (method == PaintSortMethod::Compact)
+        {
+            // Sessions are arranged on several paint threads at once.
+            thread_local PaintSortRange range;
+            paint_struct* ps_cache = PaintArrangeStructsHelperCompact<TRotation>(
+                psHead, session->QuadrantBackIndex & 0xFFFF, PaintSortFlags::Neighbour, range);
+
+            quadrantIndex = session->QuadrantBackIndex;
+            while (++quadrantIndex < session->QuadrantFrontIndex)
+            {
+                ps_cache = PaintArrangeStructsHelperCompact<TRotation>(
+                    ps_cache, quadrantIndex & 0xFFFF, PaintSortFlags::None, range);
+            }
+            return;
+        }
+
         paint_struct* ps_cache = PaintArrangeStructsHelperRotation<TRotation>(
             psHead, session->QuadrantBackIndex & 0xFFFF, PaintSortFlags::Neighbour);
 
@@ -465,18 +664,18 @@ template<int TRotation> static void PaintSessionArrange(PaintSessionCore* sessio
  *
  *  rct2: 0x00688217
  */
-void PaintSessionArrange(PaintSessionCore* session)
+void PaintSessionArrange(PaintSessionCore* session, PaintSortMethod method)
 {
     switch (session->CurrentRotation)
     {
         case 0:
-            return PaintSessionArrange<0>(session, true);
+            return PaintSessionArrange<0>(session, method);
         case 1:
-            return PaintSessionArrange<1>(session, true);
+            return PaintSessionArrange<1>(session, method);
         case 2:
-            return PaintSessionArrange<2>(session, true);
+            return PaintSessionArrange<2>(session, method);
         case 3:
-            return PaintSessionArrange<3>(session, true);
+            return PaintSessionArrange<3>(session, method);
     }
     Guard::Assert(false);
 }
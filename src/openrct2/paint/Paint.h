@@ -341,7 +341,18 @@ void PaintFloatingMoneyEffect(
 paint_session* PaintSessionAlloc(rct_drawpixelinfo* dpi, uint32_t viewFlags);
 void PaintSessionFree(paint_session* session);
 void PaintSessionGenerate(paint_session* session);
-void PaintSessionArrange(PaintSessionCore* session);
+/**
+ * How paint structs are put into drawing order. Both give the same order, Compact copies the bounding boxes of each
+ * quadrant into contiguous arrays first which is faster once quadrants hold many structs. Auto picks by density.
+ */
+enum class PaintSortMethod : uint8_t
+{
+    Auto,
+    Linked,
+    Compact,
+};
+
+void PaintSessionArrange(PaintSessionCore* session, PaintSortMethod method = PaintSortMethod::Auto);
 void PaintDrawStructs(paint_session* session);
 void PaintDrawMoneyStructs(rct_drawpixelinfo* dpi, paint_string_struct* ps);
 
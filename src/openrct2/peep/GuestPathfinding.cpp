@@ -19,6 +19,8 @@
 #include "../util/Util.h"
 #include "../world/Entrance.h"
 #include "../world/Footpath.h"
+#include "../world/Park.h"
+#include "PathfindingGraph.h"
 
 #include <bitset>
 #include <cstring>
@@ -266,7 +268,7 @@ static int32_t guest_surface_path_finding(Peep* peep)
  * Returns the type of the next footpath tile a peep can get to from x,y,z /
  * inputTileElement in the given direction.
  */
-static uint8_t footpath_element_next_in_direction(TileCoordsXYZ loc, PathElement* pathElement, Direction chosenDirection)
+static uint8_t footpath_element_find_next_in_direction(TileCoordsXYZ loc, PathElement* pathElement, Direction chosenDirection)
 {
     TileElement* nextTileElement;
 
@@ -302,6 +304,30 @@ static uint8_t footpath_element_next_in_direction(TileCoordsXYZ loc, PathElement
     return PATH_SEARCH_FAILED;
 }
 
+/**
+ * Returns the pathfinding graph node of a path element, the graph only knows elements at their own height.
+ */
+static PathfindingGraph::PathNode* get_path_node(const TileCoordsXYZ& loc, PathElement* pathElement)
+{
+    if (loc.z != pathElement->base_height)
+        return nullptr;
+    return PathfindingGraph::GetNode(loc, reinterpret_cast<TileElement*>(pathElement));
+}
+
+static uint8_t footpath_element_next_in_direction(TileCoordsXYZ loc, PathElement* pathElement, Direction chosenDirection)
+{
+    auto* node = get_path_node(loc, pathElement);
+    if (node != nullptr && node->NextInDirection[chosenDirection] != PathfindingGraph::Unknown)
+        return node->NextInDirection[chosenDirection];
+
+    uint8_t result = footpath_element_find_next_in_direction(loc, pathElement, chosenDirection);
+    if (node != nullptr)
+    {
+        node->NextInDirection[chosenDirection] = result;
+    }
+    return result;
+}
+
 /**
  *
  * Returns:
@@ -445,6 +471,21 @@ static uint8_t footpath_element_dest_in_dir(
 static uint8_t footpath_element_destination_in_direction(
     TileCoordsXYZ loc, PathElement* pathElement, Direction chosenDirection, ride_id_t* outRideIndex)
 {
+    // Staff walk through no entry signs, only the guest view of the network is kept.
+    auto* node = _peepPathFindIsStaff ? nullptr : get_path_node(loc, pathElement);
+    if (node != nullptr && node->DestinationVersion == PathfindingGraph::GetDestinationVersion())
+    {
+        uint8_t result = node->Destination[chosenDirection];
+        if (result != PathfindingGraph::Unknown)
+        {
+            if (result == PATH_SEARCH_RIDE_ENTRANCE || result == PATH_SEARCH_RIDE_EXIT || result == PATH_SEARCH_SHOP_ENTRANCE)
+            {
+                *outRideIndex = node->DestinationRide[chosenDirection];
+            }
+            return result;
+        }
+    }
+
     if (pathElement->IsSloped())
     {
         if (pathElement->GetSlopeDirection() == chosenDirection)
@@ -453,7 +494,20 @@ static uint8_t footpath_element_destination_in_direction(
         }
     }
 
-    return footpath_element_dest_in_dir(loc, chosenDirection, outRideIndex, 0);
+    ride_id_t rideIndex = *outRideIndex;
+    uint8_t result = footpath_element_dest_in_dir(loc, chosenDirection, &rideIndex, 0);
+    *outRideIndex = rideIndex;
+    if (node != nullptr)
+    {
+        if (node->DestinationVersion != PathfindingGraph::GetDestinationVersion())
+        {
+            node->DestinationVersion = PathfindingGraph::GetDestinationVersion();
+            std::fill(std::begin(node->Destination), std::end(node->Destination), PathfindingGraph::Unknown);
+        }
+        node->Destination[chosenDirection] = result;
+        node->DestinationRide[chosenDirection] = rideIndex;
+    }
+    return result;
 }
 
 /**
@@ -526,7 +580,7 @@ static uint8_t peep_pathfind_get_max_number_junctions(Peep* peep)
  * since entrances and ride queues coming off a path should not result in
  * the path being considered a junction.
  */
-static bool path_is_thin_junction(PathElement* path, const TileCoordsXYZ& loc)
+static bool path_find_thin_junction(PathElement* path, const TileCoordsXYZ& loc)
 {
     uint8_t edges = path->GetEdges();
 
@@ -558,6 +612,22 @@ static bool path_is_thin_junction(PathElement* path, const TileCoordsXYZ& loc)
     return thin_junction;
 }
 
+static bool path_is_thin_junction(PathElement* path, const TileCoordsXYZ& loc)
+{
+    auto* node = get_path_node(loc, path);
+    if (node != nullptr && node->IsThinJunction != PathfindingGraph::Unknown)
+        return node->IsThinJunction != 0;
+
+    bool thin_junction = path_find_thin_junction(path, loc);
+    // Looking at the neighbours may have added nodes to this tile, so look the node up again.
+    node = get_path_node(loc, path);
+    if (node != nullptr)
+    {
+        node->IsThinJunction = thin_junction ? 1 : 0;
+    }
+    return thin_junction;
+}
+
 static int32_t CalculateHeuristicPathingScore(const TileCoordsXYZ& loc1, const TileCoordsXYZ& loc2)
 {
     auto xDelta = abs(loc1.x - loc2.x) * 32;
@@ -1631,6 +1701,255 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
     return chosen_edge;
 }
 
+/**
+ * Whether guests heading for the current goal may walk on pathElement. Like the heuristic search they keep
+ * out of the queues of rides other than the one they are heading for.
+ */
+static bool guest_route_can_use_path(const PathElement* pathElement, ride_id_t queueRideIndex)
+{
+    if (pathElement->IsGhost())
+        return false;
+    return !pathElement->IsQueue() || pathElement->GetRideIndex() == RIDE_ID_NULL
+        || pathElement->GetRideIndex() == queueRideIndex;
+}
+
+/**
+ * The height a guest leaving pathElement in the given direction arrives at on the next tile.
+ */
+static int32_t guest_route_step_z(const PathElement* pathElement, Direction direction)
+{
+    int32_t z = pathElement->base_height;
+    if (pathElement->IsSloped() && pathElement->GetSlopeDirection() == direction)
+        z += 2;
+    return z;
+}
+
+/**
+ * Whether a guest arriving at loc in the given direction has reached goal, using the same elements the
+ * heuristic search accepts as the end of a search path.
+ */
+static bool guest_route_step_reaches_goal(const TileCoordsXYZ& loc, Direction direction, const TileCoordsXYZ& goal)
+{
+    if (loc.x != goal.x || loc.y != goal.y)
+        return false;
+
+    TileElement* tileElement = map_get_first_element_at(loc);
+    if (tileElement == nullptr)
+        return false;
+    do
+    {
+        if (tileElement->IsGhost())
+            continue;
+
+        switch (tileElement->GetType())
+        {
+            case TileElementType::Track:
+            {
+                if (loc.z != tileElement->base_height || loc.z != goal.z)
+                    continue;
+                auto ride = get_ride(tileElement->AsTrack()->GetRideIndex());
+                if (ride != nullptr && ride->GetRideTypeDescriptor().HasFlag(RIDE_TYPE_FLAG_IS_SHOP))
+                    return true;
+                break;
+            }
+            case TileElementType::Entrance:
+                if (loc.z != tileElement->base_height || loc.z != goal.z)
+                    continue;
+                if (tileElement->AsEntrance()->GetEntranceType() == ENTRANCE_TYPE_PARK_ENTRANCE)
+                    return true;
+                if (tileElement->GetDirection() == direction)
+                    return true;
+                break;
+            case TileElementType::Path:
+                if (IsValidPathZAndDirection(tileElement, loc.z, direction) && tileElement->base_height == goal.z)
+                    return true;
+                break;
+            default:
+                break;
+        }
+    } while (!(tileElement++)->IsLastForTile());
+    return false;
+}
+
+/**
+ * Returns the base height of the path a guest arriving at loc in the given direction walks onto, or -1 if
+ * there is none.
+ */
+static int32_t guest_route_step_path_z(const TileCoordsXYZ& loc, Direction direction, ride_id_t queueRideIndex)
+{
+    TileElement* tileElement = map_get_first_element_at(loc);
+    if (tileElement == nullptr)
+        return -1;
+    do
+    {
+        if (tileElement->GetType() != TileElementType::Path)
+            continue;
+        if (!guest_route_can_use_path(tileElement->AsPath(), queueRideIndex))
+            continue;
+        if (IsValidPathZAndDirection(tileElement, loc.z, direction))
+            return tileElement->base_height;
+    } while (!(tileElement++)->IsLastForTile());
+    return -1;
+}
+
+/**
+ * Adds every path a guest can walk from onto target to the field at the given distance. When target is the
+ * goal itself, which is not necessarily a path, it is reached as the heuristic search would reach it.
+ */
+static void guest_route_add_predecessors(
+    PathfindingGraph::DistanceField& field, std::vector<TileCoordsXYZ>& open, const TileCoordsXYZ& target, uint16_t distance,
+    const TileCoordsXYZ& goal, ride_id_t queueRideIndex, bool targetIsGoal)
+{
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        TileCoordsXY from{ target.x, target.y };
+        from -= TileDirectionDelta[direction];
+        if (from.x < 0 || from.y < 0 || from.x >= MAXIMUM_MAP_SIZE_TECHNICAL || from.y >= MAXIMUM_MAP_SIZE_TECHNICAL)
+            continue;
+
+        TileElement* tileElement = map_get_first_element_at(from);
+        if (tileElement == nullptr)
+            continue;
+        do
+        {
+            if (tileElement->GetType() != TileElementType::Path)
+                continue;
+            auto* pathElement = tileElement->AsPath();
+            if (!guest_route_can_use_path(pathElement, queueRideIndex))
+                continue;
+            if (!(path_get_permitted_edges(pathElement) & (1 << direction)))
+                continue;
+
+            const TileCoordsXYZ next{ target.x, target.y, guest_route_step_z(pathElement, direction) };
+            if (targetIsGoal)
+            {
+                if (!guest_route_step_reaches_goal(next, direction, goal))
+                    continue;
+            }
+            else if (guest_route_step_path_z(next, direction, queueRideIndex) != target.z)
+            {
+                continue;
+            }
+
+            const TileCoordsXYZ node{ from, pathElement->base_height };
+            if (field.Distances.emplace(PathfindingGraph::GetNodeKey(node), distance + 1).second)
+            {
+                open.push_back(node);
+            }
+        } while (!(tileElement++)->IsLastForTile());
+    }
+}
+
+/**
+ * Fills field with the number of steps to goal from every path that can reach it, working backwards from
+ * the goal one step at a time.
+ */
+static void guest_route_build_distance_field(
+    PathfindingGraph::DistanceField& field, const TileCoordsXYZ& goal, ride_id_t queueRideIndex)
+{
+    field.Version = PathfindingGraph::GetRouteVersion();
+    field.Distances.clear();
+
+    std::vector<TileCoordsXYZ> open;
+    guest_route_add_predecessors(field, open, goal, 0, goal, queueRideIndex, true);
+    for (size_t i = 0; i < open.size(); i++)
+    {
+        const TileCoordsXYZ node = open[i];
+        const uint16_t distance = field.Distances[PathfindingGraph::GetNodeKey(node)];
+        if (distance == std::numeric_limits<uint16_t>::max())
+            continue;
+        guest_route_add_predecessors(field, open, node, distance, goal, queueRideIndex, false);
+    }
+}
+
+/**
+ * Chooses the direction along the shortest route to gPeepPathFindGoalPosition using the distance field of the
+ * goal. Ties go to the lowest direction so every client makes the same choice.
+ *
+ * Returns INVALID_DIRECTION if the goal cannot be reached from loc.
+ */
+static Direction guest_route_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
+{
+    const TileCoordsXYZ goal = gPeepPathFindGoalPosition;
+    const ride_id_t queueRideIndex = gPeepPathFindQueueRideIndex;
+
+    auto& field = PathfindingGraph::GetDistanceField(goal, queueRideIndex);
+    if (field.Version != PathfindingGraph::GetRouteVersion())
+    {
+        guest_route_build_distance_field(field, goal, queueRideIndex);
+    }
+
+    Direction bestDirection = INVALID_DIRECTION;
+    uint32_t bestDistance = std::numeric_limits<uint32_t>::max();
+    TileElement* tileElement = map_get_first_element_at(loc);
+    if (tileElement == nullptr)
+        return INVALID_DIRECTION;
+    do
+    {
+        if (tileElement->base_height != loc.z)
+            continue;
+        if (tileElement->GetType() != TileElementType::Path)
+            continue;
+        auto* pathElement = tileElement->AsPath();
+        const int32_t edges = path_get_permitted_edges(pathElement);
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if (!(edges & (1 << direction)))
+                continue;
+
+            const TileCoordsXY nextXY = TileCoordsXY{ loc.x, loc.y } + TileDirectionDelta[direction];
+            const TileCoordsXYZ next{ nextXY, guest_route_step_z(pathElement, direction) };
+            uint32_t distance;
+            if (guest_route_step_reaches_goal(next, direction, goal))
+            {
+                distance = 0;
+            }
+            else
+            {
+                const int32_t pathZ = guest_route_step_path_z(next, direction, queueRideIndex);
+                if (pathZ < 0)
+                    continue;
+                auto it = field.Distances.find(PathfindingGraph::GetNodeKey({ nextXY, pathZ }));
+                if (it == field.Distances.end())
+                    continue;
+                distance = it->second;
+            }
+
+            if (distance < bestDistance || (distance == bestDistance && direction < bestDirection))
+            {
+                bestDistance = distance;
+                bestDirection = direction;
+            }
+        }
+    } while (!(tileElement++)->IsLastForTile());
+
+    if (bestDirection != INVALID_DIRECTION && peep->PathfindGoal != goal)
+    {
+        // Keep the goal up to date so the heuristic search starts afresh if it takes over again.
+        peep->PathfindGoal = { goal, 0 };
+        TileCoordsXYZD nullPos;
+        nullPos.SetNull();
+        std::fill(std::begin(peep->PathfindHistory), std::end(peep->PathfindHistory), nullPos);
+    }
+    return bestDirection;
+}
+
+/**
+ * Chooses the direction a guest takes towards gPeepPathFindGoalPosition. Parks with shared guest routes
+ * enabled follow the distance field of the goal, everywhere else and whenever the field has no route the
+ * heuristic search is used.
+ */
+static Direction guest_path_find_choose_goal_direction(const TileCoordsXYZ& loc, Peep* peep)
+{
+    if (gParkFlags & PARK_FLAGS_SHARED_GUEST_ROUTES)
+    {
+        Direction direction = guest_route_choose_direction(loc, peep);
+        if (direction != INVALID_DIRECTION)
+            return direction;
+    }
+    return peep_pathfind_choose_direction(loc, peep);
+}
+
 /**
  * Gets the nearest park entrance relative to point, by using Manhattan distance.
  * @param x x coordinate of location
@@ -1770,7 +2089,7 @@ static int32_t GuestPathFindParkEntranceLeaving(Peep* peep, uint8_t edges)
     PathfindLoggingEnable(peep);
 #endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
 
-    Direction chosenDirection = peep_pathfind_choose_direction(TileCoordsXYZ{ peep->NextLoc }, peep);
+    Direction chosenDirection = guest_path_find_choose_goal_direction(TileCoordsXYZ{ peep->NextLoc }, peep);
 
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
     PathfindLoggingDisable();
@@ -2227,7 +2546,7 @@ int32_t guest_path_finding(Guest* peep)
     gPeepPathFindGoalPosition = loc;
     gPeepPathFindIgnoreForeignQueues = true;
 
-    direction = peep_pathfind_choose_direction(TileCoordsXYZ{ peep->NextLoc }, peep);
+    direction = guest_path_find_choose_goal_direction(TileCoordsXYZ{ peep->NextLoc }, peep);
 
     if (direction == INVALID_DIRECTION)
     {
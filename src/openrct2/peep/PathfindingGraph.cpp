@@ -0,0 +1,141 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "PathfindingGraph.h"
+
+#include "../util/Util.h"
+#include "../world/Map.h"
+
+#include <unordered_map>
+#include <vector>
+
+// Elements further up a tile than this are not cached.
+static constexpr ptrdiff_t MaxNodeOffset = 255;
+
+struct TileNodes
+{
+    bool Valid;
+    std::vector<PathfindingGraph::PathNode> Nodes;
+};
+
+// Maps are mostly empty space, only tiles the pathfinding has visited are stored.
+static std::unordered_map<uint32_t, TileNodes> _tiles;
+static std::unordered_map<uint64_t, PathfindingGraph::DistanceField> _distanceFields;
+static uint32_t _destinationVersion = 1;
+static uint32_t _routeVersion = 1;
+static bool _enabled = true;
+
+static constexpr PathfindingGraph::PathNode EmptyNode = {
+    { PathfindingGraph::Unknown, PathfindingGraph::Unknown, PathfindingGraph::Unknown, PathfindingGraph::Unknown },
+    PathfindingGraph::Unknown,
+    {},
+    {},
+    0,
+};
+
+static uint32_t GetTileKey(const TileCoordsXY& loc)
+{
+    return static_cast<uint32_t>(loc.y) * MAXIMUM_MAP_SIZE_TECHNICAL + static_cast<uint32_t>(loc.x);
+}
+
+PathfindingGraph::PathNode* PathfindingGraph::GetNode(const TileCoordsXYZ& loc, const TileElement* pathElement)
+{
+    if (!_enabled)
+        return nullptr;
+    if (loc.x < 0 || loc.y < 0 || loc.x >= MAXIMUM_MAP_SIZE_TECHNICAL || loc.y >= MAXIMUM_MAP_SIZE_TECHNICAL)
+        return nullptr;
+
+    const TileElement* firstElement = map_get_first_element_at(TileCoordsXY{ loc.x, loc.y });
+    if (firstElement == nullptr)
+        return nullptr;
+
+    const ptrdiff_t offset = pathElement - firstElement;
+    if (offset < 0 || offset >= MaxNodeOffset)
+        return nullptr;
+
+    auto& tile = _tiles[GetTileKey({ loc.x, loc.y })];
+    if (!tile.Valid)
+    {
+        tile.Valid = true;
+        tile.Nodes.clear();
+    }
+    if (tile.Nodes.size() <= static_cast<size_t>(offset))
+    {
+        tile.Nodes.resize(offset + 1, EmptyNode);
+    }
+    return &tile.Nodes[offset];
+}
+
+void PathfindingGraph::SetEnabled(bool enabled)
+{
+    _enabled = enabled;
+    InvalidateAll();
+}
+
+uint32_t PathfindingGraph::GetDestinationVersion()
+{
+    return _destinationVersion;
+}
+
+uint32_t PathfindingGraph::GetRouteVersion()
+{
+    return _routeVersion;
+}
+
+uint32_t PathfindingGraph::GetNodeKey(const TileCoordsXYZ& loc)
+{
+    return (GetTileKey({ loc.x, loc.y }) << 8) | static_cast<uint8_t>(loc.z);
+}
+
+PathfindingGraph::DistanceField& PathfindingGraph::GetDistanceField(const TileCoordsXYZ& goal, ride_id_t queueRideIndex)
+{
+    const uint64_t key = (static_cast<uint64_t>(EnumValue(queueRideIndex)) << 32) | GetNodeKey(goal);
+    return _distanceFields[key];
+}
+
+void PathfindingGraph::InvalidateTile(const CoordsXY& loc)
+{
+    // Nodes depend on the path elements of the neighbouring tiles.
+    const TileCoordsXY tileLoc{ loc };
+    for (int32_t dy = -1; dy <= 1; dy++)
+    {
+        for (int32_t dx = -1; dx <= 1; dx++)
+        {
+            if (dx != 0 && dy != 0)
+                continue;
+
+            const TileCoordsXY neighbour{ tileLoc.x + dx, tileLoc.y + dy };
+            if (neighbour.x < 0 || neighbour.y < 0 || neighbour.x >= MAXIMUM_MAP_SIZE_TECHNICAL
+                || neighbour.y >= MAXIMUM_MAP_SIZE_TECHNICAL)
+                continue;
+
+            auto it = _tiles.find(GetTileKey(neighbour));
+            if (it != _tiles.end())
+            {
+                it->second.Valid = false;
+            }
+        }
+    }
+
+    // The destinations along an edge can lead through this tile from far away.
+    _destinationVersion++;
+}
+
+void PathfindingGraph::InvalidateAll()
+{
+    // Drop the tiles rather than marking them, the nodes of tiles guests no longer visit would otherwise stay around.
+    _tiles.clear();
+    _destinationVersion++;
+}
+
+void PathfindingGraph::InvalidateRoutes()
+{
+    _routeVersion++;
+    _distanceFields.clear();
+}
@@ -0,0 +1,86 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../ride/RideTypes.h"
+#include "../world/Location.hpp"
+
+#include <unordered_map>
+
+struct TileElement;
+
+/**
+ * Persistent per path element data for the guest pathfinding. Everything the heuristic search derives
+ * from the neighbouring tiles of a path element is worked out once and kept until the footpath network
+ * around it changes, so the search no longer re-walks the tile elements of every neighbour each time it
+ * passes a junction.
+ *
+ * Nodes are identified by their tile and the position of their element within the tile. The neighbour
+ * data of a node is invalidated with the tiles around it, the destinations along its edges follow single
+ * width paths for up to 25 tiles and are invalidated with any change to the network.
+ *
+ * Guests only look for paths while provisional construction is stashed away, so the graph describes the
+ * map without ghosts. Ghost elements coming and going leave it alone.
+ */
+namespace PathfindingGraph
+{
+    constexpr uint8_t Unknown = 0xFF;
+
+    struct PathNode
+    {
+        // Result of footpath_element_next_in_direction for each edge.
+        uint8_t NextInDirection[NumOrthogonalDirections];
+        // Unknown, 0 or 1.
+        uint8_t IsThinJunction;
+        // Result of footpath_element_destination_in_direction for each edge, valid for DestinationVersion.
+        uint8_t Destination[NumOrthogonalDirections];
+        ride_id_t DestinationRide[NumOrthogonalDirections];
+        uint32_t DestinationVersion;
+    };
+
+    /**
+     * Number of steps to a goal from every path that can reach it, keyed by GetNodeKey. Fields are
+     * worked out in full the first time a guest asks for them and are valid for the route version
+     * they were built for.
+     */
+    struct DistanceField
+    {
+        uint32_t Version;
+        std::unordered_map<uint32_t, uint16_t> Distances;
+    };
+
+    /**
+     * Returns the node of a path element on the tile at loc, creating an empty one if it is not known yet.
+     * Returns nullptr for elements that cannot be cached and while the graph is disabled.
+     */
+    PathNode* GetNode(const TileCoordsXYZ& loc, const TileElement* pathElement);
+    // Without the graph every decision walks the neighbouring tiles again, bench-pathfinding compares both.
+    void SetEnabled(bool enabled);
+    uint32_t GetDestinationVersion();
+    uint32_t GetRouteVersion();
+
+    // Overlaid path elements at the same height share a key.
+    uint32_t GetNodeKey(const TileCoordsXYZ& loc);
+    /**
+     * Returns the distance field towards goal for guests that may only enter the queues of queueRideIndex.
+     * The field is empty and has version 0 when it has not been built yet.
+     */
+    DistanceField& GetDistanceField(const TileCoordsXYZ& goal, ride_id_t queueRideIndex);
+
+    // Forgets the tile and the neighbour data of the tiles next to it.
+    void InvalidateTile(const CoordsXY& loc);
+    void InvalidateAll();
+    /**
+     * Drops the distance fields. Guests only route while provisional construction is stashed away, so unlike
+     * the node data the fields only have to follow changes to real elements, not ghosts coming and going.
+     */
+    void InvalidateRoutes();
+} // namespace PathfindingGraph
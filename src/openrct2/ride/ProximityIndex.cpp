@@ -0,0 +1,110 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ProximityIndex.h"
+
+#include "../world/Map.h"
+#include "../world/Surface.h"
+
+#include <atomic>
+#include <memory>
+
+using namespace ProximityIndex;
+
+// Each entry packs the version it was worked out for with the features, so it can be read and written in one go.
+static std::unique_ptr<std::atomic<uint64_t>[]> _tiles;
+static int32_t _size;
+static uint32_t _version = 1;
+
+static TileFeatures GetFeatures(const CoordsXY& loc)
+{
+    TileFeatures features{};
+    TileElement* tileElement = map_get_first_element_at(loc);
+    if (tileElement == nullptr)
+        return features;
+    do
+    {
+        if (tileElement->IsGhost())
+            continue;
+
+        switch (tileElement->GetType())
+        {
+            case TileElementType::Surface:
+                if (features.Flags & TILE_HAS_SURFACE)
+                {
+                    features.Flags |= TILE_HAS_EXTRA_SURFACE;
+                    break;
+                }
+                features.Flags |= TILE_HAS_SURFACE;
+                features.SurfaceBaseHeight = tileElement->base_height;
+                if (tileElement->AsSurface()->GetWaterHeight() != 0)
+                    features.Flags |= TILE_HAS_WATER;
+                break;
+            case TileElementType::Path:
+                features.Flags |= TILE_HAS_PATH;
+                break;
+            case TileElementType::Track:
+                features.Flags |= TILE_HAS_TRACK;
+                break;
+            case TileElementType::SmallScenery:
+            case TileElementType::LargeScenery:
+                features.Flags |= TILE_HAS_SCENERY;
+                break;
+            default:
+                break;
+        }
+    } while (!(tileElement++)->IsLastForTile());
+    return features;
+}
+
+static uint64_t Pack(uint32_t version, const TileFeatures& features)
+{
+    return (static_cast<uint64_t>(version) << 32) | (features.Flags << 8) | features.SurfaceBaseHeight;
+}
+
+static TileFeatures Unpack(uint64_t entry)
+{
+    return { static_cast<uint8_t>(entry >> 8), static_cast<uint8_t>(entry) };
+}
+
+TileFeatures ProximityIndex::Get(const CoordsXY& loc)
+{
+    const TileCoordsXY tileLoc{ loc };
+    if (tileLoc.x < 0 || tileLoc.y < 0 || tileLoc.x >= _size || tileLoc.y >= _size)
+        return GetFeatures(loc);
+
+    auto& entry = _tiles[tileLoc.y * _size + tileLoc.x];
+    const uint64_t packed = entry.load(std::memory_order_relaxed);
+    if ((packed >> 32) == _version)
+        return Unpack(packed);
+
+    // Threads racing for the same tile work out the same features.
+    const auto features = GetFeatures(loc);
+    entry.store(Pack(_version, features), std::memory_order_relaxed);
+    return features;
+}
+
+void ProximityIndex::InvalidateTile(const CoordsXY& loc)
+{
+    const TileCoordsXY tileLoc{ loc };
+    if (tileLoc.x < 0 || tileLoc.y < 0 || tileLoc.x >= _size || tileLoc.y >= _size)
+        return;
+
+    _tiles[tileLoc.y * _size + tileLoc.x].store(0, std::memory_order_relaxed);
+}
+
+void ProximityIndex::InvalidateAll()
+{
+    if (_size != gMapSize)
+    {
+        _size = gMapSize;
+        _tiles = std::make_unique<std::atomic<uint64_t>[]>(static_cast<size_t>(_size) * _size);
+    }
+    _version++;
+}
@@ -0,0 +1,47 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+
+/**
+ * Summary of the tile elements on each tile that the ride ratings proximity scoring looks for. Most tiles
+ * next to a track are plain land, the summary lets the scoring skip walking their elements and read the
+ * land height straight from the index.
+ *
+ * Entries are worked out the first time a tile is asked for and kept until the tile changes. Lookups may
+ * happen from several threads at once, invalidation only happens on the thread updating the game state.
+ */
+namespace ProximityIndex
+{
+    enum : uint8_t
+    {
+        TILE_HAS_SURFACE = 1 << 0,
+        TILE_HAS_WATER = 1 << 1,
+        TILE_HAS_PATH = 1 << 2,
+        TILE_HAS_TRACK = 1 << 3,
+        TILE_HAS_SCENERY = 1 << 4,
+        // More than one surface element, the land height alone does not describe the tile.
+        TILE_HAS_EXTRA_SURFACE = 1 << 5,
+    };
+
+    struct TileFeatures
+    {
+        uint8_t Flags;
+        // Base height of the surface element.
+        uint8_t SurfaceBaseHeight;
+    };
+
+    TileFeatures Get(const CoordsXY& loc);
+
+    void InvalidateTile(const CoordsXY& loc);
+    void InvalidateAll();
+} // namespace ProximityIndex
@@ -5699,7 +5699,7 @@ void ride_clear_leftover_entrances(Ride* ride)
                 if (entrance->GetRideIndex() != ride->id)
                     continue;
 
-                tile_element_remove(entrance->as<TileElement>());
+                tile_element_remove(tilePos.ToCoordsXY(), entrance->as<TileElement>());
             }
         }
     }
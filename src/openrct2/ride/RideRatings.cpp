@@ -11,13 +11,16 @@
 
 #include "../Cheats.h"
 #include "../Context.h"
+#include "../LogicPhaseGraph.h"
 #include "../OpenRCT2.h"
+#include "../core/JobPool.h"
 #include "../interface/Window.h"
 #include "../localisation/Date.h"
 #include "../scripting/ScriptEngine.h"
 #include "../world/Footpath.h"
 #include "../world/Map.h"
 #include "../world/Surface.h"
+#include "ProximityIndex.h"
 #include "Ride.h"
 #include "RideData.h"
 #include "Station.h"
@@ -25,6 +28,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <vector>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Scripting;
@@ -79,6 +83,8 @@ struct ShelteredEights
 RideRatingUpdateState gRideRatingUpdateState;
 
 static void ride_ratings_update_state(RideRatingUpdateState& state);
+static void ride_ratings_survey(RideRatingUpdateState& state, ride_id_t rideIndex);
+static bool ride_ratings_should_update(const Ride& ride);
 static void ride_ratings_update_state_0(RideRatingUpdateState& state);
 static void ride_ratings_update_state_1(RideRatingUpdateState& state);
 static void ride_ratings_update_state_2(RideRatingUpdateState& state);
@@ -87,6 +93,7 @@ static void ride_ratings_update_state_4(RideRatingUpdateState& state);
 static void ride_ratings_update_state_5(RideRatingUpdateState& state);
 static void ride_ratings_begin_proximity_loop(RideRatingUpdateState& state);
 static void ride_ratings_calculate(RideRatingUpdateState& state, Ride* ride);
+static void ride_ratings_call_hooks(Ride* ride);
 static void ride_ratings_calculate_value(Ride* ride);
 static void ride_ratings_score_close_proximity(RideRatingUpdateState& state, TileElement* inputTileElement);
 
@@ -103,8 +110,7 @@ void ride_ratings_update_ride(const Ride& ride)
     RideRatingUpdateState state;
     if (ride.status != RideStatus::Closed)
     {
-        state.CurrentRide = ride.id;
-        state.State = RIDE_RATINGS_STATE_INITIALISE;
+        ride_ratings_survey(state, ride.id);
         while (state.State != RIDE_RATINGS_STATE_FIND_NEXT_RIDE)
         {
             ride_ratings_update_state(state);
@@ -126,6 +132,68 @@ void ride_ratings_update_all()
     ride_ratings_update_state(gRideRatingUpdateState);
 }
 
+/**
+ * Recalculates the ratings of every ride at once, with the same results as ride_ratings_update_ride. Walking
+ * the track of each ride and scoring its surroundings only reads the map and rides, so those surveys run on
+ * the job pool when one is given. The calculations themselves run on the calling thread in ride order as
+ * they can call into scripts.
+ */
+void ride_ratings_update_rides(JobPool* jobPool)
+{
+    std::vector<RideRatingUpdateState> surveys;
+    for (const auto& ride : GetRideManager())
+    {
+        if (ride_ratings_should_update(ride))
+        {
+            auto& survey = surveys.emplace_back();
+            survey.CurrentRide = ride.id;
+        }
+    }
+
+    // Each survey writes to its own state.
+    auto surveyRange = [&surveys](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            ride_ratings_survey(surveys[i], surveys[i].CurrentRide);
+        }
+    };
+    if (jobPool != nullptr)
+    {
+        jobPool->ParallelFor(surveys.size(), 1, surveyRange);
+    }
+    else
+    {
+        surveyRange(0, surveys.size());
+    }
+
+    for (auto& state : surveys)
+    {
+        while (state.State != RIDE_RATINGS_STATE_FIND_NEXT_RIDE)
+        {
+            ride_ratings_update_state(state);
+        }
+    }
+}
+
+/**
+ * Walks the track of a ride and scores its surroundings, leaving state ready for the calculation or
+ * finished if the ride cannot be rated.
+ */
+static void ride_ratings_survey(RideRatingUpdateState& state, ride_id_t rideIndex)
+{
+    state.CurrentRide = rideIndex;
+    state.State = RIDE_RATINGS_STATE_INITIALISE;
+    while (state.State != RIDE_RATINGS_STATE_CALCULATE && state.State != RIDE_RATINGS_STATE_FIND_NEXT_RIDE)
+    {
+        ride_ratings_update_state(state);
+    }
+}
+
+static bool ride_ratings_should_update(const Ride& ride)
+{
+    return ride.status != RideStatus::Closed && !(ride.lifecycle_flags & RIDE_LIFECYCLE_FIXED_RATINGS);
+}
+
 static void ride_ratings_update_state(RideRatingUpdateState& state)
 {
     switch (state.State)
@@ -283,9 +351,17 @@ static void ride_ratings_update_state_3(RideRatingUpdateState& state)
     }
 
     ride_ratings_calculate(state, ride);
-    ride_ratings_calculate_value(ride);
 
-    window_invalidate_by_number(WC_RIDE, EnumValue(state.CurrentRide));
+    // Scripts and windows are only safe on the thread updating the game state.
+    LogicPhaseGraph::Defer([rideIndex = state.CurrentRide]() {
+        auto deferredRide = get_ride(rideIndex);
+        if (deferredRide != nullptr)
+        {
+            ride_ratings_call_hooks(deferredRide);
+            ride_ratings_calculate_value(deferredRide);
+            window_invalidate_by_number(WC_RIDE, EnumValue(rideIndex));
+        }
+    });
     state.State = RIDE_RATINGS_STATE_FIND_NEXT_RIDE;
 }
 
@@ -421,6 +497,18 @@ static void ride_ratings_score_close_proximity_in_direction(
     if (!map_is_location_valid(scorePos))
         return;
 
+    // Plain land only scores for being close to the side of the track.
+    const auto features = ProximityIndex::Get(scorePos);
+    if ((features.Flags & ~ProximityIndex::TILE_HAS_WATER) == ProximityIndex::TILE_HAS_SURFACE)
+    {
+        if (state.ProximityBaseHeight <= inputTileElement->base_height
+            && inputTileElement->clearance_height <= features.SurfaceBaseHeight)
+        {
+            proximity_score_increment(state, PROXIMITY_SURFACE_SIDE_CLOSE);
+        }
+        return;
+    }
+
     TileElement* tileElement = map_get_first_element_at(scorePos);
     if (tileElement == nullptr)
         return;
@@ -477,6 +565,11 @@ static void ride_ratings_score_close_proximity_in_direction(
 
 static void ride_ratings_score_close_proximity_loops_helper(RideRatingUpdateState& state, const CoordsXYE& coordsElement)
 {
+    // Only paths and track score for passing through a loop.
+    const auto features = ProximityIndex::Get(coordsElement);
+    if (!(features.Flags & (ProximityIndex::TILE_HAS_PATH | ProximityIndex::TILE_HAS_TRACK)))
+        return;
+
     TileElement* tileElement = map_get_first_element_at(coordsElement);
     if (tileElement == nullptr)
         return;
@@ -738,7 +831,10 @@ static void ride_ratings_calculate(RideRatingUpdateState& state, Ride* ride)
         ride->ratings.nausea = max(0, ride->ratings.nausea);
     }
 #endif
+}
 
+static void ride_ratings_call_hooks(Ride* ride)
+{
 #ifdef ENABLE_SCRIPTING
     auto& hookEngine = GetContext()->GetScriptEngine().GetHookEngine();
     if (hookEngine.HasSubscriptions(HOOK_TYPE::RIDE_RATINGS_CALCULATE))
@@ -13,6 +13,8 @@
 #include "../world/Location.hpp"
 #include "RideTypes.h"
 
+class JobPool;
+
 using ride_rating = fixed16_2dp;
 using track_type_t = uint16_t;
 
@@ -58,6 +60,7 @@ extern RideRatingUpdateState gRideRatingUpdateState;
 
 void ride_ratings_update_ride(const Ride& ride);
 void ride_ratings_update_all();
+void ride_ratings_update_rides(JobPool* jobPool = nullptr);
 
 using ride_ratings_calculation = void (*)(Ride* ride, RideRatingUpdateState& state);
 ride_ratings_calculation ride_ratings_get_calculate_func(uint8_t rideType);
@@ -19,9 +19,9 @@ namespace TrainManager
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        while (!cursor.AtEnd() && Entity == nullptr)
         {
-            Entity = GetEntity<Vehicle>(*iter++);
+            Entity = GetEntity<Vehicle>(cursor.Next());
             if (Entity != nullptr && !Entity->IsHead())
             {
                 Entity = nullptr;
@@ -21,6 +21,8 @@
 #include "../world/Map.h"
 #include "../world/MapAnimation.h"
 
+#include <functional>
+
 using random_engine_t = Random::Rct2::Engine;
 
 enum
@@ -180,6 +182,13 @@ uint32_t scenario_rand_max(uint32_t max);
 
 bool scenario_prepare_for_save();
 int32_t scenario_save(const utf8* path, int32_t flags);
+/**
+ * Saves like scenario_save, but only serialises the park on the calling thread. The file is compressed and written on a
+ * background thread, which then invokes callback with the result. Returns false if the park could not be serialised.
+ */
+bool scenario_save_async(const utf8* path, int32_t flags, std::function<void(bool)> callback);
+// Blocks until every save started with scenario_save_async has been written.
+void scenario_save_async_wait();
 void scenario_failure();
 void scenario_success();
 void scenario_success_submit_name(const char* name);
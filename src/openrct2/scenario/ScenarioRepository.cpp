@@ -11,6 +11,7 @@
 
 #include "../Context.h"
 #include "../Game.h"
+#include "../ParkFile.h"
 #include "../ParkImporter.h"
 #include "../PlatformEnvironment.h"
 #include "../config/Config.h"
@@ -203,15 +204,11 @@ private:
                 bool result = false;
                 try
                 {
-                    auto& objRepository = OpenRCT2::GetContext()->GetObjectRepository();
-                    auto importer = ParkImporter::CreateParkFile(objRepository);
-                    importer->LoadScenario(path.c_str(), true);
-                    if (importer->GetDetails(entry))
-                    {
-                        String::Set(entry->path, sizeof(entry->path), path.c_str());
-                        entry->timestamp = timestamp;
-                        result = true;
-                    }
+                    auto metadata = OpenRCT2::ReadParkFileMetadata(path);
+                    *entry = metadata.Scenario;
+                    String::Set(entry->path, sizeof(entry->path), path.c_str());
+                    entry->timestamp = timestamp;
+                    result = true;
                 }
                 catch (const std::exception&)
                 {
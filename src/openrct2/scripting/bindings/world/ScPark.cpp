@@ -43,6 +43,7 @@ namespace OpenRCT2::Scripting
         { "difficultParkRating", PARK_FLAGS_DIFFICULT_PARK_RATING },
         { "noMoney", PARK_FLAGS_NO_MONEY_SCENARIO },
         { "unlockAllPrices", PARK_FLAGS_UNLOCK_ALL_PRICES },
+        { "sharedGuestRoutes", PARK_FLAGS_SHARED_GUEST_ROUTES },
     });
 
     money64 ScPark::cash_get() const
@@ -15,6 +15,8 @@
 #    include "../../../common.h"
 #    include "../../../core/Guard.hpp"
 #    include "../../../entity/EntityRegistry.h"
+#    include "../../../peep/PathfindingGraph.h"
+#    include "../../../ride/ProximityIndex.h"
 #    include "../../../ride/Track.h"
 #    include "../../../world/Footpath.h"
 #    include "../../../world/Scenery.h"
@@ -126,6 +128,9 @@ namespace OpenRCT2::Scripting
                 }
             }
             map_invalidate_tile_full(_coords);
+            PathfindingGraph::InvalidateTile(_coords);
+            PathfindingGraph::InvalidateRoutes();
+            ProximityIndex::InvalidateTile(_coords);
         }
     }
 
@@ -195,7 +200,7 @@ namespace OpenRCT2::Scripting
         auto first = GetFirstElement();
         if (index < GetNumElements(first))
         {
-            tile_element_remove(&first[index]);
+            tile_element_remove(_coords, &first[index]);
             map_invalidate_tile_full(_coords);
         }
     }
@@ -15,6 +15,8 @@
 #    include "../../../common.h"
 #    include "../../../core/Guard.hpp"
 #    include "../../../entity/EntityRegistry.h"
+#    include "../../../peep/PathfindingGraph.h"
+#    include "../../../ride/ProximityIndex.h"
 #    include "../../../ride/Ride.h"
 #    include "../../../ride/Track.h"
 #    include "../../../world/Footpath.h"
@@ -1550,6 +1552,9 @@ namespace OpenRCT2::Scripting
     void ScTileElement::Invalidate()
     {
         map_invalidate_tile_full(_coords);
+        PathfindingGraph::InvalidateTile(_coords);
+        PathfindingGraph::InvalidateRoutes();
+        ProximityIndex::InvalidateTile(_coords);
     }
 
     void ScTileElement::Register(duk_context* ctx)
@@ -740,7 +740,7 @@ std::vector<uint8_t> Gzip(const void* data, const size_t dataLen)
     return output;
 }
 
-std::vector<uint8_t> Ungzip(const void* data, const size_t dataLen)
+std::vector<uint8_t> Ungzip(const void* data, const size_t dataLen, const size_t maxLen)
 {
     assert(data != nullptr);
 
@@ -780,6 +780,11 @@ std::vector<uint8_t> Ungzip(const void* data, const size_t dataLen)
                 throw std::runtime_error("deflate failed with error " + std::to_string(ret));
             }
             output.resize(output.size() - strm.avail_out);
+            if (output.size() > maxLen)
+            {
+                inflateEnd(&strm);
+                throw std::runtime_error("inflated data exceeds " + std::to_string(maxLen) + " bytes");
+            }
         } while (strm.avail_out == 0);
 
         src += nextBlockSize;
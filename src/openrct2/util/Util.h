@@ -59,7 +59,8 @@ std::optional<std::vector<uint8_t>> util_zlib_deflate(const uint8_t* data, size_
 uint8_t* util_zlib_inflate(const uint8_t* data, size_t data_in_size, size_t* data_out_size);
 bool util_gzip_compress(FILE* source, FILE* dest);
 std::vector<uint8_t> Gzip(const void* data, const size_t dataLen);
-std::vector<uint8_t> Ungzip(const void* data, const size_t dataLen);
+// Throws when the output would grow beyond maxLen.
+std::vector<uint8_t> Ungzip(const void* data, const size_t dataLen, const size_t maxLen = SIZE_MAX);
 
 int8_t add_clamp_int8_t(int8_t value, int8_t value_to_add);
 int16_t add_clamp_int16_t(int16_t value, int16_t value_to_add);
@@ -46,7 +46,7 @@ static int32_t map_place_clear_func(
 
     map_invalidate_tile({ coords, (*tile_element)->GetBaseZ(), (*tile_element)->GetClearanceZ() });
 
-    tile_element_remove(*tile_element);
+    tile_element_remove(coords, *tile_element);
 
     (*tile_element)--;
     return 0;
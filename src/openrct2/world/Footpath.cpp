@@ -27,6 +27,7 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../paint/VirtualFloor.h"
+#include "../peep/PathfindingGraph.h"
 #include "../ride/RideData.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
@@ -1021,6 +1022,8 @@ static void loc_6A6C85(
  */
 void footpath_connect_edges(const CoordsXY& footpathPos, TileElement* tileElement, int32_t flags)
 {
+    PathfindingGraph::InvalidateTile(footpathPos);
+
     rct_neighbour_list neighbourList;
     rct_neighbour neighbour;
 
@@ -1084,6 +1087,9 @@ void footpath_chain_ride_queue(
     ride_id_t rideIndex, int32_t entranceIndex, const CoordsXY& initialFootpathPos, TileElement* const initialTileElement,
     int32_t direction)
 {
+    // Chains can run along the whole queue line.
+    PathfindingGraph::InvalidateAll();
+
     TileElement *lastPathElement, *lastQueuePathElement;
     auto tileElement = initialTileElement;
     auto curQueuePos = initialFootpathPos;
@@ -1228,6 +1234,8 @@ void footpath_queue_chain_push(ride_id_t rideIndex)
  */
 void footpath_update_queue_chains()
 {
+    PathfindingGraph::InvalidateAll();
+
     for (auto* queueChainPtr = _footpathQueueChain; queueChainPtr < _footpathQueueChainNext; queueChainPtr++)
     {
         ride_id_t rideIndex = *queueChainPtr;
@@ -1837,7 +1845,27 @@ static TileElement* footpath_can_be_wide(const CoordsXYZ& footpathPos)
  *
  *  rct2: 0x006A87BB
  */
-void footpath_update_path_wide_flags(const CoordsXY& footpathPos)
+static uint64_t footpath_get_wide_flags(const CoordsXY& footpathPos)
+{
+    uint64_t wideFlags = 0;
+    TileElement* tileElement = map_get_first_element_at(footpathPos);
+    if (tileElement == nullptr)
+        return wideFlags;
+    int32_t index = 0;
+    do
+    {
+        if (tileElement->GetType() != TileElementType::Path)
+            continue;
+        if (tileElement->AsPath()->IsWide() && index < 64)
+        {
+            wideFlags |= 1ULL << index;
+        }
+        index++;
+    } while (!(tileElement++)->IsLastForTile());
+    return wideFlags;
+}
+
+static void footpath_update_path_wide_flags_at(const CoordsXY& footpathPos)
 {
     if (map_is_location_at_edge(footpathPos))
         return;
@@ -2033,6 +2061,17 @@ void footpath_update_path_wide_flags(const CoordsXY& footpathPos)
     } while (!(tileElement++)->IsLastForTile());
 }
 
+void footpath_update_path_wide_flags(const CoordsXY& footpathPos)
+{
+    // Wide paths end the pathfinding search, it only needs to know when the flags actually change.
+    auto wideFlags = footpath_get_wide_flags(footpathPos);
+    footpath_update_path_wide_flags_at(footpathPos);
+    if (footpath_get_wide_flags(footpathPos) != wideFlags)
+    {
+        PathfindingGraph::InvalidateTile(footpathPos);
+    }
+}
+
 bool footpath_is_blocked_by_vehicle(const TileCoordsXYZ& position)
 {
     auto pathElement = map_get_path_element_at(position);
@@ -2289,6 +2328,8 @@ static void footpath_fix_corners_around(const TileCoordsXY& footpathPos, TileEle
  */
 void footpath_remove_edges_at(const CoordsXY& footpathPos, TileElement* tileElement)
 {
+    PathfindingGraph::InvalidateTile(footpathPos);
+
     if (tileElement->GetType() == TileElementType::Track)
     {
         auto rideIndex = tileElement->AsTrack()->GetRideIndex();
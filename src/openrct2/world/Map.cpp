@@ -36,6 +36,8 @@
 #include "../network/network.h"
 #include "../object/ObjectManager.h"
 #include "../object/TerrainSurfaceObject.h"
+#include "../peep/PathfindingGraph.h"
+#include "../ride/ProximityIndex.h"
 #include "../ride/RideData.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -149,6 +151,9 @@ void SetTileElements(std::vector<TileElement>&& tileElements)
     _tileElements = std::move(tileElements);
     _tileIndex = TilePointerIndex<TileElement>(MAXIMUM_MAP_SIZE_TECHNICAL, _tileElements.data(), _tileElements.size());
     _tileElementsInUse = _tileElements.size();
+    PathfindingGraph::InvalidateAll();
+    PathfindingGraph::InvalidateRoutes();
+    ProximityIndex::InvalidateAll();
 }
 
 static TileElement GetDefaultSurfaceElement()
@@ -514,6 +519,9 @@ void map_strip_ghost_flag_from_elements()
     {
         element.SetGhost(false);
     }
+    PathfindingGraph::InvalidateAll();
+    PathfindingGraph::InvalidateRoutes();
+    ProximityIndex::InvalidateAll();
 }
 
 /**
@@ -1082,8 +1090,21 @@ bool map_is_location_at_edge(const CoordsXY& loc)
  *
  *  rct2: 0x0068B280
  */
-void tile_element_remove(TileElement* tileElement)
+void tile_element_remove(const CoordsXY& loc, TileElement* tileElement)
 {
+    // Guests only look for paths while provisional construction is stashed away, ghosts coming and going
+    // do not change anything they can see.
+    if (!tileElement->IsGhost())
+    {
+        PathfindingGraph::InvalidateTile(loc);
+        const auto type = tileElement->GetType();
+        if (type == TileElementType::Path || type == TileElementType::Entrance)
+        {
+            PathfindingGraph::InvalidateRoutes();
+        }
+    }
+    ProximityIndex::InvalidateTile(loc);
+
     // Replace Nth element by (N+1)th element.
     // This loop will make tileElement point to the old last element position,
     // after copy it to it's new position
@@ -1132,7 +1153,7 @@ void map_remove_all_rides()
             case TileElementType::Track:
                 footpath_queue_chain_reset();
                 footpath_remove_edges_at(TileCoordsXY{ it.x, it.y }.ToCoordsXY(), it.element);
-                tile_element_remove(it.element);
+                tile_element_remove(TileCoordsXY{ it.x, it.y }.ToCoordsXY(), it.element);
                 tile_element_iterator_restart_for_tile(&it);
                 break;
             default:
@@ -1236,8 +1257,14 @@ static TileElement* AllocateTileElements(size_t numElementsOnTile, size_t numNew
  *
  *  rct2: 0x0068B1F6
  */
-TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants, TileElementType type)
+TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants, TileElementType type, bool isGhost)
 {
+    if (!isGhost)
+    {
+        PathfindingGraph::InvalidateTile(loc);
+    }
+    ProximityIndex::InvalidateTile(loc);
+
     const auto& tileLoc = TileCoordsXYZ(loc);
 
     auto numElementsOnTileOld = CountElementsOnTile(loc);
@@ -1283,6 +1310,7 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
     newTileElement->SetType(type);
     newTileElement->SetBaseZ(loc.z);
     newTileElement->Flags = 0;
+    newTileElement->SetGhost(isGhost);
     newTileElement->SetLastForTile(isLastForTile);
     newTileElement->SetOccupiedQuadrants(occupiedQuadrants);
     newTileElement->SetClearanceZ(loc.z);
@@ -1552,7 +1580,7 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             // If asking nicely did not work, forcibly remove this to avoid an infinite loop.
             if (result.Error != GameActions::Status::Ok)
             {
-                tile_element_remove(element);
+                tile_element_remove(loc, element);
             }
             break;
         }
@@ -1564,7 +1592,7 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             // If asking nicely did not work, forcibly remove this to avoid an infinite loop.
             if (result.Error != GameActions::Status::Ok)
             {
-                tile_element_remove(element);
+                tile_element_remove(loc, element);
             }
         }
         break;
@@ -1576,7 +1604,7 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             // If asking nicely did not work, forcibly remove this to avoid an infinite loop.
             if (result.Error != GameActions::Status::Ok)
             {
-                tile_element_remove(element);
+                tile_element_remove(loc, element);
             }
         }
         break;
@@ -1588,12 +1616,12 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             // If asking nicely did not work, forcibly remove this to avoid an infinite loop.
             if (result.Error != GameActions::Status::Ok)
             {
-                tile_element_remove(element);
+                tile_element_remove(loc, element);
             }
             break;
         }
         default:
-            tile_element_remove(element);
+            tile_element_remove(loc, element);
             break;
     }
 }
@@ -184,16 +184,16 @@ bool map_is_location_owned(const CoordsXYZ& loc);
 bool map_is_location_in_park(const CoordsXY& coords);
 bool map_is_location_owned_or_has_rights(const CoordsXY& loc);
 bool map_surface_is_blocked(const CoordsXY& mapCoords);
-void tile_element_remove(TileElement* tileElement);
+void tile_element_remove(const CoordsXY& loc, TileElement* tileElement);
 void map_remove_all_rides();
 void map_invalidate_map_selection_tiles();
 void map_invalidate_selection_rect();
 bool MapCheckCapacityAndReorganise(const CoordsXY& loc, size_t numElements = 1);
-TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants, TileElementType type);
+TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants, TileElementType type, bool isGhost = false);
 
-template<typename T> T* TileElementInsert(const CoordsXYZ& loc, int32_t occupiedQuadrants)
+template<typename T> T* TileElementInsert(const CoordsXYZ& loc, int32_t occupiedQuadrants, bool isGhost = false)
 {
-    auto* element = tile_element_insert(loc, occupiedQuadrants, T::ElementType);
+    auto* element = tile_element_insert(loc, occupiedQuadrants, T::ElementType, isGhost);
     return (element != nullptr) ? element->template as<T>() : nullptr;
 }
 
@@ -11,7 +11,9 @@
 
 #include "../Context.h"
 #include "../Game.h"
+#include "../LogicPhaseGraph.h"
 #include "../entity/EntityList.h"
+#include "../entity/EntityRegistry.h"
 #include "../entity/Peep.h"
 #include "../interface/Viewport.h"
 #include "../object/StationObject.h"
@@ -26,10 +28,15 @@
 #include "Scenery.h"
 #include "SmallScenery.h"
 
+#include <algorithm>
+
 using map_animation_invalidate_event_handler = bool (*)(const CoordsXYZ& loc);
 
 static std::vector<MapAnimation> _mapAnimations;
 
+// Peeps clocks have told to check the time during this update, they are changed once every animation is done.
+static std::vector<uint16_t> _peepsCheckingTime;
+
 constexpr size_t MAX_ANIMATED_OBJECTS = 2000;
 
 static bool InvalidateMapAnimation(const MapAnimation& obj);
@@ -69,6 +76,7 @@ void map_animation_create(int32_t type, const CoordsXYZ& loc)
  */
 void map_animation_invalidate_all()
 {
+    _peepsCheckingTime.clear();
     auto it = _mapAnimations.begin();
     while (it != _mapAnimations.end())
     {
@@ -82,6 +90,24 @@ void map_animation_invalidate_all()
             it++;
         }
     }
+
+    if (!_peepsCheckingTime.empty())
+    {
+        OpenRCT2::LogicPhaseGraph::Defer([peeps = _peepsCheckingTime]() {
+            for (auto spriteIndex : peeps)
+            {
+                auto* peep = GetEntity<Peep>(spriteIndex);
+                if (peep != nullptr)
+                {
+                    peep->Action = PeepActionType::CheckTime;
+                    peep->ActionFrame = 0;
+                    peep->ActionSpriteImageOffset = 0;
+                    peep->UpdateCurrentActionSpriteType();
+                    peep->Invalidate();
+                }
+            }
+        });
+    }
 }
 
 /**
@@ -200,12 +226,12 @@ static bool map_animation_invalidate_small_scenery(const CoordsXYZ& loc)
                         continue;
                     if (peep->Action < PeepActionType::Idle)
                         continue;
+                    // Already told by another clock.
+                    if (std::find(_peepsCheckingTime.begin(), _peepsCheckingTime.end(), peep->sprite_index)
+                        != _peepsCheckingTime.end())
+                        continue;
 
-                    peep->Action = PeepActionType::CheckTime;
-                    peep->ActionFrame = 0;
-                    peep->ActionSpriteImageOffset = 0;
-                    peep->UpdateCurrentActionSpriteType();
-                    peep->Invalidate();
+                    _peepsCheckingTime.push_back(peep->sprite_index);
                     break;
                 }
             }
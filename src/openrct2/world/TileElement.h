@@ -66,7 +66,7 @@ struct TileElementBase
     uint8_t clearance_height; // 3
     uint8_t owner;            // 4
 
-    void Remove();
+    void Remove(const CoordsXY& loc);
 
     TileElementType GetType() const;
     void SetType(TileElementType newType);
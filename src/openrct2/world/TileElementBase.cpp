@@ -80,9 +80,9 @@ void TileElementBase::SetGhost(bool isGhost)
     }
 }
 
-void TileElementBase::Remove()
+void TileElementBase::Remove(const CoordsXY& loc)
 {
-    tile_element_remove(static_cast<TileElement*>(this));
+    tile_element_remove(loc, static_cast<TileElement*>(this));
 }
 
 uint8_t TileElementBase::GetOccupiedQuadrants() const
@@ -163,7 +163,7 @@ namespace OpenRCT2::TileInspector
                 tileElement->RemoveBannerEntry();
             }
 
-            tile_element_remove(tileElement);
+            tile_element_remove(loc, tileElement);
             map_invalidate_tile_full(loc);
 
             if (auto* inspector = GetTileInspectorWithPos(loc); inspector != nullptr)
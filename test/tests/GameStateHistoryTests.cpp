@@ -0,0 +1,301 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/GameStateHistory.h>
+#include <openrct2/GameStateSnapshots.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/core/DataSerialiser.h>
+#include <openrct2/core/MemoryStream.h>
+#include <openrct2/entity/EntityList.h>
+#include <openrct2/entity/Guest.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/scenario/Scenario.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class GameStateHistoryTests : public testing::Test
+{
+};
+
+static GameStateEntities_t CreateEntities(const std::vector<std::vector<uint8_t>>& entities)
+{
+    GameStateEntities_t res;
+    for (size_t i = 0; i < MAX_ENTITIES; i++)
+    {
+        res.Offsets[i] = static_cast<uint32_t>(res.Data.size());
+        if (i < entities.size())
+        {
+            res.Data.insert(res.Data.end(), entities[i].begin(), entities[i].end());
+        }
+    }
+    res.Offsets[MAX_ENTITIES] = static_cast<uint32_t>(res.Data.size());
+    return res;
+}
+
+// Writes the values one after the other in the byte order of the delta format.
+template<typename... T> static std::vector<uint8_t> CreateDelta(T... values)
+{
+    MemoryStream ms;
+    DataSerialiser ds(true, ms);
+    (ds << ... << values);
+    const auto* data = static_cast<const uint8_t*>(ms.GetData());
+    return std::vector<uint8_t>(data, data + ms.GetLength());
+}
+
+TEST_F(GameStateHistoryTests, DeltaRoundTrip)
+{
+    static constexpr size_t NumEntities = 3000;
+
+    std::mt19937 rng(0x12345678);
+    const auto randomEntity = [&rng]() {
+        std::vector<uint8_t> entity(1 + rng() % 300);
+        for (auto& b : entity)
+            b = static_cast<uint8_t>(rng());
+        return entity;
+    };
+
+    // The last slot makes sure the highest index survives the trip as well.
+    std::vector<std::vector<uint8_t>> values(MAX_ENTITIES);
+    for (size_t i = 0; i < NumEntities; i++)
+    {
+        if (rng() % 3 != 0)
+            values[i] = randomEntity();
+    }
+    values[MAX_ENTITIES - 1] = randomEntity();
+
+    auto from = CreateEntities(values);
+    ASSERT_EQ(CreateEntitiesDelta(from, from).size(), sizeof(uint16_t));
+
+    for (int32_t round = 0; round < 50; round++)
+    {
+        for (int32_t n = 0; n < 200; n++)
+        {
+            auto& entity = values[n == 0 ? MAX_ENTITIES - 1 : rng() % NumEntities];
+            switch (rng() % 4)
+            {
+                case 0:
+                    entity.clear();
+                    break;
+                case 1:
+                    entity = randomEntity();
+                    break;
+                default:
+                    if (!entity.empty())
+                    {
+                        entity.front()++;
+                        entity[rng() % entity.size()]++;
+                        entity.back()++;
+                    }
+                    break;
+            }
+        }
+
+        auto to = CreateEntities(values);
+        auto delta = CreateEntitiesDelta(from, to);
+
+        GameStateEntities_t applied;
+        ASSERT_TRUE(ApplyEntitiesDelta(from, delta, applied));
+        ASSERT_EQ(applied.Offsets, to.Offsets) << "Round " << round;
+        ASSERT_EQ(applied.Data, to.Data) << "Round " << round;
+        from = std::move(to);
+    }
+}
+
+TEST_F(GameStateHistoryTests, MalformedDeltaIsRejected)
+{
+    static constexpr uint16_t End = 0xFFFF;
+    static constexpr uint8_t Removed = 0;
+    static constexpr uint8_t Replaced = 1;
+    static constexpr uint8_t Patched = 2;
+
+    std::vector<std::vector<uint8_t>> values(8);
+    values[3] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    values[5] = { 9, 10 };
+    const auto from = CreateEntities(values);
+
+    GameStateEntities_t to;
+    const auto apply = [&](const std::vector<uint8_t>& delta) { return ApplyEntitiesDelta(from, delta, to); };
+
+    const uint16_t entity = 3;
+    const uint16_t otherEntity = 5;
+    const uint16_t offset = 6;
+    const uint16_t length = 2;
+    const uint16_t tooLong = 4;
+    const uint8_t byte = 0xAA;
+
+    // Patches the last two bytes.
+    ASSERT_TRUE(apply(CreateDelta(entity, Patched, offset, length, byte, byte, End, End)));
+    ASSERT_EQ(to.GetSize(3), 8u);
+    ASSERT_EQ(to.Get(3)[7], byte);
+
+    // Patch runs past the end of the entity.
+    ASSERT_FALSE(apply(CreateDelta(entity, Patched, offset, tooLong, byte, byte, byte, byte, End, End)));
+    // Patch of an entity that does not exist.
+    ASSERT_FALSE(apply(CreateDelta(uint16_t(4), Patched, uint16_t(0), length, byte, byte, End, End)));
+    // Indices that are not ascending.
+    ASSERT_FALSE(apply(CreateDelta(otherEntity, Removed, entity, Removed, End)));
+    // Unknown kind of change.
+    ASSERT_FALSE(apply(CreateDelta(entity, uint8_t(7), End)));
+    // Replacement larger than the data that follows.
+    ASSERT_FALSE(apply(CreateDelta(entity, Replaced, uint32_t(1000), byte, End)));
+    // Missing terminator.
+    ASSERT_FALSE(apply(CreateDelta(entity, Removed)));
+    // Data after the terminator.
+    ASSERT_FALSE(apply(CreateDelta(entity, Removed, End, byte)));
+    ASSERT_FALSE(apply({}));
+}
+
+struct HistoryTick
+{
+    uint32_t Tick;
+    uint32_t Srand0;
+    uint64_t Digest;
+};
+
+// Reads the oldest tick of a history written by IGameStateSnapshots::WriteHistory.
+static HistoryTick ReadFirstHistoryTick(MemoryStream& ms)
+{
+    ms.SetPosition(0);
+    DataSerialiser ds(false, ms);
+    uint32_t numTicks = 0;
+    uint32_t numEntities = 0;
+    ds << numTicks << numEntities;
+    for (uint32_t i = 0; i < numEntities; i++)
+    {
+        uint16_t index = 0;
+        uint32_t size = 0;
+        ds << index << size;
+        ms.SetPosition(ms.GetPosition() + size);
+    }
+    HistoryTick tick{};
+    ds << tick.Tick << tick.Srand0 << tick.Digest;
+    return tick;
+}
+
+TEST_F(GameStateHistoryTests, BisectFindsFirstDivergentTick)
+{
+    static constexpr uint32_t NumTicks = 300;
+    static constexpr uint32_t DivergedAt = 280;
+    static constexpr uint32_t HistoryTicks = 256;
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
+
+    auto context = CreateContext();
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    std::string parkPath = TestData::GetParkPath("bpb.sv6");
+    load_from_sv6(parkPath.c_str());
+
+    auto gs = context->GetGameState();
+    ASSERT_NE(gs, nullptr);
+
+    uint16_t guestIndex = SPRITE_INDEX_NULL;
+    for (auto* guest : EntityList<Guest>())
+    {
+        guestIndex = guest->sprite_index;
+        break;
+    }
+    ASSERT_NE(guestIndex, SPRITE_INDEX_NULL);
+
+    // The client sees a different energy for one guest from a certain tick on.
+    auto server = CreateGameStateSnapshots();
+    auto client = CreateGameStateSnapshots();
+    const uint32_t startTick = gCurrentTicks;
+    for (uint32_t i = 0; i < NumTicks; i++)
+    {
+        gs->UpdateLogic();
+        server->RecordHistory(gCurrentTicks, scenario_rand_state().s0);
+
+        auto* guest = GetEntity<Guest>(guestIndex);
+        ASSERT_NE(guest, nullptr);
+        const auto energy = guest->Energy;
+        if (i >= DivergedAt)
+            guest->Energy = energy ^ 0x55;
+        client->RecordHistory(gCurrentTicks, scenario_rand_state().s0);
+        guest->Energy = energy;
+    }
+
+    MemoryStream serverHistory;
+    {
+        DataSerialiser ds(true, serverHistory);
+        server->WriteHistory(ds);
+    }
+
+    serverHistory.SetPosition(0);
+    DataSerialiser ds(false, serverHistory);
+    auto result = client->BisectHistory(ds);
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->firstTick, startTick + 1 + NumTicks - HistoryTicks);
+    ASSERT_EQ(result->lastTick, startTick + NumTicks);
+    ASSERT_EQ(result->divergedTick, startTick + 1 + DivergedAt);
+
+    bool foundEnergy = false;
+    for (const auto& change : result->compareData.spriteChanges)
+    {
+        if (change.changeType == GameStateSpriteChange_t::EQUAL)
+            continue;
+        ASSERT_EQ(change.spriteIndex, guestIndex);
+        for (const auto& diff : change.diffs)
+        {
+            foundEnergy |= std::string(diff.fieldname) == "Energy";
+        }
+    }
+    ASSERT_TRUE(foundEnergy);
+    ASSERT_NE(client->GetBisectResultText(*result).find("Energy"), std::string::npos);
+
+    // Histories from the other side are checked before they are used.
+    const auto first = ReadFirstHistoryTick(serverHistory);
+    const auto bisect = [&client](const std::vector<uint8_t>& history) {
+        MemoryStream ms(history.data(), history.size());
+        DataSerialiser historyDs(false, ms);
+        return client->BisectHistory(historyDs);
+    };
+    const uint32_t numTicks = 2;
+    const uint32_t numEntities = 0;
+    const uint32_t emptyDelta = 0;
+    const uint32_t patchSize = 9;
+    const uint64_t digest = 0;
+
+    // Agrees on the first tick, differs on the second.
+    auto valid = CreateDelta(
+        numTicks, numEntities, first.Tick, first.Srand0, first.Digest, emptyDelta, first.Tick + 1, first.Srand0, digest,
+        uint32_t(2), uint16_t(0xFFFF));
+    auto validResult = bisect(valid);
+    ASSERT_TRUE(validResult.has_value());
+    ASSERT_EQ(validResult->divergedTick, first.Tick + 1);
+
+    // Ticks that are not contiguous.
+    ASSERT_FALSE(bisect(CreateDelta(
+                            numTicks, numEntities, first.Tick, first.Srand0, first.Digest, emptyDelta, first.Tick + 5,
+                            first.Srand0, digest, emptyDelta))
+                     .has_value());
+    // More ticks than a history holds.
+    ASSERT_FALSE(bisect(CreateDelta(uint32_t(100000), numEntities)).has_value());
+    // A patch of an entity the other side does not have.
+    ASSERT_FALSE(bisect(CreateDelta(
+                            numTicks, numEntities, first.Tick, first.Srand0, first.Digest, emptyDelta, first.Tick + 1,
+                            first.Srand0, digest, patchSize, uint16_t(0), uint8_t(2), uint16_t(0), uint16_t(1), uint8_t(1),
+                            uint16_t(0xFFFF), uint16_t(0xFFFF)))
+                     .has_value());
+    // Truncated.
+    valid.resize(valid.size() - 3);
+    ASSERT_FALSE(bisect(valid).has_value());
+}
@@ -0,0 +1,86 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <atomic>
+#include <functional>
+#include <gtest/gtest.h>
+#include <openrct2/core/JobPool.h>
+#include <vector>
+
+TEST(JobPoolTest, add_task_join)
+{
+    JobPool pool;
+    std::atomic<int32_t> sum = 0;
+    for (int32_t i = 0; i < 1000; i++)
+    {
+        pool.AddTask([&sum, i]() { sum += i; });
+    }
+    pool.Join();
+    ASSERT_EQ(sum, 499500);
+    ASSERT_EQ(pool.CountPending(), 0u);
+}
+
+TEST(JobPoolTest, completion_runs_on_join)
+{
+    JobPool pool;
+    std::atomic<int32_t> work = 0;
+    int32_t completions = 0;
+    for (int32_t i = 0; i < 10; i++)
+    {
+        pool.AddTask(std::function<void()>([&work]() { work++; }), [&completions]() { completions++; });
+    }
+    pool.Join();
+    ASSERT_EQ(work, 10);
+    ASSERT_EQ(completions, 10);
+}
+
+TEST(JobPoolTest, parallel_for_covers_range)
+{
+    JobPool pool;
+    std::vector<int32_t> hits(1000);
+    pool.ParallelFor(hits.size(), 7, [&hits](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            hits[i]++;
+        }
+    });
+    for (auto hit : hits)
+    {
+        ASSERT_EQ(hit, 1);
+    }
+}
+
+TEST(JobPoolTest, nested_task_groups)
+{
+    JobPool pool;
+    std::atomic<size_t> count = 0;
+    JobPool::TaskGroup group(pool);
+    for (int32_t i = 0; i < 50; i++)
+    {
+        group.Run([&pool, &count]() {
+            pool.ParallelFor(100, 3, [&count](size_t begin, size_t end) { count += end - begin; });
+        });
+    }
+    group.Wait();
+    ASSERT_EQ(count, 5000u);
+}
+
+TEST(JobPoolTest, pinned_worker_count)
+{
+    JobPool::SetWorkerCountOverride(3);
+    {
+        JobPool pool;
+        ASSERT_EQ(pool.CountWorkers(), 3u);
+    }
+    JobPool::SetWorkerCountOverride(0);
+    {
+        JobPool pool(1);
+        ASSERT_EQ(pool.CountWorkers(), 1u);
+    }
+}
@@ -0,0 +1,197 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/LogicPhaseGraph.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkImporter.h>
+#include <openrct2/config/Config.h>
+#include <openrct2/core/JobPool.h>
+#include <openrct2/entity/EntityList.h>
+#include <openrct2/entity/EntityRegistry.h>
+#include <openrct2/entity/EntityTweener.h>
+#include <openrct2/entity/Guest.h>
+#include <openrct2/object/ObjectManager.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/ride/Ride.h>
+#include <openrct2/world/MapAnimation.h>
+#include <openrct2/world/Scenery.h>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class LogicPhaseTests : public testing::Test
+{
+};
+
+static constexpr int32_t TickCount = 2000;
+
+static std::unique_ptr<IContext> localStartGame(const std::string& parkPath)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
+
+    auto context = CreateContext();
+    if (!context->Initialise())
+        return {};
+
+    auto importer = ParkImporter::CreateS6(context->GetObjectRepository());
+    auto loadResult = importer->LoadSavedGame(parkPath.c_str(), false);
+    context->GetObjectManager().LoadObjects(loadResult.RequiredObjects);
+    importer->Import();
+
+    ResetEntitySpatialIndices();
+
+    reset_all_sprite_quadrant_placements();
+    scenery_set_default_placement_configuration();
+    load_palette();
+    EntityTweener::Get().Reset();
+    AutoCreateMapAnimations();
+    fix_invalid_vehicle_sprite_sizes();
+
+    gGameSpeed = 1;
+
+    return context;
+}
+
+struct TickState
+{
+    EntitiesChecksum Entities;
+    std::vector<uint16_t> Excitement;
+};
+
+static std::vector<TickState> RunTicks(const std::string& parkPath, bool multithreading)
+{
+    gConfigGeneral.multithreading = multithreading;
+
+    std::vector<TickState> states;
+    auto context = localStartGame(parkPath);
+    if (context == nullptr)
+        return states;
+
+    auto gs = context->GetGameState();
+    for (int32_t i = 0; i < TickCount; i++)
+    {
+        gs->UpdateLogic();
+
+        auto& state = states.emplace_back();
+        state.Entities = GetAllEntitiesChecksum();
+        for (const auto& ride : GetRideManager())
+        {
+            state.Excitement.push_back(static_cast<uint16_t>(ride.excitement));
+        }
+    }
+    gConfigGeneral.multithreading = false;
+    return states;
+}
+
+static std::string RunPhases(const std::string& parkPath, const LogicPhaseGraph& graph, bool parallel)
+{
+    auto context = localStartGame(parkPath);
+    if (context == nullptr || GetEntityListCount(EntityType::Guest) == 0)
+        return {};
+
+    if (parallel)
+    {
+        JobPool jobPool;
+        graph.RunParallel(jobPool, [](LogicTimePart) {});
+    }
+    else
+    {
+        graph.RunSerial([](LogicTimePart) {});
+    }
+    return GetAllEntitiesChecksum().ToString();
+}
+
+static void TireGuests()
+{
+    for (auto* guest : EntityList<Guest>())
+    {
+        guest->Energy++;
+    }
+}
+
+// Gives a different result depending on whether the guests were tired first.
+static void CheerUpGuests()
+{
+    for (auto* guest : EntityList<Guest>())
+    {
+        guest->Happiness ^= guest->Energy;
+    }
+}
+
+TEST_F(LogicPhaseTests, ConflictingPhasesKeepTheirOrder)
+{
+    const auto entities = EnumToFlag(LogicResource::Entities);
+
+    LogicPhaseGraph graph;
+    graph.Add({ LogicTimePart::Date, 0, entities, 0, true, TireGuests });
+    graph.Add({ LogicTimePart::RideRatings, 0, EnumToFlag(LogicResource::RideRatings), 0, true, []() {} });
+    graph.Add({ LogicTimePart::RideMeasurments, entities, entities, 0, true, CheerUpGuests });
+    graph.Build();
+
+    const auto& waves = graph.GetWaves();
+    ASSERT_EQ(waves.size(), 2u);
+    ASSERT_EQ(waves[0], std::vector<size_t>({ 0, 1 }));
+    ASSERT_EQ(waves[1], std::vector<size_t>({ 2 }));
+
+    std::string parkPath = TestData::GetParkPath("bpb.sv6");
+    auto serial = RunPhases(parkPath, graph, false);
+    auto parallel = RunPhases(parkPath, graph, true);
+    ASSERT_FALSE(serial.empty());
+    ASSERT_EQ(serial, parallel);
+}
+
+TEST_F(LogicPhaseTests, DeferredEffectsRunInPhaseOrder)
+{
+    const auto entities = EnumToFlag(LogicResource::Entities);
+
+    LogicPhase deferring{ LogicTimePart::Date, 0, 0, entities, true, []() { LogicPhaseGraph::Defer(TireGuests); } };
+    LogicPhase threadSafeReader{ LogicTimePart::RideMeasurments, entities, 0, 0, true, []() {} };
+    // The reader would run before the effect.
+    ASSERT_TRUE(LogicPhaseGraph::Conflicts(deferring, threadSafeReader));
+
+    LogicPhaseGraph graph;
+    graph.Add(deferring);
+    graph.Add({ LogicTimePart::News, entities, entities, 0, false, CheerUpGuests });
+    graph.Build();
+
+    const auto& waves = graph.GetWaves();
+    ASSERT_EQ(waves.size(), 1u);
+    ASSERT_EQ(waves[0], std::vector<size_t>({ 0, 1 }));
+
+    std::string parkPath = TestData::GetParkPath("bpb.sv6");
+    auto serial = RunPhases(parkPath, graph, false);
+    auto parallel = RunPhases(parkPath, graph, true);
+    ASSERT_FALSE(serial.empty());
+    ASSERT_EQ(serial, parallel);
+}
+
+TEST_F(LogicPhaseTests, ParallelUpdateMatchesSerial)
+{
+    std::string parkPath = TestData::GetParkPath("bpb.sv6");
+
+    auto serial = RunTicks(parkPath, false);
+    auto parallel = RunTicks(parkPath, true);
+    ASSERT_EQ(serial.size(), static_cast<size_t>(TickCount));
+    ASSERT_EQ(parallel.size(), serial.size());
+
+    for (size_t i = 0; i < serial.size(); i++)
+    {
+        ASSERT_EQ(serial[i].Entities.ToString(), parallel[i].Entities.ToString()) << "Entities diverged at tick " << i;
+        ASSERT_EQ(serial[i].Excitement, parallel[i].Excitement) << "Ride ratings diverged at tick " << i;
+    }
+}
@@ -0,0 +1,122 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <openrct2/core/MemoryStream.h>
+#include <openrct2/core/OrcaStream.hpp>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+constexpr uint32_t TEST_CHUNK_ID = 0x01;
+constexpr size_t HEADER_SIZE = 64;
+constexpr size_t CHUNK_ENTRY_SIZE = 20;
+constexpr size_t BLOCK_ENTRY_SIZE = 16;
+
+static std::vector<uint8_t> CreateTestData()
+{
+    // Spans three blocks, the last one only partly filled.
+    std::vector<uint8_t> data(OrcaStream::DEFAULT_BLOCK_SIZE * 2 + 1234);
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<uint8_t>((i * 7) ^ (i >> 9));
+    }
+    return data;
+}
+
+static std::vector<uint8_t> WriteBlockStream(std::vector<uint8_t>& data)
+{
+    MemoryStream ms;
+    {
+        OrcaStream os(ms, OrcaStream::Mode::WRITING);
+        os.GetHeader().Compression = OrcaStream::COMPRESSION_GZIP_BLOCKS;
+        os.ReadWriteChunk(TEST_CHUNK_ID, [&data](OrcaStream::ChunkStream& cs) { cs.ReadWrite(data.data(), data.size()); });
+    }
+    const auto* bytes = static_cast<const uint8_t*>(ms.GetData());
+    return std::vector<uint8_t>(bytes, bytes + ms.GetLength());
+}
+
+static std::vector<uint8_t> ReadBlockStream(std::vector<uint8_t>& file, size_t length, bool onDemand)
+{
+    MemoryStream ms(file.data(), file.size(), MEMORY_ACCESS::READ);
+    OrcaStream os(ms, OrcaStream::Mode::READING, onDemand);
+    std::vector<uint8_t> result(length);
+    os.ReadWriteChunk(TEST_CHUNK_ID, [&result](OrcaStream::ChunkStream& cs) { cs.ReadWrite(result.data(), result.size()); });
+    return result;
+}
+
+// Returns the message of the IOException reading the stream throws.
+static std::string GetReadError(std::vector<uint8_t>& file, size_t length, bool onDemand)
+{
+    try
+    {
+        ReadBlockStream(file, length, onDemand);
+    }
+    catch (const IOException& e)
+    {
+        return e.what();
+    }
+    return {};
+}
+
+static void SetBlockEntry(std::vector<uint8_t>& file, size_t index, uint64_t offset, uint32_t compressedLength)
+{
+    auto* entry = file.data() + HEADER_SIZE + CHUNK_ENTRY_SIZE + index * BLOCK_ENTRY_SIZE;
+    std::memcpy(entry, &offset, sizeof(offset));
+    std::memcpy(entry + sizeof(offset), &compressedLength, sizeof(compressedLength));
+}
+
+static void GetBlockEntry(const std::vector<uint8_t>& file, size_t index, uint64_t& offset, uint32_t& compressedLength)
+{
+    const auto* entry = file.data() + HEADER_SIZE + CHUNK_ENTRY_SIZE + index * BLOCK_ENTRY_SIZE;
+    std::memcpy(&offset, entry, sizeof(offset));
+    std::memcpy(&compressedLength, entry + sizeof(offset), sizeof(compressedLength));
+}
+
+TEST(OrcaStreamTest, gzip_blocks_round_trip)
+{
+    auto data = CreateTestData();
+    auto file = WriteBlockStream(data);
+    ASSERT_EQ(ReadBlockStream(file, data.size(), false), data);
+    ASSERT_EQ(ReadBlockStream(file, data.size(), true), data);
+}
+
+TEST(OrcaStreamTest, block_offset_wrapping_around_is_rejected)
+{
+    auto data = CreateTestData();
+    auto file = WriteBlockStream(data);
+
+    // The offset plus the length wraps around to a small number, which is within the compressed data.
+    uint64_t offset{};
+    uint32_t compressedLength{};
+    GetBlockEntry(file, 1, offset, compressedLength);
+    SetBlockEntry(file, 1, std::numeric_limits<uint64_t>::max() - compressedLength + 2, compressedLength);
+
+    // The table itself must be rejected, before any data outside the file is inflated.
+    EXPECT_EQ(GetReadError(file, data.size(), false), "Invalid block table.");
+    EXPECT_EQ(GetReadError(file, data.size(), true), "Invalid block table.");
+}
+
+TEST(OrcaStreamTest, block_past_end_of_data_is_rejected)
+{
+    auto data = CreateTestData();
+    auto file = WriteBlockStream(data);
+
+    uint64_t offset{};
+    uint32_t compressedLength{};
+    GetBlockEntry(file, 2, offset, compressedLength);
+    SetBlockEntry(file, 2, offset, compressedLength + 1);
+
+    EXPECT_EQ(GetReadError(file, data.size(), false), "Invalid block table.");
+    EXPECT_EQ(GetReadError(file, data.size(), true), "Invalid block table.");
+}
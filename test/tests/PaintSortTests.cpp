@@ -0,0 +1,145 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <limits>
+#include <openrct2/paint/Paint.h>
+#include <random>
+#include <vector>
+
+struct SortedSession
+{
+    std::vector<size_t> Order;
+    std::vector<uint8_t> SortFlags;
+};
+
+// Same as the quadrant a paint struct is added to while painting.
+static uint32_t GetQuadrantIndex(const paint_struct& ps, uint8_t rotation)
+{
+    constexpr auto MapRangeMax = MaxPaintQuadrants * COORDS_XY_STEP;
+    constexpr auto MapRangeCenter = MapRangeMax / 2;
+
+    int32_t positionHash = 0;
+    switch (rotation)
+    {
+        case 0:
+            positionHash = ps.bounds.x + ps.bounds.y;
+            break;
+        case 1:
+            positionHash = ps.bounds.y - ps.bounds.x + MapRangeCenter;
+            break;
+        case 2:
+            positionHash = MapRangeMax - (ps.bounds.x + ps.bounds.y);
+            break;
+        case 3:
+            positionHash = ps.bounds.x - ps.bounds.y + MapRangeCenter;
+            break;
+    }
+    return std::clamp(positionHash / COORDS_XY_STEP, 0, MaxPaintQuadrants - 1);
+}
+
+// Mirrors the tile positions of rotation 0 so that the rows of tiles are the quadrants of the given rotation as well.
+static CoordsXY RotateTile(const CoordsXY& tile, uint8_t rotation)
+{
+    constexpr int32_t MirrorAt = 160 * COORDS_XY_STEP;
+    switch (rotation)
+    {
+        case 1:
+            return { MirrorAt - tile.x, tile.y };
+        case 2:
+            return { MirrorAt - tile.x, MirrorAt - tile.y };
+        case 3:
+            return { tile.x, MirrorAt - tile.y };
+    }
+    return tile;
+}
+
+/**
+ * Fills a session with a couple of tiles per quadrant, each holding many overlapping paint structs, so that every
+ * quadrant is well above the density at which the compact sort is picked. A fixed seed gives the same session every
+ * time.
+ */
+static void CreateDenseSession(PaintSessionCore& session, std::vector<paint_entry>& entries, uint8_t rotation)
+{
+    constexpr int32_t numRows = 24;
+    constexpr int32_t tilesPerRow = 2;
+    constexpr int32_t structsPerTile = 48;
+    constexpr int32_t firstTile = 64;
+
+    std::mt19937 prng(1234);
+    session = {};
+    std::fill(std::begin(session.Quadrants), std::end(session.Quadrants), nullptr);
+    session.QuadrantBackIndex = std::numeric_limits<uint32_t>::max();
+    session.QuadrantFrontIndex = 0;
+    session.CurrentRotation = rotation;
+
+    entries.assign(numRows * tilesPerRow * structsPerTile, {});
+    size_t entryIndex = 0;
+    for (int32_t row = 0; row < numRows; row++)
+    {
+        for (int32_t tile = 0; tile < tilesPerRow; tile++)
+        {
+            const auto tilePos = RotateTile(
+                { (firstTile + row / 2 + tile) * COORDS_XY_STEP, (firstTile + row - row / 2 - tile) * COORDS_XY_STEP },
+                rotation);
+            const auto baseZ = static_cast<int32_t>(prng() % 16) * COORDS_Z_STEP * 2;
+            for (int32_t i = 0; i < structsPerTile; i++)
+            {
+                auto& ps = entries[entryIndex++].basic;
+                ps.bounds.x = tilePos.x + static_cast<int32_t>(prng() % COORDS_XY_STEP);
+                ps.bounds.y = tilePos.y + static_cast<int32_t>(prng() % COORDS_XY_STEP);
+                ps.bounds.z = baseZ + static_cast<int32_t>(prng() % 8) * COORDS_Z_STEP;
+                ps.bounds.x_end = ps.bounds.x + static_cast<int32_t>(prng() % COORDS_XY_STEP);
+                ps.bounds.y_end = ps.bounds.y + static_cast<int32_t>(prng() % COORDS_XY_STEP);
+                ps.bounds.z_end = ps.bounds.z + static_cast<int32_t>(prng() % 64);
+
+                const auto quadrantIndex = GetQuadrantIndex(ps, rotation);
+                ps.quadrant_index = static_cast<uint16_t>(quadrantIndex);
+                ps.next_quadrant_ps = session.Quadrants[quadrantIndex];
+                session.Quadrants[quadrantIndex] = &ps;
+                session.QuadrantBackIndex = std::min(session.QuadrantBackIndex, quadrantIndex);
+                session.QuadrantFrontIndex = std::max(session.QuadrantFrontIndex, quadrantIndex);
+            }
+        }
+    }
+}
+
+static SortedSession ArrangeDenseSession(uint8_t rotation, PaintSortMethod method)
+{
+    PaintSessionCore session;
+    std::vector<paint_entry> entries;
+    CreateDenseSession(session, entries, rotation);
+    PaintSessionArrange(&session, method);
+
+    SortedSession result;
+    for (auto* ps = session.PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+    {
+        result.Order.push_back(reinterpret_cast<const paint_entry*>(ps) - entries.data());
+    }
+    for (const auto& entry : entries)
+    {
+        result.SortFlags.push_back(entry.basic.SortFlags);
+    }
+    return result;
+}
+
+TEST(PaintSortTest, compact_sort_matches_linked_sort)
+{
+    for (uint8_t rotation = 0; rotation < 4; rotation++)
+    {
+        const auto linked = ArrangeDenseSession(rotation, PaintSortMethod::Linked);
+        const auto compact = ArrangeDenseSession(rotation, PaintSortMethod::Compact);
+        ASSERT_EQ(linked.Order.size(), linked.SortFlags.size()) << "Rotation " << int32_t{ rotation };
+        EXPECT_EQ(linked.Order, compact.Order) << "Rotation " << int32_t{ rotation };
+        EXPECT_EQ(linked.SortFlags, compact.SortFlags) << "Rotation " << int32_t{ rotation };
+    }
+}
@@ -6,13 +6,22 @@
 #include "openrct2/scenario/Scenario.h"
 
 #include <gtest/gtest.h>
+#include <openrct2/Cheats.h>
 #include <openrct2/Context.h>
 #include <openrct2/Game.h>
 #include <openrct2/OpenRCT2.h>
 #include <openrct2/ParkImporter.h>
+#include <openrct2/actions/FootpathPlaceAction.h>
+#include <openrct2/actions/FootpathRemoveAction.h>
+#include <openrct2/actions/ParkSetNameAction.h>
+#include <openrct2/peep/PathfindingGraph.h>
 #include <openrct2/platform/platform.h>
 #include <openrct2/world/Footpath.h>
 #include <openrct2/world/Map.h>
+#include <openrct2/world/Park.h>
+#include <openrct2/world/Surface.h>
+#include <openrct2/world/TileElementsView.h>
+#include <optional>
 
 using namespace OpenRCT2;
 
@@ -64,7 +73,8 @@ protected:
         return nullptr;
     }
 
-    static bool FindPath(TileCoordsXYZ* pos, const TileCoordsXYZ& goal, int expectedSteps, ride_id_t targetRideID)
+    static bool FindPath(
+        TileCoordsXYZ* pos, const TileCoordsXYZ& goal, int expectedSteps, ride_id_t targetRideID, bool exactSteps = true)
     {
         // Our start position is in tile coordinates, but we need to give the peep spawn
         // position in actual world coords (32 units per tile X/Y, 8 per Z level).
@@ -125,8 +135,11 @@ protected:
         // deterministic, and we reset the RNG seed for each test, everything should be entirely repeatable; as
         // such a change in the number of steps taken on one of these paths needs to be reviewed. For the negative
         // tests, we will not have reached the goal but we still expect the loop to have run for the total number
-        // of steps requested before giving up.
-        EXPECT_EQ(step, expectedSteps);
+        // of steps requested before giving up. Shared routes are shortest routes, they may take fewer steps.
+        if (exactSteps)
+            EXPECT_EQ(step, expectedSteps);
+        else
+            EXPECT_LE(step, expectedSteps);
 
         return *pos == goal;
     }
@@ -211,6 +224,27 @@ TEST_P(SimplePathfindingTest, CanFindPathFromStartToGoal)
     EXPECT_TRUE(succeeded);
 }
 
+TEST_P(SimplePathfindingTest, CanFindSharedRouteFromStartToGoal)
+{
+    const SimplePathfindingScenario& scenario = GetParam();
+    TileCoordsXYZ pos = scenario.start;
+
+    auto ride = FindRideByName(scenario.name);
+    ASSERT_NE(ride, nullptr);
+
+    auto entrancePos = ride_get_entrance_location(ride, 0);
+    TileCoordsXYZ goal = TileCoordsXYZ(
+        entrancePos.x - TileDirectionDelta[entrancePos.direction].x,
+        entrancePos.y - TileDirectionDelta[entrancePos.direction].y, entrancePos.z);
+
+    gParkFlags |= PARK_FLAGS_SHARED_GUEST_ROUTES;
+    const bool succeeded = FindPath(&pos, goal, scenario.steps, ride->id, false);
+    gParkFlags &= ~PARK_FLAGS_SHARED_GUEST_ROUTES;
+
+    EXPECT_TRUE(succeeded) << "Failed to find shared route from " << scenario.start << " to " << goal << "; reached " << pos
+                           << " before giving up.";
+}
+
 INSTANTIATE_TEST_CASE_P(
     ForScenario, SimplePathfindingTest,
     ::testing::Values(
@@ -244,6 +278,24 @@ TEST_P(ImpossiblePathfindingTest, CannotFindPathFromStartToGoal)
     EXPECT_FALSE(FindPath(&pos, goal, 10000, ride->id));
 }
 
+TEST_P(ImpossiblePathfindingTest, CannotFindSharedRouteFromStartToGoal)
+{
+    const SimplePathfindingScenario& scenario = GetParam();
+    TileCoordsXYZ pos = scenario.start;
+
+    auto ride = FindRideByName(scenario.name);
+    ASSERT_NE(ride, nullptr);
+
+    auto entrancePos = ride_get_entrance_location(ride, 0);
+    TileCoordsXYZ goal = TileCoordsXYZ(
+        entrancePos.x + TileDirectionDelta[entrancePos.direction].x,
+        entrancePos.y + TileDirectionDelta[entrancePos.direction].y, entrancePos.z);
+
+    gParkFlags |= PARK_FLAGS_SHARED_GUEST_ROUTES;
+    EXPECT_FALSE(FindPath(&pos, goal, 10000, ride->id));
+    gParkFlags &= ~PARK_FLAGS_SHARED_GUEST_ROUTES;
+}
+
 INSTANTIATE_TEST_CASE_P(
     ForScenario, ImpossiblePathfindingTest,
     ::testing::Values(
@@ -251,3 +303,118 @@ INSTANTIATE_TEST_CASE_P(
         SimplePathfindingScenario("PathWithFences", { 11, 6, 14 }, 10000),
         SimplePathfindingScenario("PathWithCliff", { 7, 17, 14 }, 10000)),
     SimplePathfindingScenario::ToName);
+
+TEST_F(PathfindingTestBase, ProvisionalPathKeepsSharedRoutes)
+{
+    // Build with whatever path the park already uses, on the first bare flat tile.
+    const PathElement* existingPath = nullptr;
+    std::optional<CoordsXYZ> loc;
+    for (int32_t y = 1; y < gMapSize - 1; y++)
+    {
+        for (int32_t x = 1; x < gMapSize - 1; x++)
+        {
+            const auto tileCoords = TileCoordsXY{ x, y }.ToCoordsXY();
+            for (auto* pathElement : TileElementsView<PathElement>(tileCoords))
+            {
+                if (existingPath == nullptr)
+                    existingPath = pathElement;
+            }
+
+            auto* tileElement = map_get_first_element_at(tileCoords);
+            auto* surfaceElement = tileElement != nullptr ? tileElement->AsSurface() : nullptr;
+            if (!loc.has_value() && surfaceElement != nullptr && tileElement->IsLastForTile()
+                && surfaceElement->GetSlope() == TILE_ELEMENT_SLOPE_FLAT && surfaceElement->GetWaterHeight() == 0)
+            {
+                loc = CoordsXYZ{ tileCoords, surfaceElement->GetBaseZ() };
+            }
+        }
+    }
+    ASSERT_NE(existingPath, nullptr);
+    ASSERT_TRUE(loc.has_value());
+
+    ObjectEntryIndex type = existingPath->GetSurfaceEntryIndex();
+    PathConstructFlags constructFlags = 0;
+    if (existingPath->HasLegacyPathEntry())
+    {
+        type = existingPath->GetLegacyPathEntryIndex();
+        constructFlags |= PathConstructFlag::IsLegacyPathObject;
+    }
+    const auto railingsType = existingPath->GetRailingsEntryIndex();
+
+    const auto sandboxMode = gCheatsSandboxMode;
+    const auto parkFlags = gParkFlags;
+    gCheatsSandboxMode = true;
+    gParkFlags |= PARK_FLAGS_NO_MONEY;
+
+    // Guests never route while ghosts are on the map, placing and removing one keeps the routes.
+    const auto routeVersion = PathfindingGraph::GetRouteVersion();
+    auto ghostPlaceAction = FootpathPlaceAction(*loc, 0, type, railingsType, INVALID_DIRECTION, constructFlags);
+    ghostPlaceAction.SetFlags(GAME_COMMAND_FLAG_GHOST | GAME_COMMAND_FLAG_ALLOW_DURING_PAUSED);
+    EXPECT_EQ(GameActions::Execute(&ghostPlaceAction).Error, GameActions::Status::Ok);
+    auto ghostRemoveAction = FootpathRemoveAction(*loc);
+    ghostRemoveAction.SetFlags(GAME_COMMAND_FLAG_GHOST | GAME_COMMAND_FLAG_ALLOW_DURING_PAUSED);
+    EXPECT_EQ(GameActions::Execute(&ghostRemoveAction).Error, GameActions::Status::Ok);
+    EXPECT_EQ(PathfindingGraph::GetRouteVersion(), routeVersion);
+
+    auto placeAction = FootpathPlaceAction(*loc, 0, type, railingsType, INVALID_DIRECTION, constructFlags);
+    EXPECT_EQ(GameActions::Execute(&placeAction).Error, GameActions::Status::Ok);
+    EXPECT_NE(PathfindingGraph::GetRouteVersion(), routeVersion);
+    auto removeAction = FootpathRemoveAction(*loc);
+    EXPECT_EQ(GameActions::Execute(&removeAction).Error, GameActions::Status::Ok);
+
+    gCheatsSandboxMode = sandboxMode;
+    gParkFlags = parkFlags;
+}
+
+TEST_F(PathfindingTestBase, UnrelatedActionsKeepSharedRoutes)
+{
+    const auto routeVersion = PathfindingGraph::GetRouteVersion();
+    auto renameAction = ParkSetNameAction("Shared Routes Park");
+    renameAction.SetFlags(GAME_COMMAND_FLAG_ALLOW_DURING_PAUSED);
+    EXPECT_EQ(GameActions::Execute(&renameAction).Error, GameActions::Status::Ok);
+    EXPECT_EQ(PathfindingGraph::GetRouteVersion(), routeVersion);
+}
+
+TEST_F(PathfindingTestBase, GraphOnlyForgetsChangedTiles)
+{
+    std::optional<TileCoordsXYZ> pathLoc;
+    for (int32_t y = 1; y < gMapSize - 4 && !pathLoc.has_value(); y++)
+    {
+        for (int32_t x = 1; x < gMapSize - 4 && !pathLoc.has_value(); x++)
+        {
+            for (auto* pathElement : TileElementsView<PathElement>(TileCoordsXY{ x, y }.ToCoordsXY()))
+            {
+                pathLoc = TileCoordsXYZ{ x, y, pathElement->base_height };
+                break;
+            }
+        }
+    }
+    ASSERT_TRUE(pathLoc.has_value());
+
+    // Inserting elements can move every tile, the path is looked up again each time.
+    const auto getNode = [&pathLoc]() {
+        auto* pathElement = map_get_path_element_at(*pathLoc);
+        return PathfindingGraph::GetNode(*pathLoc, reinterpret_cast<TileElement*>(pathElement));
+    };
+    auto* node = getNode();
+    ASSERT_NE(node, nullptr);
+    node->IsThinJunction = 1;
+
+    const auto changeTile = [](const CoordsXYZ& loc, bool isGhost) {
+        auto* element = tile_element_insert(loc, 0b0000, TileElementType::SmallScenery, isGhost);
+        ASSERT_NE(element, nullptr);
+        tile_element_remove(loc, element);
+    };
+
+    // A tile that is not next to the path.
+    const auto pathZ = pathLoc->ToCoordsXYZ().z;
+    changeTile({ TileCoordsXY{ pathLoc->x + 3, pathLoc->y }.ToCoordsXY(), pathZ }, false);
+    EXPECT_EQ(getNode()->IsThinJunction, 1);
+
+    // Ghosts on the tile of the path itself.
+    changeTile({ TileCoordsXY{ pathLoc->x, pathLoc->y }.ToCoordsXY(), pathZ + 64 }, true);
+    EXPECT_EQ(getNode()->IsThinJunction, 1);
+
+    changeTile({ TileCoordsXY{ pathLoc->x, pathLoc->y }.ToCoordsXY(), pathZ + 64 }, false);
+    EXPECT_EQ(getNode()->IsThinJunction, PathfindingGraph::Unknown);
+}
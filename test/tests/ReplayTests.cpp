@@ -16,8 +16,10 @@
 #include <openrct2/OpenRCT2.h>
 #include <openrct2/ReplayManager.h>
 #include <openrct2/audio/AudioContext.h>
+#include <openrct2/config/Config.h>
 #include <openrct2/core/File.h>
 #include <openrct2/core/FileScanner.h>
+#include <openrct2/core/FileSystem.hpp>
 #include <openrct2/core/Path.hpp>
 #include <openrct2/core/String.hpp>
 #include <openrct2/platform/platform.h>
@@ -69,14 +71,45 @@ class ReplayTests : public testing::TestWithParam<ReplayTestData>
 protected:
 };
 
-TEST_P(ReplayTests, RunReplay)
+static void RunReplay(const std::string& replayFile, bool multithreading)
 {
     gOpenRCT2Headless = true;
     gOpenRCT2NoGraphics = true;
     core_init();
 
-    auto testData = GetParam();
-    auto replayFile = testData.filePath;
+    gConfigGeneral.multithreading = multithreading;
+
+    auto context = CreateContext();
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    auto gs = context->GetGameState();
+    ASSERT_NE(gs, nullptr);
+
+    IReplayManager* replayManager = context->GetReplayManager();
+    ASSERT_NE(replayManager, nullptr);
+
+    bool startedReplay = replayManager->StartPlayback(replayFile);
+    ASSERT_TRUE(startedReplay);
+
+    while (replayManager->IsReplaying())
+    {
+        gs->UpdateLogic();
+        if (replayManager->IsPlaybackStateMismatching())
+            break;
+    }
+    gConfigGeneral.multithreading = false;
+
+    ASSERT_FALSE(replayManager->IsReplaying());
+    ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+}
+
+// Seeks forward from the start, then back over the replayed commands, before playing the rest of the replay.
+static void SeekReplay(const std::string& replayFile)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
 
     auto context = CreateContext();
     bool initialised = context->Initialise();
@@ -91,16 +124,99 @@ TEST_P(ReplayTests, RunReplay)
     bool startedReplay = replayManager->StartPlayback(replayFile);
     ASSERT_TRUE(startedReplay);
 
+    ReplayRecordInfo info;
+    ASSERT_TRUE(replayManager->GetCurrentReplayInfo(info));
+
+    ASSERT_TRUE(replayManager->SeekPlayback(info.Ticks / 2));
+    ASSERT_TRUE(replayManager->SeekPlayback(info.Ticks / 4));
+    ASSERT_TRUE(replayManager->IsReplaying());
+
     while (replayManager->IsReplaying())
     {
         gs->UpdateLogic();
         if (replayManager->IsPlaybackStateMismatching())
             break;
     }
+
     ASSERT_FALSE(replayManager->IsReplaying());
     ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
 }
 
+TEST_P(ReplayTests, RunReplay)
+{
+    RunReplay(GetParam().filePath, false);
+}
+
+TEST_P(ReplayTests, SeekReplay)
+{
+    SeekReplay(GetParam().filePath);
+}
+
+// Replays were recorded by single threaded updates, the parallel logic phases have to reproduce them.
+TEST_P(ReplayTests, RunReplayMultithreaded)
+{
+    RunReplay(GetParam().filePath, true);
+}
+
+// Records a short replay with a keyframe every few ticks, then seeks forward and back across those keyframes.
+TEST(ReplayKeyframeTests, SeekAcrossKeyframes)
+{
+    static constexpr uint32_t KeyframeTicks = 100;
+    static constexpr uint32_t RecordTicks = 500;
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
+
+    auto context = CreateContext();
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    std::string parkPath = TestData::GetParkPath("bpb.sv6");
+    load_from_sv6(parkPath.c_str());
+
+    auto gs = context->GetGameState();
+    ASSERT_NE(gs, nullptr);
+
+    IReplayManager* replayManager = context->GetReplayManager();
+    ASSERT_NE(replayManager, nullptr);
+
+    const std::string replayFile = (fs::temp_directory_path() / "test_replay_keyframes.parkrep").u8string();
+    replayManager->SetKeyframeInterval(KeyframeTicks);
+    ASSERT_TRUE(replayManager->StartRecording(replayFile, RecordTicks));
+    while (replayManager->IsRecording())
+    {
+        gs->UpdateLogic();
+    }
+
+    bool startedReplay = replayManager->StartPlayback(replayFile);
+    ASSERT_TRUE(startedReplay);
+
+    ReplayRecordInfo info;
+    ASSERT_TRUE(replayManager->GetCurrentReplayInfo(info));
+    ASSERT_EQ(info.Ticks, RecordTicks);
+    ASSERT_GE(info.NumKeyframes, RecordTicks / KeyframeTicks - 1);
+
+    // Restores the keyframe at 400 from the start, then the one at 100 when going back.
+    ASSERT_TRUE(replayManager->SeekPlayback(450));
+    ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+    ASSERT_TRUE(replayManager->SeekPlayback(150));
+    ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+    ASSERT_TRUE(replayManager->IsReplaying());
+
+    while (replayManager->IsReplaying())
+    {
+        gs->UpdateLogic();
+        if (replayManager->IsPlaybackStateMismatching())
+            break;
+    }
+
+    ASSERT_FALSE(replayManager->IsReplaying());
+    ASSERT_FALSE(replayManager->IsPlaybackStateMismatching());
+
+    File::Delete(replayFile);
+}
+
 static void PrintTo(const ReplayTestData& testData, std::ostream* os)
 {
     *os << testData.filePath;
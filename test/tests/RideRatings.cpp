@@ -15,11 +15,13 @@
 #include <openrct2/OpenRCT2.h>
 #include <openrct2/audio/AudioContext.h>
 #include <openrct2/core/File.h>
+#include <openrct2/core/JobPool.h>
 #include <openrct2/core/Path.hpp>
 #include <openrct2/core/String.hpp>
 #include <openrct2/platform/platform.h>
 #include <openrct2/ride/Ride.h>
 #include <openrct2/ride/RideData.h>
+#include <openrct2/ride/RideRatings.h>
 #include <string>
 
 using namespace OpenRCT2;
@@ -44,6 +46,21 @@ protected:
         }
     }
 
+    void CheckRatings(const std::string& expectedDataPath)
+    {
+        auto expectedRatings = File::ReadAllLines(expectedDataPath);
+
+        int expI = 0;
+        for (const auto& ride : GetRideManager())
+        {
+            auto actual = FormatRatings(ride);
+            auto expected = expectedRatings[expI];
+            ASSERT_STREQ(actual.c_str(), expected.c_str());
+
+            expI++;
+        }
+    }
+
     std::string FormatRatings(const Ride& ride)
     {
         RatingTuple ratings = ride.ratings;
@@ -73,18 +90,33 @@ TEST_F(RideRatings, all)
 
     CalculateRatingsForAllRides();
 
-    // Load expected ratings
+    // Check ride ratings
     auto expectedDataPath = Path::Combine(TestData::GetBasePath(), "ratings", "bpb.sv6.txt");
-    auto expectedRatings = File::ReadAllLines(expectedDataPath);
+    CheckRatings(expectedDataPath);
+}
 
-    // Check ride ratings
-    int expI = 0;
-    for (const auto& ride : GetRideManager())
-    {
-        auto actual = FormatRatings(ride);
-        auto expected = expectedRatings[expI];
-        ASSERT_STREQ(actual.c_str(), expected.c_str());
+TEST_F(RideRatings, allParallel)
+{
+    std::string path = TestData::GetParkPath("bpb.sv6");
 
-        expI++;
-    }
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    core_init();
+    auto context = CreateContext();
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    load_from_sv6(path.c_str());
+    ASSERT_EQ(ride_get_count(), 134);
+
+    auto expectedDataPath = Path::Combine(TestData::GetBasePath(), "ratings", "bpb.sv6.txt");
+
+    JobPool jobPool;
+    ride_ratings_update_rides(&jobPool);
+    CheckRatings(expectedDataPath);
+
+    // Rides are rated again from the proximity index the first recalculation filled.
+    ride_ratings_update_rides(&jobPool);
+    CheckRatings(expectedDataPath);
 }
@@ -33,6 +33,7 @@
 #include <openrct2/ride/Ride.h>
 #include <openrct2/scenario/Scenario.h>
 #include <openrct2/world/MapAnimation.h>
+#include <openrct2/world/Park.h>
 #include <openrct2/world/Scenery.h>
 #include <stdio.h>
 #include <string>
@@ -275,6 +276,38 @@ TEST(S6ImportExportAdvanceTicks, all)
     SUCCEED();
 }
 
+TEST(S6ImportExportMetadata, all)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    core_init();
+
+    MemoryStream importBuffer;
+    MemoryStream exportBuffer;
+
+    std::unique_ptr<IContext> context = CreateContext();
+    EXPECT_NE(context, nullptr);
+
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    std::string testParkPath = TestData::GetParkPath("BigMapTest.sv6");
+    ASSERT_TRUE(LoadFileToBuffer(importBuffer, testParkPath));
+    ASSERT_TRUE(ImportS6(importBuffer, context, false));
+    ASSERT_TRUE(ExportSave(exportBuffer, context));
+
+    exportBuffer.SetPosition(0);
+    auto metadata = ReadParkFileMetadata(exportBuffer);
+    ASSERT_EQ(metadata.ParkName, context->GetGameState()->GetPark().Name);
+    ASSERT_EQ(metadata.Cash, gCash);
+    ASSERT_EQ(metadata.CurrentTicks, gCurrentTicks);
+    ASSERT_EQ(metadata.MonthsElapsed, gDateMonthsElapsed);
+    ASSERT_STREQ(metadata.Scenario.name, gScenarioName.c_str());
+
+    SUCCEED();
+}
+
 TEST(SeaDecrypt, DecryptSea)
 {
     auto path = TestData::GetParkPath("volcania.sea");